@@ -80,6 +80,10 @@ public:
     // re-scanned during the next collection.
     void rememberCurrentlyExecutingCodeBlocks(Heap*);
 
+    // Forget the CodeBlocks found on the stack once they have been traced. Incremental
+    // marking scans the stack again in its final pause and only wants what it finds there.
+    void clearCurrentlyExecuting() { m_currentlyExecuting.clear(); }
+
     // Visits each CodeBlock in the heap until the visitor function returns true
     // to indicate that it is done iterating, or until every CodeBlock has been
     // visited.
@@ -32,12 +32,13 @@
 #include "Heap.h"
 #include "JSLock.h"
 #include "JSObject.h"
+#include "Options.h"
 #include "VM.h"
 
 #include <wtf/RetainPtr.h>
 #include <wtf/WTFThreadData.h>
 
-#if PLATFORM(EFL)
+#if PLATFORM(EFL) || PLATFORM(FLTK)
 #include <wtf/MainThread.h>
 #endif
 
@@ -45,7 +46,7 @@ namespace JSC {
 
 bool GCActivityCallback::s_shouldCreateGCTimer = true;
 
-#if USE(CF) || PLATFORM(EFL)
+#if USE(CF) || PLATFORM(EFL) || PLATFORM(FLTK)
 
 const double timerSlop = 2.0; // Fudge factor to avoid performance cost of resetting timer.
 
@@ -59,7 +60,7 @@ GCActivityCallback::GCActivityCallback(Heap* heap, CFRunLoopRef runLoop)
     : GCActivityCallback(heap->vm(), runLoop)
 {
 }
-#elif PLATFORM(EFL)
+#elif PLATFORM(EFL) || PLATFORM(FLTK)
 GCActivityCallback::GCActivityCallback(Heap* heap)
     : GCActivityCallback(heap->vm(), WTF::isMainThread())
 {
@@ -78,6 +79,14 @@ void GCActivityCallback::doWork()
         return;
     }
 
+    // Don't start another collection while one is still being marked; help it along instead.
+    if (heap->isMarkingIncrementally()) {
+        heap->markIncrementally();
+        if (heap->isMarkingIncrementally())
+            scheduleMarkingSlice();
+        return;
+    }
+
     doCollection();
 }
 
@@ -109,6 +118,21 @@ void GCActivityCallback::scheduleTimer(double newDelay)
     m_timer = add(newDelay, this);
 }
 
+void GCActivityCallback::cancelTimer()
+{
+    m_delay = s_hour;
+    stop();
+}
+#elif PLATFORM(FLTK)
+void GCActivityCallback::scheduleTimer(double newDelay)
+{
+    if (newDelay * timerSlop > m_delay)
+        return;
+
+    m_delay = newDelay;
+    add(newDelay);
+}
+
 void GCActivityCallback::cancelTimer()
 {
     m_delay = s_hour;
@@ -118,7 +142,7 @@ void GCActivityCallback::cancelTimer()
 
 void GCActivityCallback::didAllocate(size_t bytes)
 {
-#if PLATFORM(EFL)
+#if PLATFORM(EFL) || PLATFORM(FLTK)
     if (!isEnabled())
         return;
 
@@ -144,6 +168,18 @@ void GCActivityCallback::cancel()
     cancelTimer();
 }
 
+void GCActivityCallback::scheduleMarkingSlice()
+{
+#if PLATFORM(EFL) || PLATFORM(FLTK)
+    if (!isEnabled())
+        return;
+#endif
+
+    // Leave the mutator as much time as a slice takes.
+    cancelTimer();
+    scheduleTimer(Options::incrementalMarkingSliceMilliseconds() / 1000);
+}
+
 #else
 
 GCActivityCallback::GCActivityCallback(Heap* heap)
@@ -167,6 +203,10 @@ void GCActivityCallback::cancel()
 {
 }
 
+void GCActivityCallback::scheduleMarkingSlice()
+{
+}
+
 #endif
 
 }
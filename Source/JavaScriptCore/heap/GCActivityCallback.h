@@ -55,6 +55,7 @@ public:
     virtual void didAllocate(size_t);
     virtual void willCollect();
     virtual void cancel();
+    void scheduleMarkingSlice();
     bool isEnabled() const { return m_enabled; }
     void setEnabled(bool enabled) { m_enabled = enabled; }
 
@@ -72,7 +73,7 @@ protected:
         , m_delay(s_decade)
     {
     }
-#elif PLATFORM(EFL)
+#elif PLATFORM(EFL) || PLATFORM(FLTK)
     static constexpr double s_hour = 3600;
     GCActivityCallback(VM* vm, bool flag)
         : HeapTimer(vm)
@@ -94,7 +95,7 @@ protected:
 protected:
     GCActivityCallback(Heap*, CFRunLoopRef);
 #endif
-#if USE(CF) || PLATFORM(EFL)
+#if USE(CF) || PLATFORM(EFL) || PLATFORM(FLTK)
 protected:
     void cancelTimer();
     void scheduleTimer(double);
@@ -94,18 +94,18 @@ void GCThread::gcThreadMain()
     }
     {
         ParallelModeEnabler enabler(*m_slotVisitor);
-        while ((currentPhase = waitForNextPhase()) != Exit) {
+        while ((currentPhase = waitForNextPhase()) != ExitPhase) {
             // Note: Each phase is responsible for its own termination conditions. The comments below describe 
             // how each phase reaches termination.
             switch (currentPhase) {
-            case Mark:
+            case MarkPhase:
                 m_slotVisitor->drainFromShared(SlotVisitor::SlaveDrain);
                 // GCThreads only return from drainFromShared() if the main thread sets the m_parallelMarkersShouldExit 
                 // flag in the GCThreadSharedData. The only way the main thread sets that flag is if it realizes 
                 // that all of the various subphases in Heap::markRoots() have been fully finished and there is 
                 // no more marking work to do and all of the GCThreads are idle, meaning no more work can be generated.
                 break;
-            case Copy:
+            case CopyPhase:
                 // We don't have to call startCopying() because it's called for us on the main thread to avoid a 
                 // race condition.
                 m_copyVisitor->copyFromShared();
@@ -118,11 +118,20 @@ void GCThread::gcThreadMain()
 
                 WTF::releaseFastMallocFreeMemoryForThisThread();
 
+                break;
+            case SweepPhase:
+                // Blocks the mutator took back for itself are skipped by getNextBlockToSweep(). We're
+                // done when the queue runs dry, either because we swept everything or because the
+                // main thread cancelled the rest of it in didFinishSweeping().
+                while (MarkedBlock* block = m_shared.getNextBlockToSweep()) {
+                    block->sweepInBackground();
+                    m_shared.didSweepBlock(block);
+                }
                 break;
             case NoPhase:
                 RELEASE_ASSERT_NOT_REACHED();
                 break;
-            case Exit:
+            case ExitPhase:
                 RELEASE_ASSERT_NOT_REACHED();
                 break;
             }
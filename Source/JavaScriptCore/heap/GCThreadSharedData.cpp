@@ -77,6 +77,7 @@ GCThreadSharedData::GCThreadSharedData(VM* vm)
     , m_numberOfActiveParallelMarkers(0)
     , m_parallelMarkersShouldExit(false)
     , m_copyIndex(0)
+    , m_sweepIndex(0)
     , m_numberOfActiveGCThreads(0)
     , m_gcThreadsShouldWait(false)
     , m_currentPhase(NoPhase)
@@ -107,7 +108,7 @@ GCThreadSharedData::~GCThreadSharedData()
         ASSERT(m_currentPhase == NoPhase);
         m_parallelMarkersShouldExit = true;
         m_gcThreadsShouldWait = false;
-        m_currentPhase = Exit;
+        m_currentPhase = ExitPhase;
         m_phaseConditionVariable.notify_all();
     }
     for (unsigned i = 0; i < m_gcThreads.size(); ++i) {
@@ -151,7 +152,8 @@ void GCThreadSharedData::endCurrentPhase()
 
 void GCThreadSharedData::didStartMarking()
 {
-    if (m_vm->heap.operationInProgress() == FullCollection) {
+    // Incremental marking slices have already filled the set by the time the final pause starts.
+    if (m_vm->heap.operationInProgress() == FullCollection && !m_vm->heap.isMarkingIncrementally()) {
 #if ENABLE(PARALLEL_GC)
         m_opaqueRoots.clear();
 #else
@@ -160,7 +162,7 @@ void GCThreadSharedData::didStartMarking()
 }
     std::lock_guard<std::mutex> lock(m_markingMutex);
     m_parallelMarkersShouldExit = false;
-    startNextPhase(Mark);
+    startNextPhase(MarkPhase);
 }
 
 void GCThreadSharedData::didFinishMarking()
@@ -171,7 +173,7 @@ void GCThreadSharedData::didFinishMarking()
         m_markingConditionVariable.notify_all();
     }
 
-    ASSERT(m_currentPhase == Mark);
+    ASSERT(m_currentPhase == MarkPhase);
     endCurrentPhase();
 }
 
@@ -198,13 +200,87 @@ void GCThreadSharedData::didStartCopying()
     for (size_t i = 0; i < m_gcThreads.size(); i++)
         m_gcThreads[i]->copyVisitor()->startCopying();
 
-    startNextPhase(Copy);
+    startNextPhase(CopyPhase);
 }
 
 void GCThreadSharedData::didFinishCopying()
 {
-    ASSERT(m_currentPhase == Copy);
+    ASSERT(m_currentPhase == CopyPhase);
     endCurrentPhase();
 }
 
+void GCThreadSharedData::didStartSweeping(const Vector<MarkedBlock*>& blocks)
+{
+    ASSERT(m_currentPhase == NoPhase);
+    if (m_gcThreads.isEmpty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_sweepMutex);
+        m_blocksToSweep.shrink(0);
+        for (MarkedBlock* block : blocks) {
+            if (!block->canSweepInBackground())
+                continue;
+            // Leave sparse blocks to the IncrementalSweeper so that it can give their dead pages back.
+            if (Options::reclaimSparseMarkedBlocks() && block->isSparse())
+                continue;
+            block->willSweepInBackground(m_blocksToSweep.size());
+            m_blocksToSweep.append(block);
+        }
+        m_sweepIndex = 0;
+    }
+
+    if (m_blocksToSweep.isEmpty())
+        return;
+
+    startNextPhase(SweepPhase);
+}
+
+void GCThreadSharedData::didFinishSweeping()
+{
+    if (m_currentPhase != SweepPhase)
+        return;
+
+    {
+        // Hand the blocks no GC thread has picked up yet back to the mutator.
+        std::lock_guard<std::mutex> lock(m_sweepMutex);
+        for (size_t i = m_sweepIndex; i < m_blocksToSweep.size(); ++i) {
+            if (MarkedBlock* block = m_blocksToSweep[i])
+                block->didCancelSweepInBackground();
+        }
+        m_sweepIndex = m_blocksToSweep.size();
+    }
+
+    endCurrentPhase();
+
+    // Blocks may be freed once we return, so don't hold on to them.
+    m_blocksToSweep.shrink(0);
+}
+
+bool GCThreadSharedData::finishSweepingBlock(MarkedBlock* block)
+{
+    std::unique_lock<std::mutex> lock(m_sweepMutex);
+    switch (block->m_backgroundSweepState.load(std::memory_order_relaxed)) {
+    case MarkedBlock::NotQueued:
+        return false;
+    case MarkedBlock::Queued:
+        // Take the block back before a GC thread gets to it. Clearing its queue entry means
+        // no GC thread will touch it again, so it can be freed as soon as we return.
+        ASSERT(m_blocksToSweep[block->m_backgroundSweepQueueIndex] == block);
+        m_blocksToSweep[block->m_backgroundSweepQueueIndex] = 0;
+        block->didCancelSweepInBackground();
+        return false;
+    case MarkedBlock::BeingSwept:
+        m_sweepConditionVariable.wait(lock, [block] {
+            return block->m_backgroundSweepState.load(std::memory_order_relaxed) != MarkedBlock::BeingSwept;
+        });
+        return true;
+    case MarkedBlock::Swept:
+        return true;
+    }
+
+    RELEASE_ASSERT_NOT_REACHED();
+    return false;
+}
+
 } // namespace JSC
@@ -46,9 +46,10 @@ class VM;
 
 enum GCPhase {
     NoPhase,
-    Mark,
-    Copy,
-    Exit
+    MarkPhase,
+    CopyPhase,
+    SweepPhase,
+    ExitPhase
 };
 
 class GCThreadSharedData {
@@ -64,6 +65,14 @@ public:
     void didStartCopying();
     void didFinishCopying();
 
+    // Unlike the other phases, sweeping keeps going after the collection returns to the
+    // mutator. It has to be finished before the next collection. A block the mutator wants
+    // to allocate from or free before then is taken out of the queue on its own with
+    // finishSweepingBlock(), which returns true if a GC thread built its free list.
+    void didStartSweeping(const Vector<MarkedBlock*>&);
+    void didFinishSweeping();
+    bool finishSweepingBlock(MarkedBlock*);
+
 #if ENABLE(PARALLEL_GC)
     void resetChildren();
     size_t childVisitCount();
@@ -78,6 +87,8 @@ private:
     friend class CopyVisitor;
 
     void getNextBlocksToCopy(size_t&, size_t&);
+    MarkedBlock* getNextBlockToSweep();
+    void didSweepBlock(MarkedBlock*);
     void startNextPhase(GCPhase);
     void endCurrentPhase();
 
@@ -102,6 +113,12 @@ private:
     size_t m_copyIndex;
     static const size_t s_blockFragmentLength = 32;
 
+    // Guards the queue and every change of a queued block's background sweep state.
+    std::mutex m_sweepMutex;
+    std::condition_variable m_sweepConditionVariable;
+    Vector<MarkedBlock*> m_blocksToSweep;
+    size_t m_sweepIndex;
+
     std::mutex m_phaseMutex;
     std::condition_variable m_phaseConditionVariable;
     std::condition_variable m_activityConditionVariable;
@@ -121,6 +138,28 @@ inline void GCThreadSharedData::getNextBlocksToCopy(size_t& start, size_t& end)
     m_copyIndex = end;
 }
 
+inline MarkedBlock* GCThreadSharedData::getNextBlockToSweep()
+{
+    std::lock_guard<std::mutex> lock(m_sweepMutex);
+    while (m_sweepIndex < m_blocksToSweep.size()) {
+        // Blocks the mutator took back have been cleared from the queue.
+        MarkedBlock* block = m_blocksToSweep[m_sweepIndex++];
+        if (!block)
+            continue;
+        ASSERT(block->m_backgroundSweepState.load(std::memory_order_relaxed) == MarkedBlock::Queued);
+        block->m_backgroundSweepState.store(MarkedBlock::BeingSwept, std::memory_order_relaxed);
+        return block;
+    }
+    return 0;
+}
+
+inline void GCThreadSharedData::didSweepBlock(MarkedBlock* block)
+{
+    std::lock_guard<std::mutex> lock(m_sweepMutex);
+    block->m_backgroundSweepState.store(MarkedBlock::Swept, std::memory_order_relaxed);
+    m_sweepConditionVariable.notify_all();
+}
+
 } // namespace JSC
 
 #endif
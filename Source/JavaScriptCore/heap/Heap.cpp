@@ -33,6 +33,7 @@
 #include "GCIncomingRefCountedSetInlines.h"
 #include "HeapIterationScope.h"
 #include "HeapRootVisitor.h"
+#include "HeapSnapshotBuilder.h"
 #include "HeapStatistics.h"
 #include "HeapVerifier.h"
 #include "IncrementalSweeper.h"
@@ -385,6 +386,7 @@ void Heap::lastChanceToFinalize()
     RELEASE_ASSERT(!m_vm->entryScope);
     RELEASE_ASSERT(m_operationInProgress == NoOperation);
 
+    finishSweepingInBackground();
     m_objectSpace.lastChanceToFinalize();
     releaseDelayedReleasedObjects();
 
@@ -549,7 +551,10 @@ void Heap::markRoots(double gcStartTime, void* stackOrigin, void* stackTop, Mach
     gatherJSStackRoots(conservativeRoots);
     gatherScratchBufferRoots(conservativeRoots);
 
-    clearLivenessData();
+    if (m_isMarkingIncrementally)
+        finishIncrementalMarking();
+    else
+        clearLivenessData();
 
     m_sharedData.didStartMarking();
     m_slotVisitor.didStartMarking();
@@ -908,6 +913,11 @@ void Heap::deleteAllCompiledCode()
     // up deleting code that is live on the stack.
     if (m_vm->entryScope)
         return;
+
+    // Marking slices may have registered CodeBlocks as weak reference harvesters
+    // and unconditional finalizers that the final pause still has to run.
+    if (m_isMarkingIncrementally)
+        return;
     
     // If we have things on any worklist, then don't delete code. This is kind of
     // a weird heuristic. It's definitely not safe to throw away code that is on
@@ -931,6 +941,8 @@ void Heap::deleteAllCompiledCode()
         static_cast<FunctionExecutable*>(current)->clearCodeIfNotCompiling();
     }
 
+    m_vm->clearSourceProviderCaches();
+
     ASSERT(m_operationInProgress == FullCollection || m_operationInProgress == NoOperation);
     m_codeBlocks.clearMarksForFullCollection();
     m_codeBlocks.deleteUnmarkedAndUnreferenced(FullCollection);
@@ -977,6 +989,12 @@ void Heap::addToRememberedSet(const JSCell* cell)
         return;
     MarkedBlock::blockFor(cell)->setRemembered(cell);
     const_cast<JSCell*>(cell)->setRemembered(true);
+    if (m_isMarkingIncrementally) {
+        // The mark stack belongs to the marker until the cycle ends. The next slice decides
+        // whether the cell needs to be traced again.
+        m_incrementalRememberedSet.append(cell);
+        return;
+    }
     m_slotVisitor.unconditionallyAppend(const_cast<JSCell*>(cell));
 }
 
@@ -996,6 +1014,18 @@ void Heap::collectAndSweep(HeapOperation collectionType)
     sweepAllLogicallyEmptyWeakBlocks();
 }
 
+void Heap::takeHeapSnapshot(PrintStream& out)
+{
+    // Slices of an incremental cycle have already traced part of the heap without us.
+    if (m_isMarkingIncrementally)
+        collect(FullCollection);
+
+    HeapSnapshotBuilder builder(out);
+    m_heapSnapshotBuilder = &builder;
+    collectAllGarbage();
+    m_heapSnapshotBuilder = nullptr;
+}
+
 static double minute = 60.0;
 
 NEVER_INLINE void Heap::collect(HeapOperation collectionType)
@@ -1034,8 +1064,13 @@ NEVER_INLINE void Heap::collectImpl(HeapOperation collectionType, void* stackOri
     JAVASCRIPTCORE_GC_BEGIN();
     RELEASE_ASSERT(m_operationInProgress == NoOperation);
 
+    finishSweepingInBackground();
     suspendCompilerThreads();
-    willStartCollection(collectionType);
+    bool isFinishingIncrementalMarking = m_isMarkingIncrementally;
+    if (isFinishingIncrementalMarking)
+        willFinishIncrementalMarking();
+    else
+        willStartCollection(collectionType);
     GCPHASE(Collect);
 
     double gcStartTime = WTF::monotonicallyIncreasingTime();
@@ -1048,12 +1083,32 @@ NEVER_INLINE void Heap::collectImpl(HeapOperation collectionType, void* stackOri
         m_verifier->gatherLiveObjects(HeapVerifier::Phase::BeforeMarking);
     }
 
-    deleteOldCode(gcStartTime);
-    flushOldStructureIDTables();
-    stopAllocation();
+    if (isFinishingIncrementalMarking) {
+        // Copied space was reset for this cycle when marking started.
+        m_objectSpace.stopAllocating();
+    } else {
+        deleteOldCode(gcStartTime);
+        flushOldStructureIDTables();
+        stopAllocation();
+    }
     flushWriteBarrierBuffer();
 
+    if (shouldMarkIncrementally(collectionType)) {
+        startIncrementalMarking(stackOrigin, stackTop, calleeSavedRegisters);
+        resumeCompilerThreads();
+
+        double gcEndTime = WTF::monotonicallyIncreasingTime();
+        if (Options::recordGCPauseTimes())
+            HeapStatistics::recordGCPauseTime(gcStartTime, gcEndTime);
+        JAVASCRIPTCORE_GC_END();
+
+        if (Options::logGC())
+            dataLog("started incremental marking, ", currentTimeMS() - before, " ms]\n");
+        return;
+    }
+
     markRoots(gcStartTime, stackOrigin, stackTop, calleeSavedRegisters);
+    m_isMarkingIncrementally = false;
 
     if (m_verifier) {
         m_verifier->gatherLiveObjects(HeapVerifier::Phase::AfterMarking);
@@ -1075,6 +1130,7 @@ NEVER_INLINE void Heap::collectImpl(HeapOperation collectionType, void* stackOri
     removeDeadCompilerWorklistEntries();
     deleteUnmarkedCompiledCode();
     deleteSourceProviderCaches();
+    sweepInBackground();
     notifyIncrementalSweeper();
     rememberCurrentlyExecutingCodeBlocks();
 
@@ -1138,6 +1194,181 @@ void Heap::willStartCollection(HeapOperation collectionType)
         m_edenActivityCallback->willCollect();
 }
 
+void Heap::willFinishIncrementalMarking()
+{
+    GCPHASE(FinishingIncrementalMarking);
+    // Everything else willStartCollection() does was done when marking started.
+    m_operationInProgress = FullCollection;
+    if (Options::logGC())
+        dataLog("FullCollection (incremental), ");
+
+    if (m_fullActivityCallback)
+        m_fullActivityCallback->willCollect();
+    if (m_edenActivityCallback)
+        m_edenActivityCallback->willCollect();
+}
+
+bool Heap::shouldMarkIncrementally(HeapOperation requestedCollectionType) const
+{
+#if ENABLE(GGC)
+    // Collections that were asked for by name are expected to have freed everything they can
+    // by the time they return, so only the ones started by allocation are spread out. Marking
+    // relies on the generational write barrier to learn about mutations between slices.
+    return Options::useIncrementalMarking()
+        && requestedCollectionType == AnyCollection
+        && m_operationInProgress == FullCollection
+        && !m_isMarkingIncrementally
+        && !m_verifier;
+#else
+    UNUSED_PARAM(requestedCollectionType);
+    return false;
+#endif
+}
+
+void Heap::startIncrementalMarking(void* stackOrigin, void* stackTop, MachineThreads::RegisterState& calleeSavedRegisters)
+{
+    SamplingRegion samplingRegion("Garbage Collection: Start Incremental Marking");
+
+    GCPHASE(StartIncrementalMarking);
+    ASSERT(isValidThreadState(m_vm));
+    ASSERT(m_operationInProgress == FullCollection);
+
+    m_codeBlocks.clearMarksForFullCollection();
+
+    ConservativeRoots conservativeRoots(&m_objectSpace.blocks(), &m_storageSpace);
+    gatherStackRoots(conservativeRoots, stackOrigin, stackTop, calleeSavedRegisters);
+    gatherJSStackRoots(conservativeRoots);
+    gatherScratchBufferRoots(conservativeRoots);
+
+    m_objectSpace.willStartIncrementalMarking();
+
+    m_sharedData.didStartMarking();
+    m_slotVisitor.didStartMarking();
+    m_isMarkingIncrementally = true;
+    ++m_incrementalMarkingCycleCount;
+    m_bytesAllocatedBeforeMarking = m_bytesAllocatedThisCycle;
+    m_bytesAllocatedAtLastMarkingSlice = m_bytesAllocatedThisCycle;
+
+    // Only seed the mark stack here. The final pause scans every root again, so roots that
+    // change in the meantime don't need a write barrier.
+    HeapRootVisitor heapRootVisitor(m_slotVisitor);
+    if (m_vm->smallStrings.needsToBeVisited(m_operationInProgress))
+        m_vm->smallStrings.visitStrongReferences(m_slotVisitor);
+    m_slotVisitor.append(conservativeRoots);
+    for (auto& pair : m_protectedValues)
+        heapRootVisitor.visit(&pair.key);
+    m_handleSet.visitStrongHandles(heapRootVisitor);
+    m_handleStack.visit(heapRootVisitor);
+    m_codeBlocks.traceMarked(m_slotVisitor);
+    m_jitStubRoutines.traceMarkedStubRoutines(m_slotVisitor);
+    m_codeBlocks.clearCurrentlyExecuting();
+
+    m_sharedData.didFinishMarking();
+    m_operationInProgress = NoOperation;
+
+    // Keep marking while the mutator is idle, too.
+    if (m_edenActivityCallback)
+        m_edenActivityCallback->scheduleMarkingSlice();
+}
+
+bool Heap::continueIncrementalMarking()
+{
+    ASSERT(m_isMarkingIncrementally);
+    if (!m_isSafeToCollect || m_operationInProgress != NoOperation)
+        return false;
+
+    // A mutator that allocates faster than the slices trace would otherwise grow the heap
+    // without bound. Give up on spreading the work out and finish in one pause.
+    if (m_bytesAllocatedThisCycle - m_bytesAllocatedBeforeMarking > std::max(m_maxEdenSize, m_minBytesPerCycle)) {
+        collect();
+        return true;
+    }
+
+    if (m_bytesAllocatedThisCycle - m_bytesAllocatedAtLastMarkingSlice < Options::incrementalMarkingSliceBytes())
+        return false;
+
+    if (!markingSlice())
+        return false;
+
+    collect();
+    return true;
+}
+
+void Heap::markIncrementally()
+{
+    if (!m_isMarkingIncrementally || !m_isSafeToCollect || isBusy() || isDeferred())
+        return;
+
+    if (markingSlice())
+        collect();
+}
+
+void Heap::startIncrementalMarkingForTesting()
+{
+    if (m_isMarkingIncrementally)
+        return;
+
+    m_shouldDoFullCollection = true;
+    collect(AnyCollection);
+}
+
+bool Heap::markingSlice()
+{
+    ASSERT(m_isMarkingIncrementally);
+    ASSERT(m_operationInProgress == NoOperation);
+    ASSERT(vm()->currentThreadIsHoldingAPILock());
+
+    double sliceStartTime = WTF::monotonicallyIncreasingTime();
+    m_operationInProgress = FullCollection;
+
+    m_writeBarrierBuffer.flush(*this);
+    // Inline caches are repatched behind a barrier on the owning executable. Let its
+    // CodeBlocks be visited again so that the structures they now use get marked.
+    m_codeBlocks.clearMarksForEdenCollection(m_incrementalRememberedSet);
+    visitIncrementalRememberedSet();
+    bool isDone = m_slotVisitor.drainUntil(sliceStartTime + Options::incrementalMarkingSliceMilliseconds() / 1000);
+
+    m_operationInProgress = NoOperation;
+    m_bytesAllocatedAtLastMarkingSlice = m_bytesAllocatedThisCycle;
+    ++m_markingSliceCount;
+
+    double sliceEndTime = WTF::monotonicallyIncreasingTime();
+    if (Options::recordGCPauseTimes())
+        HeapStatistics::recordGCPauseTime(sliceStartTime, sliceEndTime);
+    if (Options::logGC())
+        dataLog("[GC: marking slice, ", (sliceEndTime - sliceStartTime) * 1000, " ms]\n");
+
+    return isDone;
+}
+
+void Heap::visitIncrementalRememberedSet()
+{
+    for (const JSCell* cell : m_incrementalRememberedSet) {
+        MarkedBlock::blockFor(cell)->clearRemembered(cell);
+        const_cast<JSCell*>(cell)->setRemembered(false);
+
+        // A cell that hasn't been reached yet will be traced in full when it is.
+        if (isMarked(cell))
+            m_slotVisitor.unconditionallyAppend(const_cast<JSCell*>(cell));
+    }
+    m_incrementalRememberedSet.shrink(0);
+}
+
+void Heap::finishIncrementalMarking()
+{
+    GCPHASE(FinishIncrementalMarking);
+    visitIncrementalRememberedSet();
+    m_incrementalRememberedSet.clear();
+
+    // Wrappers report their opaque roots while being visited, but those roots can change,
+    // for example when a DOM node is moved, without a write barrier on the wrapper.
+    for (const JSCell* cell : m_slotVisitor.takeOpaqueRootOwners())
+        m_slotVisitor.unconditionallyAppend(const_cast<JSCell*>(cell));
+
+    // Objects allocated while marking are live only if this cycle reaches them.
+    m_objectSpace.didFinishIncrementalMarking();
+}
+
 void Heap::deleteOldCode(double gcStartTime)
 {
     if (m_operationInProgress == EdenCollection)
@@ -1159,7 +1390,7 @@ void Heap::flushOldStructureIDTables()
 void Heap::flushWriteBarrierBuffer()
 {
     GCPHASE(FlushWriteBarrierBuffer);
-    if (m_operationInProgress == EdenCollection) {
+    if (m_operationInProgress == EdenCollection || m_isMarkingIncrementally) {
         m_writeBarrierBuffer.flush(*this);
         return;
     }
@@ -1224,7 +1455,28 @@ void Heap::snapshotMarkedSpace()
 void Heap::deleteSourceProviderCaches()
 {
     GCPHASE(DeleteSourceProviderCaches);
-    m_vm->clearSourceProviderCaches();
+    if (m_operationInProgress == EdenCollection)
+        return;
+    m_vm->pruneSourceProviderCaches();
+}
+
+void Heap::sweepInBackground()
+{
+    GCPHASE(SweepInBackground);
+    // Both of these debugging modes scribble over dead cells after we would have started.
+    if (!Options::useBackgroundSweeping() || Options::useZombieMode() || Options::objectsAreImmortal())
+        return;
+    m_sharedData.didStartSweeping(m_blockSnapshot);
+}
+
+void Heap::finishSweepingInBackground()
+{
+    m_sharedData.didFinishSweeping();
+}
+
+bool Heap::finishSweepingBlockInBackground(MarkedBlock* block)
+{
+    return m_sharedData.finishSweepingBlock(block);
 }
 
 void Heap::notifyIncrementalSweeper()
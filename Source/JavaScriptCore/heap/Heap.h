@@ -56,6 +56,7 @@ class GCAwareJITStubRoutine;
 class GlobalCodeBlock;
 class Heap;
 class HeapRootVisitor;
+class HeapSnapshotBuilder;
 class HeapVerifier;
 class IncrementalSweeper;
 class JITStubRoutine;
@@ -160,6 +161,21 @@ public:
     JS_EXPORT_PRIVATE void collect(HeapOperation collectionType = AnyCollection);
     bool collectIfNecessaryOrDefer(); // Returns true if it did collect.
 
+    // With Options::useIncrementalMarking(), full collections triggered by allocation only
+    // seed the mark stack in their first pause. The rest of the tracing happens in slices
+    // interleaved with the mutator, and a final pause finishes the cycle.
+    bool isMarkingIncrementally() const { return m_isMarkingIncrementally; }
+    JS_EXPORT_PRIVATE void markIncrementally(); // Runs a slice, and finishes the cycle if there is nothing left to trace.
+    // Starts a full collection as if allocation had triggered it, so that it marks incrementally
+    // when that is enabled. Does nothing if a cycle is already in progress. For testing.
+    JS_EXPORT_PRIVATE void startIncrementalMarkingForTesting();
+    unsigned incrementalMarkingCycleCount() const { return m_incrementalMarkingCycleCount; }
+    unsigned markingSliceCount() const { return m_markingSliceCount; }
+
+    // Runs a full collection that writes every live cell and every reference it traces to the
+    // stream. See HeapSnapshotBuilder.h for the format.
+    JS_EXPORT_PRIVATE void takeHeapSnapshot(PrintStream&);
+
     // Use this API to report non-GC memory referenced by GC objects. Be sure to
     // call both of these functions: Calling only one may trigger catastropic
     // memory growth.
@@ -285,6 +301,14 @@ private:
     void flushWriteBarrierBuffer();
     void stopAllocation();
 
+    bool shouldMarkIncrementally(HeapOperation requestedCollectionType) const;
+    void startIncrementalMarking(void* stackOrigin, void* stackTop, MachineThreads::RegisterState&);
+    void willFinishIncrementalMarking();
+    bool continueIncrementalMarking();
+    bool markingSlice();
+    void visitIncrementalRememberedSet();
+    void finishIncrementalMarking();
+
     void markRoots(double gcStartTime, void* stackOrigin, void* stackTop, MachineThreads::RegisterState&);
     void gatherStackRoots(ConservativeRoots&, void* stackOrigin, void* stackTop, MachineThreads::RegisterState&);
     void gatherJSStackRoots(ConservativeRoots&);
@@ -312,6 +336,9 @@ private:
     void sweepArrayBuffers();
     void snapshotMarkedSpace();
     void deleteSourceProviderCaches();
+    void sweepInBackground();
+    void finishSweepingInBackground();
+    bool finishSweepingBlockInBackground(MarkedBlock*);
     void notifyIncrementalSweeper();
     void rememberCurrentlyExecutingCodeBlocks();
     void resetAllocators();
@@ -384,6 +411,15 @@ private:
 
     WriteBarrierBuffer m_writeBarrierBuffer;
 
+    bool m_isMarkingIncrementally { false };
+    size_t m_bytesAllocatedBeforeMarking { 0 };
+    size_t m_bytesAllocatedAtLastMarkingSlice { 0 };
+    Vector<const JSCell*> m_incrementalRememberedSet;
+    unsigned m_incrementalMarkingCycleCount { 0 };
+    unsigned m_markingSliceCount { 0 };
+
+    HeapSnapshotBuilder* m_heapSnapshotBuilder { nullptr };
+
     VM* m_vm;
     double m_lastFullGCLength;
     double m_lastEdenGCLength;
@@ -38,6 +38,8 @@ inline bool Heap::shouldCollect()
 {
     if (isDeferred())
         return false;
+    if (m_isMarkingIncrementally)
+        return false;
     if (Options::gcMaxHeapSize())
         return m_bytesAllocatedThisCycle > Options::gcMaxHeapSize() && m_isSafeToCollect && m_operationInProgress == NoOperation;
     return m_bytesAllocatedThisCycle > m_maxEdenSize && m_isSafeToCollect && m_operationInProgress == NoOperation;
@@ -128,7 +130,9 @@ inline void Heap::writeBarrier(const JSCell* from, JSCell* to)
         ASSERT(!from || !isMarked(from));
         return;
     }
-    if (!to || to->isMarked()) {
+    // While marking incrementally, a cell that was marked by the previous cycle may not have
+    // been traced by this one yet, so the old mark says nothing about it.
+    if (!to || (to->isMarked() && !m_isMarkingIncrementally)) {
         ASSERT(!to || isMarked(to));
         return;
     }
@@ -147,7 +151,7 @@ inline void Heap::writeBarrier(const JSCell* from)
         ASSERT(!from || !isMarked(from));
         return;
     }
-    ASSERT(isMarked(from));
+    ASSERT(isMarked(from) || m_isMarkingIncrementally);
     addToRememberedSet(from);
 #else
     UNUSED_PARAM(from);
@@ -320,6 +324,9 @@ inline bool Heap::collectIfNecessaryOrDefer()
     if (isDeferred())
         return false;
 
+    if (m_isMarkingIncrementally)
+        return continueIncrementalMarking();
+
     if (!shouldCollect())
         return false;
 
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshotAnalyzer.h"
+
+#include <algorithm>
+#include <inttypes.h>
+
+namespace JSC {
+
+HeapSnapshotAnalyzer::HeapSnapshotAnalyzer()
+{
+    Node roots = { 0, 0, 0, classNameIndexFor("<roots>"), notReached, notReached };
+    m_nodes.append(roots);
+    m_unknownClassName = classNameIndexFor("<unknown>");
+}
+
+unsigned HeapSnapshotAnalyzer::nodeIndexFor(uintptr_t cell)
+{
+    if (!cell)
+        return 0;
+
+    auto result = m_nodeIndices.add(cell, m_nodes.size());
+    if (result.isNewEntry) {
+        Node node = { cell, 0, 0, m_unknownClassName, notReached, notReached };
+        m_nodes.append(node);
+    }
+    return result.iterator->value;
+}
+
+unsigned HeapSnapshotAnalyzer::classNameIndexFor(const char* name)
+{
+    CString className(name);
+    auto result = m_classNameIndices.add(className, m_classNames.size());
+    if (result.isNewEntry)
+        m_classNames.append(className);
+    return result.iterator->value;
+}
+
+bool HeapSnapshotAnalyzer::load(FILE* file)
+{
+    unsigned version;
+    if (fscanf(file, "JSCHeapSnapshot %u", &version) != 1 || version != 1)
+        return false;
+
+    Vector<std::pair<unsigned, unsigned>> edges;
+    char kind;
+    while (fscanf(file, " %c", &kind) == 1) {
+        switch (kind) {
+        case 'e': {
+            uintptr_t from;
+            uintptr_t to;
+            if (fscanf(file, "%" SCNxPTR " %" SCNxPTR, &from, &to) != 2)
+                return false;
+            unsigned fromIndex = nodeIndexFor(from);
+            edges.append(std::make_pair(fromIndex, nodeIndexFor(to)));
+            break;
+        }
+        case 'n': {
+            uintptr_t cell;
+            size_t cellBytes;
+            size_t extraBytes;
+            char className[256];
+            if (fscanf(file, "%" SCNxPTR " %zu %zu %255[^\n]", &cell, &cellBytes, &extraBytes, className) != 4)
+                return false;
+            // A cell that was visited twice is reported twice. Keep the last report.
+            Node& node = m_nodes[nodeIndexFor(cell)];
+            node.selfSize = cellBytes + extraBytes;
+            node.className = classNameIndexFor(className);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    buildAdjacency(edges);
+    return true;
+}
+
+void HeapSnapshotAnalyzer::buildAdjacency(const Vector<std::pair<unsigned, unsigned>>& edges)
+{
+    m_successorOffsets.fill(0, m_nodes.size() + 1);
+    m_predecessorOffsets.fill(0, m_nodes.size() + 1);
+    for (auto& edge : edges) {
+        m_successorOffsets[edge.first + 1]++;
+        m_predecessorOffsets[edge.second + 1]++;
+    }
+    for (size_t i = 1; i <= m_nodes.size(); ++i) {
+        m_successorOffsets[i] += m_successorOffsets[i - 1];
+        m_predecessorOffsets[i] += m_predecessorOffsets[i - 1];
+    }
+
+    m_successors.resize(edges.size());
+    m_predecessors.resize(edges.size());
+    Vector<unsigned> nextSuccessor(m_successorOffsets);
+    Vector<unsigned> nextPredecessor(m_predecessorOffsets);
+    for (auto& edge : edges) {
+        m_successors[nextSuccessor[edge.first]++] = edge.second;
+        m_predecessors[nextPredecessor[edge.second]++] = edge.first;
+    }
+}
+
+void HeapSnapshotAnalyzer::computePostorder(Vector<unsigned>& postorder)
+{
+    // Iterative depth-first search from the roots. Each stack entry is a node and the position
+    // of the next successor to look at.
+    Vector<std::pair<unsigned, unsigned>> stack;
+    Vector<bool> visited;
+    visited.fill(false, m_nodes.size());
+
+    visited[0] = true;
+    stack.append(std::make_pair(0u, m_successorOffsets[0]));
+    while (!stack.isEmpty()) {
+        unsigned node = stack.last().first;
+        unsigned& next = stack.last().second;
+        if (next < m_successorOffsets[node + 1]) {
+            unsigned successor = m_successors[next++];
+            if (!visited[successor]) {
+                visited[successor] = true;
+                stack.append(std::make_pair(successor, m_successorOffsets[successor]));
+            }
+            continue;
+        }
+        m_nodes[node].postorderIndex = postorder.size();
+        postorder.append(node);
+        stack.removeLast();
+    }
+}
+
+unsigned HeapSnapshotAnalyzer::intersect(unsigned a, unsigned b) const
+{
+    while (a != b) {
+        while (m_nodes[a].postorderIndex < m_nodes[b].postorderIndex)
+            a = m_nodes[a].dominator;
+        while (m_nodes[b].postorderIndex < m_nodes[a].postorderIndex)
+            b = m_nodes[b].dominator;
+    }
+    return a;
+}
+
+void HeapSnapshotAnalyzer::computeRetainedSizes()
+{
+    Vector<unsigned> postorder;
+    computePostorder(postorder);
+
+    // Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm".
+    m_nodes[0].dominator = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = postorder.size() - 1; i--;) {
+            unsigned node = postorder[i];
+            unsigned newDominator = notReached;
+            for (unsigned j = m_predecessorOffsets[node]; j < m_predecessorOffsets[node + 1]; ++j) {
+                unsigned predecessor = m_predecessors[j];
+                if (m_nodes[predecessor].dominator == notReached)
+                    continue;
+                newDominator = newDominator == notReached ? predecessor : intersect(predecessor, newDominator);
+            }
+            if (m_nodes[node].dominator != newDominator) {
+                m_nodes[node].dominator = newDominator;
+                changed = true;
+            }
+        }
+    }
+
+    // A dominator always comes after the cells it dominates in postorder.
+    for (unsigned node : postorder)
+        m_nodes[node].retainedSize = m_nodes[node].selfSize;
+    for (unsigned node : postorder) {
+        if (node)
+            m_nodes[m_nodes[node].dominator].retainedSize += m_nodes[node].retainedSize;
+    }
+}
+
+void HeapSnapshotAnalyzer::dump(PrintStream& out, unsigned numberOfCells) const
+{
+    struct ClassSummary {
+        size_t count;
+        size_t selfSize;
+    };
+    Vector<ClassSummary> classes;
+    classes.fill(ClassSummary { 0, 0 }, m_classNames.size());
+    size_t unreachable = 0;
+    for (size_t i = 1; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].dominator == notReached) {
+            unreachable++;
+            continue;
+        }
+        classes[m_nodes[i].className].count++;
+        classes[m_nodes[i].className].selfSize += m_nodes[i].selfSize;
+    }
+
+    Vector<unsigned> classOrder;
+    for (unsigned i = 0; i < classes.size(); ++i) {
+        if (classes[i].count)
+            classOrder.append(i);
+    }
+    std::sort(classOrder.begin(), classOrder.end(), [&] (unsigned a, unsigned b) {
+        return classes[a].selfSize > classes[b].selfSize;
+    });
+
+    out.print("Heap snapshot: ", m_nodes.size() - 1, " cells, ", m_nodes[0].retainedSize, " bytes reachable");
+    if (unreachable)
+        out.print(", ", unreachable, " cells not reachable from the roots");
+    out.print("\n\n");
+
+    out.printf("%12s %14s  %s\n", "count", "self bytes", "class");
+    for (unsigned i : classOrder)
+        out.printf("%12zu %14zu  %s\n", classes[i].count, classes[i].selfSize, m_classNames[i].data());
+
+    Vector<unsigned> cells;
+    for (unsigned i = 1; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].dominator != notReached)
+            cells.append(i);
+    }
+    numberOfCells = std::min<size_t>(numberOfCells, cells.size());
+    std::partial_sort(cells.begin(), cells.begin() + numberOfCells, cells.end(), [&] (unsigned a, unsigned b) {
+        return m_nodes[a].retainedSize > m_nodes[b].retainedSize;
+    });
+
+    out.printf("\n%18s %14s %14s  %s\n", "cell", "retained bytes", "self bytes", "class (retained by)");
+    for (unsigned i = 0; i < numberOfCells; ++i) {
+        const Node& node = m_nodes[cells[i]];
+        const Node& dominator = m_nodes[node.dominator];
+        out.printf("%#18" PRIxPTR " %14zu %14zu  %s (%s)\n", node.cell, node.retainedSize, node.selfSize,
+            m_classNames[node.className].data(), m_classNames[dominator.className].data());
+    }
+}
+
+} // namespace JSC
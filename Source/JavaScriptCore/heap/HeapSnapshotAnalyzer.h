@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HeapSnapshotAnalyzer_h
+#define HeapSnapshotAnalyzer_h
+
+#include "JSExportMacros.h"
+#include <limits.h>
+#include <stdio.h>
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PrintStream.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+// Reads back a snapshot written by HeapSnapshotBuilder and works out the retained size of
+// every cell: the number of bytes that would be freed if nothing outside the cell referred to
+// it any more. That is the size of the cell plus the sizes of all the cells it dominates in the
+// reference graph that starts at the roots. This is meant to run offline, on a snapshot taken
+// from another process, so it keeps the whole graph in memory.
+class HeapSnapshotAnalyzer {
+    WTF_MAKE_NONCOPYABLE(HeapSnapshotAnalyzer);
+public:
+    HeapSnapshotAnalyzer();
+
+    // Returns false if the file could not be read or is not a heap snapshot.
+    JS_EXPORT_PRIVATE bool load(FILE*);
+    JS_EXPORT_PRIVATE void computeRetainedSizes();
+
+    // Prints a per-class summary followed by the cells that retain the most memory.
+    JS_EXPORT_PRIVATE void dump(PrintStream&, unsigned numberOfCells) const;
+
+private:
+    struct Node {
+        uintptr_t cell;
+        size_t selfSize;
+        size_t retainedSize;
+        unsigned className;
+        unsigned dominator;
+        unsigned postorderIndex;
+    };
+
+    static const unsigned notReached = UINT_MAX;
+
+    unsigned nodeIndexFor(uintptr_t cell);
+    unsigned classNameIndexFor(const char*);
+    void buildAdjacency(const Vector<std::pair<unsigned, unsigned>>& edges);
+    void computePostorder(Vector<unsigned>& postorder);
+    unsigned intersect(unsigned, unsigned) const;
+
+    Vector<Node> m_nodes; // m_nodes[0] stands for the roots.
+    HashMap<uintptr_t, unsigned> m_nodeIndices;
+    Vector<CString> m_classNames;
+    HashMap<CString, unsigned> m_classNameIndices;
+    unsigned m_unknownClassName;
+
+    // Successors and predecessors of node i are in [offsets[i], offsets[i + 1]).
+    Vector<unsigned> m_successorOffsets;
+    Vector<unsigned> m_successors;
+    Vector<unsigned> m_predecessorOffsets;
+    Vector<unsigned> m_predecessors;
+};
+
+} // namespace JSC
+
+#endif // HeapSnapshotAnalyzer_h
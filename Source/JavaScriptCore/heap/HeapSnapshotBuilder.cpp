@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshotBuilder.h"
+
+#include "JSCInlines.h"
+#include "MarkedBlock.h"
+#include <inttypes.h>
+
+namespace JSC {
+
+HeapSnapshotBuilder::HeapSnapshotBuilder(PrintStream& out)
+    : m_out(out)
+{
+    m_out.print("JSCHeapSnapshot 1\n");
+}
+
+HeapSnapshotBuilder::~HeapSnapshotBuilder()
+{
+    m_out.flush();
+}
+
+void HeapSnapshotBuilder::appendNode(const JSCell* cell, size_t extraBytes)
+{
+    size_t cellBytes = MarkedBlock::blockFor(cell)->cellSize();
+    const char* className = cell->classInfo()->className;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_out.printf("n %" PRIxPTR " %zu %zu %s\n", reinterpret_cast<uintptr_t>(cell), cellBytes, extraBytes, className);
+}
+
+void HeapSnapshotBuilder::appendEdge(const JSCell* from, const JSCell* to)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_out.printf("e %" PRIxPTR " %" PRIxPTR "\n", reinterpret_cast<uintptr_t>(from), reinterpret_cast<uintptr_t>(to));
+}
+
+} // namespace JSC
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HeapSnapshotBuilder_h
+#define HeapSnapshotBuilder_h
+
+#include <mutex>
+#include <wtf/Noncopyable.h>
+#include <wtf/PrintStream.h>
+
+namespace JSC {
+
+class JSCell;
+
+// Streams the object graph traced by a full collection as text, one record per line:
+//
+//     JSCHeapSnapshot 1
+//     e <from> <to>
+//     n <cell> <cell bytes> <extra bytes> <class name>
+//
+// Cells are identified by their address in hex. An "e" record is a reference the collector
+// followed; references from the roots have a <from> of 0. The "n" record for a cell comes
+// after all of its outgoing references, and <extra bytes> is the out-of-line storage and
+// extra memory it reported while being visited. Nothing is kept per cell, so taking a
+// snapshot costs no memory beyond the output. HeapSnapshotAnalyzer reads the format back.
+class HeapSnapshotBuilder {
+    WTF_MAKE_NONCOPYABLE(HeapSnapshotBuilder);
+public:
+    explicit HeapSnapshotBuilder(PrintStream&);
+    ~HeapSnapshotBuilder();
+
+    // These are called by the SlotVisitors, possibly from several GC threads at once.
+    void appendNode(const JSCell*, size_t extraBytes);
+    void appendEdge(const JSCell* from, const JSCell* to);
+
+private:
+    std::mutex m_lock;
+    PrintStream& m_out;
+};
+
+} // namespace JSC
+
+#endif // HeapSnapshotBuilder_h
@@ -36,6 +36,8 @@
 
 #if PLATFORM(EFL)
 #include <Ecore.h>
+#elif PLATFORM(FLTK)
+#include <FL/Fl.H>
 #endif
 
 namespace JSC {
@@ -140,6 +142,51 @@ bool HeapTimer::timerEvent(void* info)
     
     return ECORE_CALLBACK_CANCEL;
 }
+
+#elif PLATFORM(FLTK)
+
+HeapTimer::HeapTimer(VM* vm)
+    : m_vm(vm)
+    , m_isScheduled(false)
+{
+}
+
+HeapTimer::~HeapTimer()
+{
+    stop();
+}
+
+bool HeapTimer::add(double delay)
+{
+    // FLTK timeouts are dispatched by the main thread's event loop only. VMs living on
+    // other threads (workers) keep sweeping lazily on allocation.
+    if (!isMainThread())
+        return false;
+
+    stop();
+    Fl::add_timeout(delay, timerEvent, this);
+    m_isScheduled = true;
+    return true;
+}
+
+void HeapTimer::stop()
+{
+    if (!m_isScheduled)
+        return;
+
+    Fl::remove_timeout(timerEvent, this);
+    m_isScheduled = false;
+}
+
+void HeapTimer::timerEvent(void* info)
+{
+    HeapTimer* agent = static_cast<HeapTimer*>(info);
+    agent->m_isScheduled = false;
+
+    JSLockHolder locker(agent->m_vm);
+    agent->doWork();
+}
+
 #else
 HeapTimer::HeapTimer(VM* vm)
     : m_vm(vm)
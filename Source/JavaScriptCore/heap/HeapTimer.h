@@ -65,6 +65,11 @@ protected:
     Ecore_Timer* add(double delay, void* agent);
     void stop();
     Ecore_Timer* m_timer;
+#elif PLATFORM(FLTK)
+    static void timerEvent(void*);
+    bool add(double delay);
+    void stop();
+    bool m_isScheduled;
 #endif
     
 private:
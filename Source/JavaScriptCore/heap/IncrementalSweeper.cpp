@@ -37,12 +37,13 @@
 
 namespace JSC {
 
-#if USE(CF)
+#if USE(CF) || PLATFORM(FLTK)
 
 static const double sweepTimeSlice = .01; // seconds
 static const double sweepTimeTotal = .10;
 static const double sweepTimeMultiplier = 1.0 / sweepTimeTotal;
 
+#if USE(CF)
 IncrementalSweeper::IncrementalSweeper(Heap* heap, CFRunLoopRef runLoop)
     : HeapTimer(heap->vm(), runLoop)
     , m_blocksToSweep(heap->m_blockSnapshot)
@@ -58,6 +59,26 @@ void IncrementalSweeper::cancelTimer()
 {
     CFRunLoopTimerSetNextFireDate(m_timer.get(), CFAbsoluteTimeGetCurrent() + s_decade);
 }
+#else
+IncrementalSweeper::IncrementalSweeper(VM* vm)
+    : HeapTimer(vm)
+    , m_blocksToSweep(vm->heap.m_blockSnapshot)
+{
+}
+
+void IncrementalSweeper::scheduleTimer()
+{
+    // Without a timer nobody would ever drain the snapshot, and its blocks may be freed
+    // by the next collection, so leave them to be swept lazily on allocation instead.
+    if (!add(sweepTimeSlice * sweepTimeMultiplier))
+        m_blocksToSweep.clear();
+}
+
+void IncrementalSweeper::cancelTimer()
+{
+    stop();
+}
+#endif
 
 void IncrementalSweeper::fullSweep()
 {
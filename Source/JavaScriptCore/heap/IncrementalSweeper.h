@@ -39,10 +39,12 @@ class IncrementalSweeper : public HeapTimer {
 public:
 #if USE(CF)
     JS_EXPORT_PRIVATE IncrementalSweeper(Heap*, CFRunLoopRef);
-    JS_EXPORT_PRIVATE void fullSweep();
 #else
     explicit IncrementalSweeper(VM*);
 #endif
+#if USE(CF) || PLATFORM(FLTK)
+    JS_EXPORT_PRIVATE void fullSweep();
+#endif
 
     void startSweeping(Vector<MarkedBlock*>&&);
     void addBlocksAndContinueSweeping(Vector<MarkedBlock*>&&);
@@ -51,7 +53,7 @@ public:
     bool sweepNextBlock();
     void willFinishSweeping();
 
-#if USE(CF)
+#if USE(CF) || PLATFORM(FLTK)
 private:
     void doSweep(double startTime);
     void scheduleTimer();
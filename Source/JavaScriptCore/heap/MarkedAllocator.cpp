@@ -211,12 +211,32 @@ void MarkedAllocator::reset()
     m_lastActiveBlock = 0;
     m_currentBlock = 0;
     m_freeList = MarkedBlock::FreeList();
-    if (m_heap->operationInProgress() == FullCollection)
+    if (m_heap->operationInProgress() == FullCollection) {
         m_blockList.append(m_retiredBlocks);
+        if (Options::reclaimSparseMarkedBlocks())
+            sortBlocksByOccupancy();
+    }
 
     m_nextBlockToSweep = m_blockList.head();
 }
 
+void MarkedAllocator::sortBlocksByOccupancy()
+{
+    // Allocating from the densest blocks first means sparse blocks stop receiving new cells, so
+    // they empty out as their remaining cells die and the IncrementalSweeper can free them.
+    Vector<std::pair<size_t, MarkedBlock*>, 64> blocks;
+    while (MarkedBlock* block = m_blockList.removeHead())
+        blocks.append(std::make_pair(block->markCount(), block));
+
+    std::stable_sort(blocks.begin(), blocks.end(),
+        [] (const std::pair<size_t, MarkedBlock*>& a, const std::pair<size_t, MarkedBlock*>& b) {
+            return a.first > b.first;
+        });
+
+    for (auto& entry : blocks)
+        m_blockList.append(entry.second);
+}
+
 struct LastChanceToFinalize : MarkedBlock::VoidFunctor {
     void operator()(MarkedBlock* block) { block->lastChanceToFinalize(); }
 };
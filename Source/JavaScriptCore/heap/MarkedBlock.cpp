@@ -30,6 +30,8 @@
 #include "JSCell.h"
 #include "JSDestructibleObject.h"
 #include "JSCInlines.h"
+#include <wtf/OSAllocator.h>
+#include <wtf/PageBlock.h>
 
 namespace JSC {
 
@@ -52,6 +54,8 @@ MarkedBlock::MarkedBlock(MarkedAllocator* allocator, size_t capacity, size_t cel
     , m_needsDestruction(needsDestruction)
     , m_allocator(allocator)
     , m_state(New) // All cells start out unmarked.
+    , m_backgroundSweepState(NotQueued)
+    , m_backgroundSweepQueueIndex(0)
     , m_weakSet(allocator->heap()->vm(), *this)
 {
     ASSERT(allocator);
@@ -120,6 +124,16 @@ MarkedBlock::FreeList MarkedBlock::sweep(SweepMode sweepMode)
     if (sweepMode == SweepOnly && !m_needsDestruction)
         return FreeList();
 
+    if (sweepMode == SweepToFreeList && finishSweepInBackground()) {
+        ASSERT(m_state == Marked);
+        FreeList freeList = m_backgroundFreeList;
+        m_backgroundFreeList = FreeList();
+        m_backgroundSweepState.store(NotQueued, std::memory_order_relaxed);
+        m_newlyAllocated = nullptr;
+        m_state = FreeListed;
+        return freeList;
+    }
+
     if (m_needsDestruction)
         return sweepHelper<true>(sweepMode);
     return sweepHelper<false>(sweepMode);
@@ -150,6 +164,93 @@ MarkedBlock::FreeList MarkedBlock::sweepHelper(SweepMode sweepMode)
     return FreeList();
 }
 
+bool MarkedBlock::finishSweepInBackground()
+{
+    // Only the mutator moves a block in or out of the queue, so it can trust a NotQueued it reads.
+    if (LIKELY(m_backgroundSweepState.load(std::memory_order_relaxed) == NotQueued))
+        return false;
+    return heap()->finishSweepingBlockInBackground(this);
+}
+
+void MarkedBlock::sweepInBackground()
+{
+    // GCThreadSharedData moves us to BeingSwept before and to Swept after, under its lock.
+    ASSERT(m_backgroundSweepState.load(std::memory_order_relaxed) == BeingSwept);
+    ASSERT(m_state == Marked);
+    ASSERT(!m_needsDestruction);
+
+    // This is specializedSweep<Marked, SweepToFreeList, false>() except that we leave the state
+    // and the liveness bits alone, because the mutator may be inspecting the block while we run.
+    // Dead cells aren't looked at by anyone but the sweeper, so threading them together is safe.
+    FreeCell* head = 0;
+    size_t count = 0;
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        if (m_marks.get(i) || (m_newlyAllocated && m_newlyAllocated->get(i)))
+            continue;
+
+        FreeCell* freeCell = reinterpret_cast_ptr<FreeCell*>(&atoms()[i]);
+        freeCell->next = head;
+        head = freeCell;
+        ++count;
+    }
+
+    m_backgroundFreeList = FreeList(head, count * cellSize());
+}
+
+void MarkedBlock::shrink()
+{
+    m_weakSet.shrink();
+
+    if (Options::reclaimSparseMarkedBlocks() && isSparse())
+        decommitDeadPages();
+}
+
+bool MarkedBlock::isSparse()
+{
+    // Oversize blocks hold a single cell, so they are either full or empty.
+    if (m_capacity != blockSize)
+        return false;
+    return markCount() * cellSize() < Options::sparseMarkedBlockUtilization() * blockSize;
+}
+
+static void decommitPagesBetween(char* begin, char* end)
+{
+    uintptr_t pageMask = WTF::pageSize() - 1;
+    char* firstPage = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(begin) + pageMask) & ~pageMask);
+    char* endPage = reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(end) & ~pageMask);
+    if (firstPage < endPage)
+        OSAllocator::hintMemoryNotNeededSoon(firstPage, endPage - firstPage);
+}
+
+void MarkedBlock::decommitDeadPages()
+{
+    // The dead cells of a Marked block have already been destructed and had their weak
+    // references finalized, and only a sweep will touch them again. A dead cell whose memory
+    // comes back as zeroes looks zapped, so that sweep won't destruct it a second time.
+    // Cells that incremental marking is keeping alive don't have their mark bits set yet.
+    if (m_state != Marked || m_newlyAllocated || heap()->isMarkingIncrementally())
+        return;
+    if (m_backgroundSweepState.load(std::memory_order_relaxed) != NotQueued)
+        return;
+    if (Options::useZombieMode() || Options::objectsAreImmortal())
+        return;
+
+    char* deadCellsBegin = 0;
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        char* cell = reinterpret_cast<char*>(&atoms()[i]);
+        if (!m_marks.get(i)) {
+            if (!deadCellsBegin)
+                deadCellsBegin = cell;
+            continue;
+        }
+        if (deadCellsBegin)
+            decommitPagesBetween(deadCellsBegin, cell);
+        deadCellsBegin = 0;
+    }
+    if (deadCellsBegin)
+        decommitPagesBetween(deadCellsBegin, reinterpret_cast<char*>(this) + blockSize);
+}
+
 class SetNewlyAllocatedFunctor : public MarkedBlock::VoidFunctor {
 public:
     SetNewlyAllocatedFunctor(MarkedBlock* block)
@@ -231,6 +332,13 @@ void MarkedBlock::clearMarksWithCollectionType()
 
     ASSERT(m_state != New && m_state != FreeListed);
     if (collectionType == FullCollection) {
+        // A free list built in the background before this collection is stale now. Nothing is
+        // sweeping it any more because the collection waited for the GC threads to finish.
+        ASSERT(m_backgroundSweepState.load(std::memory_order_relaxed) == NotQueued
+            || m_backgroundSweepState.load(std::memory_order_relaxed) == Swept);
+        m_backgroundSweepState.store(NotQueued, std::memory_order_relaxed);
+        m_backgroundFreeList = FreeList();
+
         m_marks.clearAll();
 #if ENABLE(GGC)
         m_rememberedSet.clearAll();
@@ -247,6 +355,36 @@ void MarkedBlock::clearMarksWithCollectionType()
         m_state = Marked;
 }
 
+void MarkedBlock::willStartIncrementalMarking()
+{
+    HEAP_LOG_BLOCK_STATE_TRANSITION(this);
+    ASSERT(m_state != New && m_state != FreeListed);
+
+    if (!m_newlyAllocated)
+        m_newlyAllocated = std::make_unique<WTF::Bitmap<atomsPerBlock>>();
+
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        if (m_state == Allocated || m_marks.get(i))
+            m_newlyAllocated->set(i);
+    }
+
+    m_marks.clearAll();
+    m_rememberedSet.clearAll();
+
+    // A retired block stays off the allocator's list until the cycle ends.
+    if (m_state == Allocated)
+        m_state = Marked;
+}
+
+void MarkedBlock::didFinishIncrementalMarking()
+{
+    HEAP_LOG_BLOCK_STATE_TRANSITION(this);
+    ASSERT(m_state != New && m_state != FreeListed);
+
+    clearNewlyAllocated();
+    m_state = Marked;
+}
+
 void MarkedBlock::lastChanceToFinalize()
 {
     m_weakSet.lastChanceToFinalize();
@@ -283,12 +421,24 @@ void MarkedBlock::didRetireBlock(const FreeList& freeList)
     // On the other hand we'll waste at most 10% of our Heap space between FullCollections 
     // and only under heavy fragmentation.
 
+    // Sweeping to a free list threw away the cells that incremental marking is keeping alive
+    // until its final pause, and nothing sweeps a retired block again before then, so
+    // rebuild them the way stopAllocating() does.
+    if (heap()->isMarkingIncrementally()) {
+        ASSERT(!m_newlyAllocated);
+        m_newlyAllocated = std::make_unique<WTF::Bitmap<atomsPerBlock>>();
+        SetNewlyAllocatedFunctor functor(this);
+        forEachCell(functor);
+    }
+
     // We need to zap the free list when retiring a block so that we don't try to destroy 
     // previously destroyed objects when we re-sweep the block in the future.
     FreeCell* next;
     for (FreeCell* current = head; current; current = next) {
         next = current->next;
         reinterpret_cast<JSCell*>(current)->zap();
+        if (m_newlyAllocated)
+            clearNewlyAllocated(current);
     }
 
     ASSERT(m_state == FreeListed);
@@ -27,6 +27,7 @@
 #include "HeapOperation.h"
 #include "IterationStatus.h"
 #include "WeakSet.h"
+#include <atomic>
 #include <wtf/Bitmap.h>
 #include <wtf/DataLog.h>
 #include <wtf/DoublyLinkedList.h>
@@ -72,6 +73,7 @@ namespace JSC {
         friend class WTF::DoublyLinkedListNode<MarkedBlock>;
         friend class LLIntOffsetsExtractor;
         friend struct VerifyMarkedOrRetired;
+        friend class GCThreadSharedData;
     public:
         static const size_t atomSize = 16; // bytes
         static const size_t atomShiftAmount = 4; // log_2(atomSize) FIXME: Change atomSize to 16.
@@ -129,6 +131,8 @@ namespace JSC {
         enum SweepMode { SweepOnly, SweepToFreeList };
         FreeList sweep(SweepMode = SweepOnly);
 
+        // Also gives the pages holding only dead cells back to the OS if the block is sparse and
+        // reclaimSparseMarkedBlocks is on. Call this only after the block has been swept.
         void shrink();
 
         void visitWeakSet(HeapRootVisitor&);
@@ -151,8 +155,22 @@ namespace JSC {
         template <HeapOperation collectionType>
         void clearMarksWithCollectionType();
 
+        // Incremental marking clears the marks up front but keeps the cells that were live at
+        // that point in the "newly allocated" bitmap until the final pause.
+        void willStartIncrementalMarking();
+        void didFinishIncrementalMarking();
+
+        // Blocks without destructors or weak references can have their free list built by a GC
+        // thread while the mutator runs. The mutator adopts that free list the next time it sweeps
+        // the block, or sweeps the block itself if no GC thread has got to it yet.
+        bool canSweepInBackground();
+        void willSweepInBackground(size_t queueIndex);
+        void sweepInBackground();
+        void didCancelSweepInBackground();
+
         size_t markCount();
         bool isEmpty();
+        bool isSparse();
 
         size_t cellSize();
         bool needsDestruction() const;
@@ -192,7 +210,10 @@ namespace JSC {
         static const size_t atomAlignmentMask = atomSize - 1; // atomSize must be a power of two.
 
         enum BlockState { New, FreeListed, Allocated, Marked, Retired };
+        enum BackgroundSweepState : uint8_t { NotQueued, Queued, BeingSwept, Swept };
         template<bool callDestructors> FreeList sweepHelper(SweepMode = SweepOnly);
+        bool finishSweepInBackground();
+        void decommitDeadPages();
 
         typedef char Atom[atomSize];
 
@@ -220,6 +241,9 @@ namespace JSC {
         bool m_needsDestruction;
         MarkedAllocator* m_allocator;
         BlockState m_state;
+        std::atomic<BackgroundSweepState> m_backgroundSweepState;
+        size_t m_backgroundSweepQueueIndex;
+        FreeList m_backgroundFreeList;
         WeakSet m_weakSet;
     };
 
@@ -275,11 +299,6 @@ namespace JSC {
         return m_weakSet;
     }
 
-    inline void MarkedBlock::shrink()
-    {
-        m_weakSet.shrink();
-    }
-
     inline void MarkedBlock::visitWeakSet(HeapRootVisitor& heapRootVisitor)
     {
         m_weakSet.visit(heapRootVisitor);
@@ -494,6 +513,28 @@ namespace JSC {
         return m_state == Marked;
     }
 
+    inline bool MarkedBlock::canSweepInBackground()
+    {
+        return m_state == Marked && !m_needsDestruction && m_weakSet.isEmpty()
+            && m_backgroundSweepState.load(std::memory_order_relaxed) == NotQueued;
+    }
+
+    inline void MarkedBlock::willSweepInBackground(size_t queueIndex)
+    {
+        ASSERT(canSweepInBackground());
+        m_backgroundSweepState.store(Queued, std::memory_order_relaxed);
+        m_backgroundSweepQueueIndex = queueIndex;
+    }
+
+    inline void MarkedBlock::didCancelSweepInBackground()
+    {
+        // Only blocks that no GC thread has picked up get cancelled, so we're either still queued
+        // or the mutator already took the block back.
+        ASSERT(m_backgroundSweepState.load(std::memory_order_relaxed) != BeingSwept);
+        ASSERT(m_backgroundSweepState.load(std::memory_order_relaxed) != Swept);
+        m_backgroundSweepState.store(NotQueued, std::memory_order_relaxed);
+    }
+
     inline bool MarkedBlock::isAllocated() const
     {
         return m_state == Allocated;
@@ -246,6 +246,8 @@ void MarkedSpace::freeOrShrinkBlock(MarkedBlock* block)
         return;
     }
 
+    // A GC thread may still be sweeping this block, or have it queued.
+    m_heap->finishSweepingBlockInBackground(block);
     freeBlock(block);
 }
 
@@ -255,6 +257,7 @@ struct Shrink : MarkedBlock::VoidFunctor {
 
 void MarkedSpace::shrink()
 {
+    m_heap->finishSweepingInBackground();
     Free freeOrShrink(Free::FreeOrShrink, this);
     forEachBlock(freeOrShrink);
 }
@@ -330,6 +333,43 @@ void MarkedSpace::clearMarks()
 #endif
 }
 
+struct WillStartIncrementalMarking : MarkedBlock::VoidFunctor {
+    void operator()(MarkedBlock* block) { block->willStartIncrementalMarking(); }
+};
+
+struct DidFinishIncrementalMarking : MarkedBlock::VoidFunctor {
+    void operator()(MarkedBlock* block) { block->didFinishIncrementalMarking(); }
+};
+
+struct TakeLastActiveBlockFunctor {
+    void operator()(MarkedAllocator& allocator) { allocator.takeLastActiveBlock(); }
+};
+
+void MarkedSpace::willStartIncrementalMarking()
+{
+    ASSERT(m_heap->operationInProgress() == FullCollection);
+    forEachBlock<WillStartIncrementalMarking>();
+
+    // Each allocator picks up sweeping where it stopped; the blocks it already used up
+    // stay off its list until the final pause resets it.
+    forEachAllocator<TakeLastActiveBlockFunctor>();
+#if ENABLE(GGC)
+    m_blocksWithNewObjects.clear();
+#endif
+
+#ifndef NDEBUG
+    VerifyMarkedOrRetired verifyFunctor;
+    forEachBlock(verifyFunctor);
+#endif
+}
+
+void MarkedSpace::didFinishIncrementalMarking()
+{
+    ASSERT(m_heap->operationInProgress() == FullCollection);
+    forEachAllocator<TakeLastActiveBlockFunctor>();
+    forEachBlock<DidFinishIncrementalMarking>();
+}
+
 void MarkedSpace::willStartIterating()
 {
     ASSERT(!isIterating());
@@ -144,6 +144,8 @@ public:
     void clearMarks();
     void clearRememberedSet();
     void clearNewlyAllocated();
+    void willStartIncrementalMarking();
+    void didFinishIncrementalMarking();
     void sweep();
     void zombifySweep();
     size_t objectCount();
@@ -6,18 +6,24 @@
 #include "CopiedSpace.h"
 #include "CopiedSpaceInlines.h"
 #include "GCThread.h"
+#include "HeapSnapshotBuilder.h"
 #include "JSArray.h"
 #include "JSDestructibleObject.h"
 #include "VM.h"
 #include "JSObject.h"
 #include "JSString.h"
 #include "JSCInlines.h"
+#include <wtf/CurrentTime.h>
 #include <wtf/StackStats.h>
 
 namespace JSC {
 
 SlotVisitor::SlotVisitor(GCThreadSharedData& shared)
     : m_stack()
+    , m_incrementallyVisitedCell(nullptr)
+    , m_heapSnapshotBuilder(nullptr)
+    , m_currentCell(nullptr)
+    , m_currentCellExtraBytes(0)
     , m_bytesVisited(0)
     , m_bytesCopied(0)
     , m_visitCount(0)
@@ -42,15 +48,24 @@ void SlotVisitor::didStartMarking()
 #if ENABLE(PARALLEL_GC)
         ASSERT(m_opaqueRoots.isEmpty()); // Should have merged by now.
 #else
-        m_opaqueRoots.clear();
+        // The final pause of an incremental cycle keeps the opaque roots found by its slices.
+        if (!heap()->isMarkingIncrementally())
+            m_opaqueRoots.clear();
 #endif
     }
 
-    m_shared.m_shouldHashCons = m_shared.m_vm->haveEnoughNewStringsToHashCons();
+    m_heapSnapshotBuilder = heap()->m_heapSnapshotBuilder;
+
+    // Strings hash consed by incremental marking slices are still in the table. A heap snapshot
+    // has to see the references as they are, so it doesn't hash cons at all.
+    if (!heap()->isMarkingIncrementally())
+        m_shared.m_shouldHashCons = !m_heapSnapshotBuilder && m_shared.m_vm->haveEnoughNewStringsToHashCons();
     m_shouldHashCons = m_shared.m_shouldHashCons;
 #if ENABLE(PARALLEL_GC)
-    for (unsigned i = 0; i < m_shared.m_gcThreads.size(); ++i)
+    for (unsigned i = 0; i < m_shared.m_gcThreads.size(); ++i) {
         m_shared.m_gcThreads[i]->slotVisitor()->m_shouldHashCons = m_shared.m_shouldHashCons;
+        m_shared.m_gcThreads[i]->slotVisitor()->m_heapSnapshotBuilder = m_heapSnapshotBuilder;
+    }
 #endif
 }
 
@@ -80,28 +95,42 @@ void SlotVisitor::append(ConservativeRoots& conservativeRoots)
         internalAppend(0, roots[i]);
 }
 
-ALWAYS_INLINE static void visitChildren(SlotVisitor& visitor, const JSCell* cell)
+ALWAYS_INLINE void SlotVisitor::visitChildren(const JSCell* cell)
 {
     StackStats::probe();
 
     ASSERT(Heap::isMarked(cell));
+
+    if (UNLIKELY(m_heapSnapshotBuilder)) {
+        visitChildrenForHeapSnapshot(cell);
+        return;
+    }
     
     if (isJSString(cell)) {
-        JSString::visitChildren(const_cast<JSCell*>(cell), visitor);
+        JSString::visitChildren(const_cast<JSCell*>(cell), *this);
         return;
     }
 
     if (isJSFinalObject(cell)) {
-        JSFinalObject::visitChildren(const_cast<JSCell*>(cell), visitor);
+        JSFinalObject::visitChildren(const_cast<JSCell*>(cell), *this);
         return;
     }
 
     if (isJSArray(cell)) {
-        JSArray::visitChildren(const_cast<JSCell*>(cell), visitor);
+        JSArray::visitChildren(const_cast<JSCell*>(cell), *this);
         return;
     }
 
-    cell->methodTable()->visitChildren(const_cast<JSCell*>(cell), visitor);
+    cell->methodTable()->visitChildren(const_cast<JSCell*>(cell), *this);
+}
+
+NEVER_INLINE void SlotVisitor::visitChildrenForHeapSnapshot(const JSCell* cell)
+{
+    m_currentCell = cell;
+    m_currentCellExtraBytes = 0;
+    cell->methodTable()->visitChildren(const_cast<JSCell*>(cell), *this);
+    m_heapSnapshotBuilder->appendNode(cell, m_currentCellExtraBytes);
+    m_currentCell = nullptr;
 }
 
 void SlotVisitor::donateKnownParallel()
@@ -142,7 +171,7 @@ void SlotVisitor::drain()
         while (!m_stack.isEmpty()) {
             m_stack.refill();
             for (unsigned countdown = Options::minimumNumberOfScansBetweenRebalance(); m_stack.canRemoveLast() && countdown--;)
-                visitChildren(*this, m_stack.removeLast());
+                visitChildren(m_stack.removeLast());
             donateKnownParallel();
         }
         
@@ -154,8 +183,36 @@ void SlotVisitor::drain()
     while (!m_stack.isEmpty()) {
         m_stack.refill();
         while (m_stack.canRemoveLast())
-            visitChildren(*this, m_stack.removeLast());
+            visitChildren(m_stack.removeLast());
+    }
+}
+
+bool SlotVisitor::drainUntil(double deadline)
+{
+    StackStats::probe();
+    ASSERT(!m_isInParallelMode);
+
+    while (!m_stack.isEmpty()) {
+        m_stack.refill();
+        for (unsigned countdown = Options::minimumNumberOfScansBetweenRebalance(); m_stack.canRemoveLast() && countdown--;) {
+            const JSCell* cell = m_stack.removeLast();
+            m_incrementallyVisitedCell = cell;
+            visitChildren(cell);
+        }
+        if (monotonicallyIncreasingTime() >= deadline)
+            break;
     }
+    m_incrementallyVisitedCell = nullptr;
+
+    mergeOpaqueRootsIfNecessary();
+    return m_stack.isEmpty();
+}
+
+void SlotVisitor::didAddOpaqueRootIncrementally()
+{
+    if (!m_opaqueRootOwners.isEmpty() && m_opaqueRootOwners.last() == m_incrementallyVisitedCell)
+        return;
+    m_opaqueRootOwners.append(m_incrementallyVisitedCell);
 }
 
 void SlotVisitor::drainFromShared(SharedDrainMode sharedDrainMode)
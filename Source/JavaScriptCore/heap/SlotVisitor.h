@@ -39,6 +39,7 @@ namespace JSC {
 class ConservativeRoots;
 class GCThreadSharedData;
 class Heap;
+class HeapSnapshotBuilder;
 template<typename T> class JITWriteBarrier;
 class UnconditionalFinalizer;
 template<typename T> class Weak;
@@ -96,6 +97,14 @@ public:
     void donate();
     void drain();
     void donateAndDrain();
+
+    // Drains on the calling thread without help from the GC threads until the mark stack is
+    // empty or the deadline passes. Returns true if the mark stack was emptied.
+    bool drainUntil(double deadline);
+
+    // Cells that added opaque roots while being visited by drainUntil(). Their opaque roots can
+    // change without a write barrier, so they have to be visited again in the final pause.
+    Vector<const JSCell*> takeOpaqueRootOwners() { return WTF::move(m_opaqueRootOwners); }
     
     enum SharedDrainMode { SlaveDrain, MasterDrain };
     void drainFromShared(SharedDrainMode);
@@ -134,9 +143,19 @@ private:
     void mergeOpaqueRootsIfProfitable();
     
     void donateKnownParallel();
+    void didAddOpaqueRootIncrementally();
+
+    void visitChildren(const JSCell*);
+    void visitChildrenForHeapSnapshot(const JSCell*);
 
     MarkStackArray m_stack;
     OpaqueRootSet m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
+    const JSCell* m_incrementallyVisitedCell;
+    Vector<const JSCell*> m_opaqueRootOwners;
+
+    HeapSnapshotBuilder* m_heapSnapshotBuilder;
+    const JSCell* m_currentCell; // Only tracked while building a heap snapshot.
+    size_t m_currentCellExtraBytes;
     
     size_t m_bytesVisited;
     size_t m_bytesCopied;
@@ -28,6 +28,7 @@
 
 #include "CopiedBlockInlines.h"
 #include "CopiedSpaceInlines.h"
+#include "HeapSnapshotBuilder.h"
 #include "Options.h"
 #include "SlotVisitor.h"
 #include "Weak.h"
@@ -108,6 +109,9 @@ ALWAYS_INLINE void SlotVisitor::internalAppend(void* from, JSCell* cell)
 #if ENABLE(GC_VALIDATION)
     validate(cell);
 #endif
+    if (UNLIKELY(m_heapSnapshotBuilder))
+        m_heapSnapshotBuilder->appendEdge(m_currentCell, cell);
+
     if (Heap::testAndSetMarked(cell) || !cell->structure()) {
         ASSERT(cell->structure());
         return;
@@ -158,6 +162,8 @@ inline void SlotVisitor::addUnconditionalFinalizer(UnconditionalFinalizer* uncon
 
 inline void SlotVisitor::addOpaqueRoot(void* root)
 {
+    if (UNLIKELY(m_incrementallyVisitedCell))
+        didAddOpaqueRootIncrementally();
 #if ENABLE(PARALLEL_GC)
     if (Options::numberOfGCMarkers() == 1) {
         // Put directly into the shared HashSet.
@@ -250,7 +256,17 @@ inline void SlotVisitor::copyLater(JSCell* owner, CopyToken token, void* ptr, si
 
     ASSERT(heap()->m_storageSpace.contains(block));
 
+    if (UNLIKELY(m_heapSnapshotBuilder) && owner == m_currentCell)
+        m_currentCellExtraBytes += bytes;
+
     SpinLockHolder locker(&block->workListLock());
+    if (heap()->isMarkingIncrementally()) {
+        // Owners may be visited both in a slice and again in the final pause, so live bytes
+        // cannot be counted exactly. Keep the block where it is instead of evacuating it.
+        m_bytesCopied += bytes;
+        m_shared.m_copiedSpace->pin(block);
+        return;
+    }
     if (heap()->operationInProgress() == FullCollection || block->shouldReportLiveBytes(locker, owner)) {
         m_bytesCopied += bytes;
         block->reportLiveBytes(locker, owner, token, bytes);
@@ -259,6 +275,8 @@ inline void SlotVisitor::copyLater(JSCell* owner, CopyToken token, void* ptr, si
     
 inline void SlotVisitor::reportExtraMemoryVisited(JSCell* owner, size_t size)
 {
+    if (UNLIKELY(m_heapSnapshotBuilder) && owner == m_currentCell)
+        m_currentCellExtraBytes += size;
     heap()->reportExtraMemoryVisited(owner, size);
 }
 
@@ -30,6 +30,7 @@
 #include "CopiedSpaceInlines.h"
 #include "Disassembler.h"
 #include "ExceptionHelpers.h"
+#include "HeapSnapshotAnalyzer.h"
 #include "HeapStatistics.h"
 #include "InitializeThreading.h"
 #include "Interpreter.h"
@@ -40,6 +41,7 @@
 #include "JSLock.h"
 #include "JSONObject.h"
 #include "JSProxy.h"
+#include "ObjectConstructor.h"
 #include "JSString.h"
 #include "ProfilerDatabase.h"
 #include "SamplingTool.h"
@@ -54,6 +56,7 @@
 #include <string.h>
 #include <thread>
 #include <wtf/CurrentTime.h>
+#include <wtf/FilePrintStream.h>
 #include <wtf/MainThread.h>
 #include <wtf/StringPrintStream.h>
 #include <wtf/text/StringBuilder.h>
@@ -447,8 +450,13 @@ static EncodedJSValue JSC_HOST_CALL functionJSCStack(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGCAndSweep(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionFullGC(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionEdenGC(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionStartIncrementalGC(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionIncrementalGCStatistics(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionHeapSize(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDeleteAllCompiledCode(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionTakeHeapSnapshot(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionAnalyzeHeapSnapshot(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionRemoveFile(ExecState*);
 #ifndef NDEBUG
 static EncodedJSValue JSC_HOST_CALL functionReleaseExecutableMemory(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDumpCallFrame(ExecState*);
@@ -587,8 +595,12 @@ protected:
         addFunction(vm, "gc", functionGCAndSweep, 0);
         addFunction(vm, "fullGC", functionFullGC, 0);
         addFunction(vm, "edenGC", functionEdenGC, 0);
+        addFunction(vm, "startIncrementalGC", functionStartIncrementalGC, 0);
+        addFunction(vm, "incrementalGCStatistics", functionIncrementalGCStatistics, 0);
         addFunction(vm, "gcHeapSize", functionHeapSize, 0);
         addFunction(vm, "deleteAllCompiledCode", functionDeleteAllCompiledCode, 0);
+        addFunction(vm, "takeHeapSnapshot", functionTakeHeapSnapshot, 1);
+        addFunction(vm, "analyzeHeapSnapshot", functionAnalyzeHeapSnapshot, 2);
 #ifndef NDEBUG
         addFunction(vm, "dumpCallFrame", functionDumpCallFrame, 0);
         addFunction(vm, "releaseExecutableMemory", functionReleaseExecutableMemory, 0);
@@ -597,6 +609,7 @@ protected:
         addFunction(vm, "run", functionRun, 1);
         addFunction(vm, "load", functionLoad, 1);
         addFunction(vm, "readFile", functionReadFile, 1);
+        addFunction(vm, "removeFile", functionRemoveFile, 1);
         addFunction(vm, "checkSyntax", functionCheckSyntax, 1);
         addFunction(vm, "jscStack", functionJSCStack, 1);
         addFunction(vm, "readline", functionReadline, 0);
@@ -853,6 +866,26 @@ EncodedJSValue JSC_HOST_CALL functionEdenGC(ExecState* exec)
     return JSValue::encode(jsNumber(exec->heap()->sizeAfterLastEdenCollection()));
 }
 
+// Returns whether the heap is marking incrementally afterwards.
+EncodedJSValue JSC_HOST_CALL functionStartIncrementalGC(ExecState* exec)
+{
+    JSLockHolder lock(exec);
+    exec->heap()->startIncrementalMarkingForTesting();
+    return JSValue::encode(jsBoolean(exec->heap()->isMarkingIncrementally()));
+}
+
+EncodedJSValue JSC_HOST_CALL functionIncrementalGCStatistics(ExecState* exec)
+{
+    JSLockHolder lock(exec);
+    VM& vm = exec->vm();
+    Heap* heap = exec->heap();
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(vm, Identifier::fromString(exec, "cycles"), jsNumber(heap->incrementalMarkingCycleCount()));
+    result->putDirect(vm, Identifier::fromString(exec, "slices"), jsNumber(heap->markingSliceCount()));
+    result->putDirect(vm, Identifier::fromString(exec, "isMarking"), jsBoolean(heap->isMarkingIncrementally()));
+    return JSValue::encode(result);
+}
+
 EncodedJSValue JSC_HOST_CALL functionHeapSize(ExecState* exec)
 {
     JSLockHolder lock(exec);
@@ -866,6 +899,66 @@ EncodedJSValue JSC_HOST_CALL functionDeleteAllCompiledCode(ExecState* exec)
     return JSValue::encode(jsUndefined());
 }
 
+// Without a file name, the snapshot goes to a new temporary file. Returns the name of the file.
+EncodedJSValue JSC_HOST_CALL functionTakeHeapSnapshot(ExecState* exec)
+{
+    String fileName;
+    std::unique_ptr<FilePrintStream> out;
+    if (exec->argumentCount() && !exec->uncheckedArgument(0).isUndefined()) {
+        fileName = exec->uncheckedArgument(0).toString(exec)->value(exec);
+        out = FilePrintStream::open(fileName.utf8().data(), "w");
+    } else {
+        const char* directory = getenv("TMPDIR");
+        CString pattern = makeString(directory && *directory ? directory : "/tmp", "/jsc-heap-snapshot-XXXXXX").utf8();
+        Vector<char> path;
+        path.append(pattern.data(), pattern.length() + 1);
+        int fd = mkstemp(path.data());
+        FILE* file = fd >= 0 ? fdopen(fd, "w") : nullptr;
+        if (file) {
+            fileName = String(path.data());
+            out = std::make_unique<FilePrintStream>(file);
+        } else if (fd >= 0) {
+            close(fd);
+            unlink(path.data());
+        }
+    }
+    if (!out)
+        return JSValue::encode(exec->vm().throwException(exec, createError(exec, ASCIILiteral("Could not open file."))));
+
+    JSLockHolder lock(exec);
+    exec->heap()->takeHeapSnapshot(*out);
+    return JSValue::encode(jsString(exec, fileName));
+}
+
+EncodedJSValue JSC_HOST_CALL functionRemoveFile(ExecState* exec)
+{
+    String fileName = exec->argument(0).toString(exec)->value(exec);
+    if (unlink(fileName.utf8().data()))
+        return JSValue::encode(exec->vm().throwException(exec, createError(exec, ASCIILiteral("Could not remove file."))));
+    return JSValue::encode(jsUndefined());
+}
+
+EncodedJSValue JSC_HOST_CALL functionAnalyzeHeapSnapshot(ExecState* exec)
+{
+    String fileName = exec->argument(0).toString(exec)->value(exec);
+    unsigned numberOfCells = exec->argumentCount() > 1 ? exec->uncheckedArgument(1).toUInt32(exec) : 20;
+
+    FILE* file = fopen(fileName.utf8().data(), "r");
+    if (!file)
+        return JSValue::encode(exec->vm().throwException(exec, createError(exec, ASCIILiteral("Could not open file."))));
+
+    HeapSnapshotAnalyzer analyzer;
+    bool loaded = analyzer.load(file);
+    fclose(file);
+    if (!loaded)
+        return JSValue::encode(exec->vm().throwException(exec, createError(exec, ASCIILiteral("Not a heap snapshot."))));
+
+    analyzer.computeRetainedSizes();
+    FilePrintStream out(stdout, FilePrintStream::Borrow);
+    analyzer.dump(out, numberOfCells);
+    return JSValue::encode(jsUndefined());
+}
+
 #ifndef NDEBUG
 EncodedJSValue JSC_HOST_CALL functionReleaseExecutableMemory(ExecState* exec)
 {
@@ -276,12 +276,19 @@ typedef const char* optionString;
     v(double, minHeapUtilization, 0.8, nullptr) \
     v(double, minCopiedBlockUtilization, 0.9, nullptr) \
     v(double, minMarkedBlockUtilization, 0.9, nullptr) \
+    v(bool, useBackgroundSweeping, false, "build free lists for blocks without destructors on the GC threads after a collection") \
+    v(bool, reclaimSparseMarkedBlocks, false, "allocate from the densest blocks first and give the pages of dead cells in sparse blocks back to the OS") \
+    v(double, sparseMarkedBlockUtilization, 0.25, nullptr) \
     v(unsigned, slowPathAllocsBetweenGCs, 0, "force a GC on every Nth slow path alloc, where N is specified by this option") \
     \
     v(double, percentCPUPerMBForFullTimer, 0.0003125, nullptr) \
     v(double, percentCPUPerMBForEdenTimer, 0.0025, nullptr) \
     v(double, collectionTimerMaxPercentCPU, 0.05, nullptr) \
     \
+    v(bool, useIncrementalMarking, false, "trace the heap in short slices between mutator turns during full collections triggered by allocation") \
+    v(double, incrementalMarkingSliceMilliseconds, 2, nullptr) \
+    v(unsigned, incrementalMarkingSliceBytes, 256 * 1024, "bytes the mutator may allocate between two incremental marking slices") \
+    \
     v(bool, forceWeakRandomSeed, false, nullptr) \
     v(unsigned, forcedWeakRandomSeed, 0, nullptr) \
     \
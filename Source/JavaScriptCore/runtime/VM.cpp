@@ -491,6 +491,19 @@ void VM::clearSourceProviderCaches()
     sourceProviderCacheMap.clear();
 }
 
+void VM::pruneSourceProviderCaches()
+{
+    // Keep the function boundaries of sources that can still be parsed again, so lazily
+    // compiled functions don't have to be re-scanned after every collection.
+    Vector<SourceProvider*> deadProviders;
+    for (auto& provider : sourceProviderCacheMap.keys()) {
+        if (provider->hasOneRef())
+            deadProviders.append(provider.get());
+    }
+    for (auto* provider : deadProviders)
+        sourceProviderCacheMap.remove(provider);
+}
+
 struct StackPreservingRecompiler : public MarkedBlock::VoidFunctor {
     HashSet<FunctionExecutable*> currentlyExecutingFunctions;
     inline void visit(JSCell* cell)
@@ -323,6 +323,7 @@ public:
 
     SourceProviderCache* addSourceProviderCache(SourceProvider*);
     void clearSourceProviderCaches();
+    void pruneSourceProviderCaches();
 
     PrototypeMap prototypeMap;
 
@@ -0,0 +1,49 @@
+//@ run("background-sweeping", "--useBackgroundSweeping=true", "--numberOfGCMarkers=4")
+
+// Allocate into and collect blocks while the GC threads may still be building
+// their free lists, and make sure no live cell is handed out again.
+
+function makeObject(i) {
+    return { index: i, next: null, values: [i, i + 1, i + 2] };
+}
+
+function check(object, i) {
+    if (object.index !== i || object.values.length !== 3 || object.values[0] !== i || object.values[2] !== i + 2)
+        throw "Error: bad object at " + i + ": " + JSON.stringify(object);
+}
+
+var live = [];
+for (var iteration = 0; iteration < 100; ++iteration) {
+    // Mostly garbage, so the collection leaves many blocks to sweep.
+    var garbage = [];
+    for (var i = 0; i < 20000; ++i) {
+        var object = makeObject(i);
+        if (!(i % 50))
+            live.push(object);
+        else
+            garbage.push(object);
+    }
+    garbage = null;
+
+    if (iteration % 3)
+        edenGC();
+    else
+        fullGC();
+
+    // Allocate straight away, racing the GC threads for the swept blocks.
+    var fresh = [];
+    for (var i = 0; i < 20000; ++i)
+        fresh.push(makeObject(i));
+
+    // Collect again before the sweep can have finished.
+    if (iteration % 2)
+        fullGC();
+
+    for (var i = 0; i < fresh.length; ++i)
+        check(fresh[i], i);
+    if (live.length > 4000)
+        live.splice(0, 2000);
+}
+
+for (var i = 0; i < live.length; ++i)
+    check(live[i], live[i].index);
@@ -0,0 +1,24 @@
+// Take a heap snapshot of a graph with a known retainer and read it back.
+
+var retainer = { children: [] };
+for (var i = 0; i < 1000; ++i)
+    retainer.children.push({ index: i, payload: new Array(16) });
+
+var snapshotFile = takeHeapSnapshot();
+try {
+    var snapshot = readFile(snapshotFile);
+    if (snapshot.indexOf("JSCHeapSnapshot 1\n") !== 0)
+        throw "Error: bad snapshot header";
+    if (!/^n [0-9a-f]+ [0-9]+ [0-9]+ Array$/m.test(snapshot))
+        throw "Error: snapshot has no arrays";
+    if (!/^e 0 [0-9a-f]+$/m.test(snapshot))
+        throw "Error: snapshot has no root references";
+
+    analyzeHeapSnapshot(snapshotFile, 5);
+} finally {
+    removeFile(snapshotFile);
+}
+
+// Keep the graph alive until after the snapshot.
+if (retainer.children.length !== 1000)
+    throw "Error: bad length";
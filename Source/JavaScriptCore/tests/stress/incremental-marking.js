@@ -0,0 +1,56 @@
+//@ run("incremental-marking", "--useIncrementalMarking=true", "--incrementalMarkingSliceBytes=4096")
+
+// Mutate an old object graph while marking is in progress and make sure
+// nothing reachable is collected. Explicit fullGC() calls never mark
+// incrementally, so cycles are started with startIncrementalGC().
+
+function Node(value, next) {
+    this.value = value;
+    this.next = next;
+}
+
+var head = null;
+for (var i = 0; i < 10000; ++i)
+    head = new Node(i, head);
+
+fullGC();
+
+for (var iteration = 0; iteration < 200; ++iteration) {
+    if (!incrementalGCStatistics().isMarking && !startIncrementalGC())
+        throw "Error: could not start incremental marking";
+    var node = head;
+    var count = 0;
+    while (node) {
+        if (!(count % 7))
+            node.payload = { iteration: iteration, data: new Array(8).fill(count) };
+        if (!(count % 13))
+            node.next = node.next ? new Node(node.next.value, node.next.next) : null;
+        node = node.next;
+        ++count;
+    }
+    for (var j = 0; j < 1000; ++j)
+        var garbage = [j, j + 1, { j: j }];
+}
+
+var statistics = incrementalGCStatistics();
+if (!statistics.cycles)
+    throw "Error: no incremental marking cycle ran";
+if (!statistics.slices)
+    throw "Error: no incremental marking slice ran";
+
+fullGC();
+
+var node = head;
+var count = 0;
+var expected = 9999;
+while (node) {
+    if (node.value !== expected)
+        throw "Error: bad value " + node.value + " at " + count + ", expected " + expected;
+    if (node.payload && node.payload.data.length !== 8)
+        throw "Error: bad payload at " + count;
+    node = node.next;
+    --expected;
+    ++count;
+}
+if (count !== 10000)
+    throw "Error: bad length " + count;
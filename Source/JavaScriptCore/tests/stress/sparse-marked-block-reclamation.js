@@ -0,0 +1,40 @@
+//@ run("sparse-marked-block-reclamation", "--reclaimSparseMarkedBlocks=true")
+
+// Grow the heap, drop most of it so that every block is left sparse, and make
+// sure the survivors and newly allocated objects are intact afterwards.
+
+function makeObject(i) {
+    return { index: i, name: "object" + i, values: [i, i * 2, i * 3] };
+}
+
+function check(object, i) {
+    if (object.index !== i || object.name !== "object" + i || object.values[2] !== i * 3)
+        throw new Error("Bad object at " + i);
+}
+
+for (var round = 0; round < 5; ++round) {
+    var objects = [];
+    for (var i = 0; i < 100000; ++i)
+        objects.push(makeObject(i));
+
+    var survivors = [];
+    for (var i = 0; i < objects.length; i += 50)
+        survivors.push(objects[i]);
+    objects = null;
+
+    fullGC();
+
+    for (var i = 0; i < survivors.length; ++i)
+        check(survivors[i], i * 50);
+
+    var fresh = [];
+    for (var i = 0; i < 20000; ++i)
+        fresh.push(makeObject(i));
+
+    gc();
+
+    for (var i = 0; i < survivors.length; ++i)
+        check(survivors[i], i * 50);
+    for (var i = 0; i < fresh.length; ++i)
+        check(fresh[i], i);
+}
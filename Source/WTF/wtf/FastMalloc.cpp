@@ -30,6 +30,7 @@
 #include "CheckedArithmetic.h"
 #include "CurrentTime.h"
 #include <limits>
+#include <stdio.h>
 #include <string.h>
 #include <wtf/DataLog.h>
 
@@ -171,6 +172,8 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+void fastMallocDumpStatistics() { }
+
 size_t fastMallocSize(const void* p)
 {
 #if OS(DARWIN)
@@ -266,11 +269,56 @@ void releaseFastMallocFreeMemory()
 
 FastMallocStatistics fastMallocStatistics()
 {
-    // FIXME: This is incorrect; needs an implementation or to be removed.
-    FastMallocStatistics statistics = { 0, 0, 0 };
+    bmalloc::HeapStatistics heapStatistics = bmalloc::api::heapStatistics();
+    FastMallocStatistics statistics = { heapStatistics.reservedBytes(), heapStatistics.committedBytes(), heapStatistics.freeBytes() };
     return statistics;
 }
 
+static void dumpChunkStatistics(const char* name, const bmalloc::ChunkStatistics& statistics)
+{
+    dataLogF("%-10s %12zu %12zu %12zu %12zu %12zu\n", name, statistics.reservedBytes / KB, statistics.committedBytes / KB,
+        statistics.objectBytes / KB, statistics.freeBytes / KB, statistics.pendingDecommitBytes / KB);
+}
+
+static void dumpScavengeStatistics(const char* name, const bmalloc::ChunkStatistics& statistics)
+{
+    dataLogF("%-10s %12zu %12zu %12zu %12zu\n", name, statistics.reusedBytes / KB, statistics.vmAllocatedBytes / KB,
+        statistics.scavengedBytes / KB, statistics.demandBytes / KB);
+}
+
+void fastMallocDumpStatistics()
+{
+    bmalloc::HeapStatistics heapStatistics = bmalloc::api::heapStatistics();
+    bmalloc::ThreadStatistics threadStatistics = bmalloc::api::threadStatistics();
+
+    dataLogF("%-10s %12s %12s %12s %12s %12s\n", "(kB)", "Reserved", "Committed", "Objects", "Free", "Decommit");
+    dumpChunkStatistics("Small", heapStatistics.small);
+    dumpChunkStatistics("Medium", heapStatistics.medium);
+    dumpChunkStatistics("Large", heapStatistics.large);
+    dumpChunkStatistics("XLarge", heapStatistics.xLarge);
+    dataLogF("%-10s %12zu %12zu %12zu %12zu %12zu\n", "Total", heapStatistics.reservedBytes() / KB, heapStatistics.committedBytes() / KB,
+        heapStatistics.objectBytes() / KB, heapStatistics.freeBytes() / KB, heapStatistics.pendingDecommitBytes() / KB);
+    dataLogF("Fragmentation %.1f%%, this thread caches %zu bytes and %zu pending frees\n\n",
+        heapStatistics.fragmentation() * 100, threadStatistics.bumpRangeBytes, threadStatistics.deallocatorLogCount);
+
+    dataLogF("%-10s %12s %12s %12s %12s\n", "(kB)", "Reused", "Faulted in", "Scavenged", "Demand");
+    dumpScavengeStatistics("Small", heapStatistics.small);
+    dumpScavengeStatistics("Medium", heapStatistics.medium);
+    dumpScavengeStatistics("Large", heapStatistics.large);
+    dataLogF("%zu scavenger passes\n\n", heapStatistics.scavengePassCount);
+
+    dataLogF("%-10s %12s %12s %12s %12s\n", "Size class", "Pages", "Lines", "Objects", "Bytes");
+    for (size_t i = 0; i < heapStatistics.sizeClasses.size(); ++i) {
+        const bmalloc::SizeClassStatistics& sizeClass = heapStatistics.sizeClasses[i];
+        if (!sizeClass.pageCount)
+            continue;
+        size_t objectSize = bmalloc::objectSize(i);
+        dataLogF("%-10zu %12zu %12zu %12zu %12zu\n", objectSize, sizeClass.pageCount, sizeClass.lineCount,
+            sizeClass.objectCount, sizeClass.objectCount * objectSize);
+    }
+    dataLogF("\n");
+}
+
 } // namespace WTF
 
 #endif // defined(USE_SYSTEM_MALLOC) && USE_SYSTEM_MALLOC
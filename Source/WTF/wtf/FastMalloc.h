@@ -68,6 +68,9 @@ struct FastMallocStatistics {
 };
 WTF_EXPORT_PRIVATE FastMallocStatistics fastMallocStatistics();
 
+// Prints a breakdown of the allocator's memory by chunk type and size class to stdout.
+WTF_EXPORT_PRIVATE void fastMallocDumpStatistics();
+
 // This defines a type which holds an unsigned integer and is the same
 // size as the minimally aligned memory allocation.
 typedef unsigned long long AllocAlignmentInteger;
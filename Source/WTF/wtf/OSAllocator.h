@@ -53,6 +53,10 @@ public:
     WTF_EXPORT_PRIVATE static void commit(void*, size_t, bool writable, bool executable);
     WTF_EXPORT_PRIVATE static void decommit(void*, size_t);
 
+    // Tells the OS that a committed region's contents are no longer interesting. The region stays
+    // accessible; reading it afterwards yields either its old contents or zeroes.
+    WTF_EXPORT_PRIVATE static void hintMemoryNotNeededSoon(void*, size_t);
+
     // These methods are symmetric; reserveAndCommit allocates VM in an committed state,
     // decommitAndRelease should be called on a region of VM allocated by a single reservation,
     // the memory must all currently be in a committed state.
@@ -162,6 +162,20 @@ void OSAllocator::decommit(void* address, size_t bytes)
 #endif
 }
 
+void OSAllocator::hintMemoryNotNeededSoon(void* address, size_t bytes)
+{
+#if OS(LINUX)
+    madvise(address, bytes, MADV_DONTNEED);
+#elif HAVE(MADV_FREE)
+    while (madvise(address, bytes, MADV_FREE) == -1 && errno == EAGAIN) { }
+#elif HAVE(MADV_DONTNEED)
+    while (madvise(address, bytes, MADV_DONTNEED) == -1 && errno == EAGAIN) { }
+#else
+    UNUSED_PARAM(address);
+    UNUSED_PARAM(bytes);
+#endif
+}
+
 void OSAllocator::releaseDecommitted(void* address, size_t bytes)
 {
     int result = munmap(address, bytes);
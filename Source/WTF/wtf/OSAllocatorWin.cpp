@@ -80,6 +80,14 @@ void OSAllocator::decommit(void* address, size_t bytes)
         CRASH();
 }
 
+void OSAllocator::hintMemoryNotNeededSoon(void* address, size_t bytes)
+{
+    if (!bytes)
+        return;
+    // MEM_RESET keeps the pages committed and accessible but lets the OS discard their contents.
+    VirtualAlloc(address, bytes, MEM_RESET, PAGE_READWRITE);
+}
+
 void OSAllocator::releaseDecommitted(void* address, size_t bytes)
 {
     // See comment in OSAllocator::decommit(). Similarly, when bytes is 0, we
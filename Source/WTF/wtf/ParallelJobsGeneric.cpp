@@ -30,112 +30,164 @@
 #if ENABLE(THREADING_GENERIC)
 
 #include "ParallelJobs.h"
+#include <mutex>
+#include <wtf/NeverDestroyed.h>
 #include <wtf/NumberOfCores.h>
+#include <wtf/Threading.h>
+#include <wtf/ThreadingPrimitives.h>
 
 namespace WTF {
 
-Vector< RefPtr<ParallelEnvironment::ThreadPrivate> >* ParallelEnvironment::s_threadPool = 0;
-
-ParallelEnvironment::ParallelEnvironment(ThreadFunction threadFunction, size_t sizeOfParameter, int requestedJobNumber) :
-    m_threadFunction(threadFunction),
-    m_sizeOfParameter(sizeOfParameter)
-{
-    ASSERT_ARG(requestedJobNumber, requestedJobNumber >= 1);
-
-    int maxNumberOfCores = numberOfProcessorCores();
-
-    if (!requestedJobNumber || requestedJobNumber > maxNumberOfCores)
-        requestedJobNumber = static_cast<unsigned>(maxNumberOfCores);
+namespace {
+
+struct ParallelJobBatch {
+    ParallelJobBatch(ParallelEnvironment::ThreadFunction threadFunction, unsigned char* parameters, size_t sizeOfParameter, size_t numberOfJobs)
+        : threadFunction(threadFunction)
+        , parameters(parameters)
+        , sizeOfParameter(sizeOfParameter)
+        , numberOfJobs(numberOfJobs)
+        , nextJob(0)
+        , unfinishedJobs(numberOfJobs)
+    {
+    }
 
-    if (!s_threadPool)
-        s_threadPool = new Vector< RefPtr<ThreadPrivate> >();
+    ParallelEnvironment::ThreadFunction threadFunction;
+    unsigned char* parameters;
+    size_t sizeOfParameter;
+    size_t numberOfJobs;
+
+    // Guarded by the pool's mutex.
+    size_t nextJob;
+    size_t unfinishedJobs;
+    ThreadCondition finishedCondition;
+};
+
+class ParallelWorkerPool {
+    WTF_MAKE_NONCOPYABLE(ParallelWorkerPool);
+public:
+    static ParallelWorkerPool& singleton()
+    {
+        static std::once_flag onceFlag;
+        static LazyNeverDestroyed<ParallelWorkerPool> pool;
+        std::call_once(onceFlag, [] {
+            pool.construct();
+        });
+        return pool;
+    }
 
-    // The main thread should be also a worker.
-    int maxNumberOfNewThreads = requestedJobNumber - 1;
+    int numberOfThreads() const { return m_numberOfThreads; }
+
+    void run(ParallelJobBatch& batch)
+    {
+        {
+            MutexLocker locker(m_mutex);
+            m_batches.append(&batch);
+            if (batch.numberOfJobs > 2)
+                m_condition.broadcast();
+            else
+                m_condition.signal();
+        }
 
-    for (int i = 0; i < maxNumberOfCores && m_threads.size() < static_cast<unsigned>(maxNumberOfNewThreads); ++i) {
-        if (s_threadPool->size() < static_cast<unsigned>(i) + 1U)
-            s_threadPool->append(ThreadPrivate::create());
+        // The calling thread works through its own jobs too, so the batch completes even when every
+        // pool thread is busy with other batches.
+        size_t job;
+        while (claimJob(batch, job))
+            runJob(batch, job);
 
-        if ((*s_threadPool)[i]->tryLockFor(this))
-            m_threads.append((*s_threadPool)[i]);
+        MutexLocker locker(m_mutex);
+        while (batch.unfinishedJobs)
+            batch.finishedCondition.wait(m_mutex);
     }
 
-    m_numberOfJobs = m_threads.size() + 1;
-}
-
-void ParallelEnvironment::execute(void* parameters)
-{
-    unsigned char* currentParameter = static_cast<unsigned char*>(parameters);
-    size_t i;
-    for (i = 0; i < m_threads.size(); ++i) {
-        m_threads[i]->execute(m_threadFunction, currentParameter);
-        currentParameter += m_sizeOfParameter;
+private:
+    friend class LazyNeverDestroyed<ParallelWorkerPool>;
+
+    ParallelWorkerPool()
+        : m_numberOfThreads(0)
+    {
+        // The thread calling execute() is a worker as well.
+        int numberOfThreads = numberOfProcessorCores() - 1;
+        for (int i = 0; i < numberOfThreads; ++i) {
+            if (createThread(&ParallelWorkerPool::workerThread, this, "Parallel worker"))
+                ++m_numberOfThreads;
+        }
     }
 
-    // The work for the main thread.
-    (*m_threadFunction)(currentParameter);
-
-    // Wait until all jobs are done.
-    for (i = 0; i < m_threads.size(); ++i)
-        m_threads[i]->waitForFinish();
-}
+    bool claimJob(ParallelJobBatch& batch, size_t& job)
+    {
+        MutexLocker locker(m_mutex);
+        return claimJobLocked(batch, job);
+    }
 
-bool ParallelEnvironment::ThreadPrivate::tryLockFor(ParallelEnvironment* parent)
-{
-    bool locked = m_mutex.tryLock();
+    bool claimJobLocked(ParallelJobBatch& batch, size_t& job)
+    {
+        if (batch.nextJob == batch.numberOfJobs)
+            return false;
+        job = batch.nextJob++;
+        // Fully claimed batches leave the queue; their caller may return as soon as the last job finishes.
+        if (batch.nextJob == batch.numberOfJobs)
+            m_batches.remove(m_batches.find(&batch));
+        return true;
+    }
 
-    if (!locked)
-        return false;
+    void runJob(ParallelJobBatch& batch, size_t job)
+    {
+        (*batch.threadFunction)(batch.parameters + job * batch.sizeOfParameter);
 
-    if (m_parent) {
-        m_mutex.unlock();
-        return false;
+        MutexLocker locker(m_mutex);
+        if (!--batch.unfinishedJobs)
+            batch.finishedCondition.signal();
     }
 
-    if (!m_threadID)
-        m_threadID = createThread(&ParallelEnvironment::ThreadPrivate::workerThread, this, "Parallel worker");
+    static void workerThread(void* context)
+    {
+        ParallelWorkerPool* pool = static_cast<ParallelWorkerPool*>(context);
+        while (true) {
+            ParallelJobBatch* batch;
+            size_t job;
+            {
+                MutexLocker locker(pool->m_mutex);
+                while (pool->m_batches.isEmpty())
+                    pool->m_condition.wait(pool->m_mutex);
+                batch = pool->m_batches.first();
+                bool claimed = pool->claimJobLocked(*batch, job);
+                ASSERT_UNUSED(claimed, claimed);
+            }
+            pool->runJob(*batch, job);
+        }
+    }
 
-    if (m_threadID)
-        m_parent = parent;
+    int m_numberOfThreads;
+    Mutex m_mutex;
+    ThreadCondition m_condition;
+    Vector<ParallelJobBatch*> m_batches;
+};
 
-    m_mutex.unlock();
-    return m_threadID;
-}
+} // namespace
 
-void ParallelEnvironment::ThreadPrivate::execute(ThreadFunction threadFunction, void* parameters)
+ParallelEnvironment::ParallelEnvironment(ThreadFunction threadFunction, size_t sizeOfParameter, int requestedJobNumber) :
+    m_threadFunction(threadFunction),
+    m_sizeOfParameter(sizeOfParameter)
 {
-    MutexLocker lock(m_mutex);
+    ASSERT_ARG(requestedJobNumber, requestedJobNumber >= 1);
 
-    m_threadFunction = threadFunction;
-    m_parameters = parameters;
-    m_running = true;
-    m_threadCondition.signal();
-}
+    int maxNumberOfJobs = ParallelWorkerPool::singleton().numberOfThreads() + 1;
 
-void ParallelEnvironment::ThreadPrivate::waitForFinish()
-{
-    MutexLocker lock(m_mutex);
+    if (!requestedJobNumber || requestedJobNumber > maxNumberOfJobs)
+        requestedJobNumber = maxNumberOfJobs;
 
-    while (m_running)
-        m_threadCondition.wait(m_mutex);
+    m_numberOfJobs = requestedJobNumber;
 }
 
-void ParallelEnvironment::ThreadPrivate::workerThread(void* threadData)
+void ParallelEnvironment::execute(void* parameters)
 {
-    ThreadPrivate* sharedThread = reinterpret_cast<ThreadPrivate*>(threadData);
-    MutexLocker lock(sharedThread->m_mutex);
-
-    while (sharedThread->m_threadID) {
-        if (sharedThread->m_running) {
-            (*sharedThread->m_threadFunction)(sharedThread->m_parameters);
-            sharedThread->m_running = false;
-            sharedThread->m_parent = 0;
-            sharedThread->m_threadCondition.signal();
-        }
-
-        sharedThread->m_threadCondition.wait(sharedThread->m_mutex);
+    if (m_numberOfJobs == 1) {
+        (*m_threadFunction)(parameters);
+        return;
     }
+
+    ParallelJobBatch batch(m_threadFunction, static_cast<unsigned char*>(parameters), m_sizeOfParameter, m_numberOfJobs);
+    ParallelWorkerPool::singleton().run(batch);
 }
 
 } // namespace WTF
@@ -344,6 +344,11 @@
 #define WTF_CPU_NEEDS_ALIGNED_ACCESS 1
 #endif
 
+#if (CPU(X86) || CPU(X86_64)) && COMPILER(GCC)
+/* All SSE2 intrinsics usage in the filter kernels can be disabled by this macro. */
+#define HAVE_X86_SSE2_INTRINSICS 1
+#endif
+
 /* ==== OS() - underlying operating system; only to be used for mandated low-level services like 
    virtual memory, not to choose a GUI toolkit ==== */
 
@@ -74,6 +74,15 @@ public:
     const bool includeEmptyRules;
 };
 
+ElementRuleCollector::~ElementRuleCollector()
+{
+    StyleResolverStatistics& stats = StyleResolver::statistics();
+    stats.rulesFastRejected += m_rulesFastRejected;
+    stats.rulesMatchedByRuleHash += m_rulesMatchedByRuleHash;
+    stats.compiledSelectorChecks += m_compiledSelectorChecks;
+    stats.interpretedSelectorChecks += m_interpretedSelectorChecks;
+}
+
 StyleResolver::MatchResult& ElementRuleCollector::matchedResult()
 {
     ASSERT(m_mode == SelectorChecker::Mode::ResolvingStyle);
@@ -281,6 +290,7 @@ inline bool ElementRuleCollector::ruleMatches(const RuleData& ruleData, unsigned
     MatchBasedOnRuleHash matchBasedOnRuleHash = ruleData.matchBasedOnRuleHash();
     if (matchBasedOnRuleHash != MatchBasedOnRuleHash::None && m_element.isHTMLElement()) {
         ASSERT_WITH_MESSAGE(m_pseudoStyleRequest.pseudoId == NOPSEUDO, "If we match based on the rule hash while collecting for a particular pseudo element ID, we would add incorrect rules for that pseudo element ID. We should never end in ruleMatches() with a pseudo element if the ruleData cannot match any pseudo element.");
+        ++m_rulesMatchedByRuleHash;
 
         switch (matchBasedOnRuleHash) {
         case MatchBasedOnRuleHash::None:
@@ -323,6 +333,7 @@ inline bool ElementRuleCollector::ruleMatches(const RuleData& ruleData, unsigned
 #if CSS_SELECTOR_JIT_PROFILING
         ruleData.compiledSelectorUsed();
 #endif
+        ++m_compiledSelectorChecks;
         return selectorChecker(&m_element, &specificity);
     }
 #endif // ENABLE(CSS_SELECTOR_JIT)
@@ -342,11 +353,13 @@ inline bool ElementRuleCollector::ruleMatches(const RuleData& ruleData, unsigned
 #if CSS_SELECTOR_JIT_PROFILING
         ruleData.compiledSelectorUsed();
 #endif
+        ++m_compiledSelectorChecks;
         return selectorChecker(&m_element, &context, &specificity);
     }
 #endif // ENABLE(CSS_SELECTOR_JIT)
 
     // Slow path.
+    ++m_interpretedSelectorChecks;
     SelectorChecker selectorChecker(m_element.document());
     return selectorChecker.match(ruleData.selector(), &m_element, context, specificity);
 }
@@ -362,8 +375,10 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleSet::RuleDataVe
         if (!ruleData.canMatchPseudoElement() && m_pseudoStyleRequest.pseudoId != NOPSEUDO)
             continue;
 
-        if (m_canUseFastReject && m_selectorFilter.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes()))
+        if (m_canUseFastReject && m_selectorFilter.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes())) {
+            ++m_rulesFastRejected;
             continue;
+        }
 
         StyleRule* rule = ruleData.rule();
 
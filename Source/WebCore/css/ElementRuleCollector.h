@@ -58,6 +58,7 @@ public:
         , m_canUseFastReject(m_selectorFilter.parentStackIsConsistent(element.parentNode()))
     {
     }
+    ~ElementRuleCollector();
 
     void matchAllRules(bool matchAuthorAndUserStyles, bool includeSMILProperties);
     void matchUARules();
@@ -105,6 +106,12 @@ private:
     SelectorChecker::Mode m_mode;
     bool m_canUseFastReject;
 
+    // Added to StyleResolver::statistics() once, when the collector goes away.
+    unsigned m_rulesFastRejected { 0 };
+    unsigned m_rulesMatchedByRuleHash { 0 };
+    unsigned m_compiledSelectorChecks { 0 };
+    unsigned m_interpretedSelectorChecks { 0 };
+
     std::unique_ptr<Vector<MatchedRule, 32>> m_matchedRules;
 
     // Output.
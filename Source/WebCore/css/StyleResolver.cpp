@@ -66,6 +66,7 @@
 #include "CursorList.h"
 #include "DocumentStyleSheetCollection.h"
 #include "ElementRuleCollector.h"
+#include "ElementTraversal.h"
 #include "FilterOperation.h"
 #include "Frame.h"
 #include "FrameSelection.h"
@@ -138,6 +139,7 @@
 #include "WebKitFontFamilyNames.h"
 #include "XMLNames.h"
 #include <bitset>
+#include <wtf/DataLog.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/TemporaryChange.h>
 #include <wtf/Vector.h>
@@ -282,6 +284,38 @@ void StyleResolver::MatchResult::addMatchedProperties(const StyleProperties& pro
     }
 }
 
+StyleResolverStatistics& StyleResolver::statistics()
+{
+    static NeverDestroyed<StyleResolverStatistics> statistics;
+    return statistics;
+}
+
+void StyleResolverStatistics::reset()
+{
+    elementsResolved = 0;
+    sharedStyleHits = 0;
+    matchedRulesCacheHits = 0;
+    matchedRulesCacheMisses = 0;
+    matchedRulesCacheIneligible = 0;
+    rulesFastRejected = 0;
+    rulesMatchedByRuleHash = 0;
+    compiledSelectorChecks = 0;
+    interpretedSelectorChecks = 0;
+}
+
+void StyleResolverStatistics::dump() const
+{
+    dataLogF("%-30s %13llu\n", "Elements resolved", static_cast<unsigned long long>(elementsResolved));
+    dataLogF("%-30s %13llu\n", "Shared style hits", static_cast<unsigned long long>(sharedStyleHits));
+    dataLogF("%-30s %13llu\n", "Matched rules cache hits", static_cast<unsigned long long>(matchedRulesCacheHits));
+    dataLogF("%-30s %13llu\n", "Matched rules cache misses", static_cast<unsigned long long>(matchedRulesCacheMisses));
+    dataLogF("%-30s %13llu\n", "Matched rules cache ineligible", static_cast<unsigned long long>(matchedRulesCacheIneligible));
+    dataLogF("%-30s %13llu\n", "Rules fast rejected", static_cast<unsigned long long>(rulesFastRejected));
+    dataLogF("%-30s %13llu\n", "Rules matched by rule hash", static_cast<unsigned long long>(rulesMatchedByRuleHash));
+    dataLogF("%-30s %13llu\n", "Compiled selector checks", static_cast<unsigned long long>(compiledSelectorChecks));
+    dataLogF("%-30s %13llu\n\n", "Interpreted selector checks", static_cast<unsigned long long>(interpretedSelectorChecks));
+}
+
 StyleResolver::StyleResolver(Document& document, bool matchAuthorAndUserStyles)
     : m_matchedPropertiesCacheAdditionsSinceLastSweep(0)
     , m_matchedPropertiesCacheSweepTimer(*this, &StyleResolver::sweepMatchedPropertiesCache)
@@ -334,6 +368,7 @@ StyleResolver::StyleResolver(Document& document, bool matchAuthorAndUserStyles)
 void StyleResolver::appendAuthorStyleSheets(unsigned firstNew, const Vector<RefPtr<CSSStyleSheet>>& styleSheets)
 {
     m_ruleSets.appendAuthorStyleSheets(firstNew, styleSheets, m_medium.get(), m_inspectorCSSOMWrappers, this);
+    clearMatchedRulesCache();
     if (auto renderView = document().renderView())
         renderView->style().fontCascade().update(&document().fontSelector());
 
@@ -785,11 +820,15 @@ Ref<RenderStyle> StyleResolver::styleForElement(Element* element, RenderStyle* d
         return *s_styleNotYetAvailable;
     }
 
+    StyleResolverStatistics& stats = statistics();
+    ++stats.elementsResolved;
+
     State& state = m_state;
     initElement(element);
     state.initForStyleResolve(document(), element, defaultParent, regionForStyling);
     if (sharingBehavior == AllowStyleSharing) {
         if (RenderStyle* sharedStyle = locateSharedStyle()) {
+            ++stats.sharedStyleHits;
             state.clear();
             return *sharedStyle;
         }
@@ -816,19 +855,40 @@ Ref<RenderStyle> StyleResolver::styleForElement(Element* element, RenderStyle* d
 
     bool needsCollection = false;
     CSSDefaultStyleSheets::ensureDefaultStyleSheetsForElement(*element, needsCollection);
-    if (needsCollection)
+    if (needsCollection) {
         m_ruleSets.collectFeatures();
+        clearMatchedRulesCache();
+    }
 
-    ElementRuleCollector collector(*element, state.style(), m_ruleSets, m_selectorFilter);
-    collector.setRegionForStyling(regionForStyling);
-    collector.setMedium(m_medium.get());
+    MatchedRulesCacheKey matchedRulesCacheKey;
+    bool usesMatchedRulesCache = false;
+    if (sharingBehavior == AllowStyleSharing && matchingBehavior == MatchAllRules && !regionForStyling && m_matchedRulesCacheEnabled) {
+        usesMatchedRulesCache = computeMatchedRulesCacheKey(*element, matchedRulesCacheKey);
+        if (!usesMatchedRulesCache)
+            ++stats.matchedRulesCacheIneligible;
+    }
 
-    if (matchingBehavior == MatchOnlyUserAgentRules)
-        collector.matchUARules();
-    else
-        collector.matchAllRules(m_matchAuthorAndUserStyles, matchingBehavior != MatchAllRulesExcludingSMIL);
+    MatchResult cachedMatchResult;
+    if (usesMatchedRulesCache && findFromMatchedRulesCache(matchedRulesCacheKey, *element, cachedMatchResult)) {
+        ++stats.matchedRulesCacheHits;
+        applyMatchedProperties(cachedMatchResult, element);
+    } else {
+        ElementRuleCollector collector(*element, state.style(), m_ruleSets, m_selectorFilter);
+        collector.setRegionForStyling(regionForStyling);
+        collector.setMedium(m_medium.get());
 
-    applyMatchedProperties(collector.matchedResult(), element);
+        if (matchingBehavior == MatchOnlyUserAgentRules)
+            collector.matchUARules();
+        else
+            collector.matchAllRules(m_matchAuthorAndUserStyles, matchingBehavior != MatchAllRulesExcludingSMIL);
+
+        if (usesMatchedRulesCache) {
+            ++stats.matchedRulesCacheMisses;
+            addToMatchedRulesCache(matchedRulesCacheKey, *element, collector.matchedResult());
+        }
+
+        applyMatchedProperties(collector.matchedResult(), element);
+    }
 
     // Clean up our style object's display and text decorations (among other fixups).
     adjustRenderStyle(*state.style(), *state.parentStyle(), element);
@@ -836,6 +896,8 @@ Ref<RenderStyle> StyleResolver::styleForElement(Element* element, RenderStyle* d
     if (state.style()->hasViewportUnits())
         document().setHasStyleWithViewportUnits();
 
+    m_styleDataInterner.intern(*state.style());
+
     state.clear(); // Clear out for the next resolve.
 
     // Now return the style.
@@ -1661,6 +1723,7 @@ void StyleResolver::addToMatchedPropertiesCache(const RenderStyle* style, const
 void StyleResolver::invalidateMatchedPropertiesCache()
 {
     m_matchedPropertiesCache.clear();
+    clearMatchedRulesCache();
 }
 
 void StyleResolver::clearCachedPropertiesAffectedByViewportUnits()
@@ -1674,6 +1737,194 @@ void StyleResolver::clearCachedPropertiesAffectedByViewportUnits()
         m_matchedPropertiesCache.remove(key);
 }
 
+void StyleResolver::setMatchedRulesCacheEnabled(bool enabled)
+{
+    if (!enabled)
+        clearMatchedRulesCache();
+    m_matchedRulesCacheEnabled = enabled;
+}
+
+void StyleResolver::clearMatchedRulesCache()
+{
+    m_matchedRulesCache.clear();
+    m_matchedRulesCacheParents.clear();
+}
+
+static inline bool childPositionAffectsMatching(const Element& parent)
+{
+    return parent.childrenAffectedByFirstChildRules()
+        || parent.childrenAffectedByLastChildRules()
+        || parent.childrenAffectedByBackwardPositionalRules()
+        || parent.childrenAffectedByPropertyBasedBackwardPositionalRules();
+}
+
+static inline bool positionAffectsMatching(const Element& element)
+{
+    if (element.styleIsAffectedByPreviousSibling() || element.styleAffectedByEmpty())
+        return true;
+    Element* parent = element.parentElement();
+    return parent && childPositionAffectsMatching(*parent);
+}
+
+bool StyleResolver::computeMatchedRulesCacheKey(Element& element, MatchedRulesCacheKey& key)
+{
+    if (!m_matchedRulesCacheEnabled || InspectorInstrumentation::hasFrontends())
+        return false;
+    if (!is<StyledElement>(element) || element.isSVGElement() || element.isInShadowTree() || element.isLink())
+        return false;
+    StyledElement& styledElement = downcast<StyledElement>(element);
+    if (styledElement.inlineStyle() || elementHasDirectionAuto(&element))
+        return false;
+    // These elements match pseudo classes whose state is not part of the key.
+    if (is<HTMLFormControlElement>(element) || is<HTMLOptionElement>(element) || is<HTMLOptGroupElement>(element) || is<HTMLProgressElement>(element))
+        return false;
+#if ENABLE(VIDEO_TRACK)
+    if (is<WebVTTElement>(element))
+        return false;
+#endif
+#if ENABLE(FULLSCREEN_API)
+    if (element.containsFullScreenElement() || &element == element.document().webkitCurrentFullScreenElement())
+        return false;
+#endif
+
+    Element* parent = element.parentElement();
+    if (!parent || positionAffectsMatching(element))
+        return false;
+
+    // Children of elements that matched through the cache are keyed by the matched item, otherwise by the parent itself.
+    auto parentInfo = m_matchedRulesCacheParents.find(parent);
+    if (parentInfo != m_matchedRulesCacheParents.end()) {
+        Element& matchingElement = *parentInfo->value.matchingElement;
+        if (&matchingElement != parent) {
+            // The descendants of the element that produced the item may have evaluated its position or marked it.
+            if (positionAffectsMatching(matchingElement))
+                return false;
+            if (matchingElement.childrenAffectedByHover())
+                parent->setChildrenAffectedByHover();
+            if (matchingElement.childrenAffectedByActive())
+                parent->setChildrenAffectedByActive();
+            if (matchingElement.childrenAffectedByDrag())
+                parent->setChildrenAffectedByDrag();
+        }
+        key.append(nullptr);
+        key.append(reinterpret_cast<const void*>(static_cast<uintptr_t>(parentInfo->value.identifier)));
+    } else {
+        key.append(reinterpret_cast<const void*>(1));
+        key.append(parent);
+    }
+
+    unsigned stateFlags = 0;
+    if (element.hovered())
+        stateFlags |= 1 << 0;
+    if (element.active())
+        stateFlags |= 1 << 1;
+    if (SelectorChecker::matchesFocusPseudoClass(&element))
+        stateFlags |= 1 << 2;
+    if (&element == element.document().cssTarget())
+        stateFlags |= 1 << 3;
+    if (element.matchesReadWritePseudoClass())
+        stateFlags |= 1 << 4;
+    if (element.renderer() && element.renderer()->isDragging())
+        stateFlags |= 1 << 5;
+    key.append(reinterpret_cast<const void*>(static_cast<uintptr_t>(stateFlags)));
+
+    key.append(element.tagQName().localName().impl());
+    key.append(element.tagQName().namespaceURI().impl());
+    key.append(styledElement.presentationAttributeStyle());
+    key.append(styledElement.additionalPresentationAttributeStyle());
+
+    if (element.hasID() && hasSelectorForId(element.idForStyleResolution()))
+        key.append(element.idForStyleResolution().impl());
+    key.append(nullptr);
+    if (element.hasClass()) {
+        const SpaceSplitString& classNames = element.classNames();
+        for (unsigned i = 0; i < classNames.size(); ++i) {
+            if (m_ruleSets.features().classesInRules.contains(classNames[i].impl()))
+                key.append(classNames[i].impl());
+        }
+    }
+    key.append(nullptr);
+    if (element.hasAttributesWithoutUpdate()) {
+        for (const Attribute& attribute : element.attributesIterator()) {
+            const QualifiedName& name = attribute.name();
+            if (name == langAttr || name == XMLNames::langAttr || hasSelectorForAttribute(element, name.localName())) {
+                key.append(name.localName().impl());
+                key.append(name.namespaceURI().impl());
+                key.append(attribute.value().impl());
+            }
+        }
+    }
+    return true;
+}
+
+bool StyleResolver::findFromMatchedRulesCache(const MatchedRulesCacheKey& key, Element& element, MatchResult& matchResult)
+{
+    unsigned hash = StringHasher::hashMemory(key.data(), key.size() * sizeof(const void*));
+    auto it = m_matchedRulesCache.find(hash);
+    if (it == m_matchedRulesCache.end() || it->value.key != key)
+        return false;
+
+    MatchedRulesCacheItem& cacheItem = it->value;
+    // Items keyed by the parent element itself are only valid while the matching element still has that parent.
+    if (key[0] && cacheItem.element->parentElement() != key[1])
+        return false;
+
+    for (size_t i = 0; i < cacheItem.matchedProperties.size(); ++i) {
+        const MatchedProperties& matchedProperties = cacheItem.matchedProperties[i];
+        matchResult.addMatchedProperties(*matchedProperties.properties, cacheItem.matchedRules[i], matchedProperties.linkMatchType, static_cast<PropertyWhitelistType>(matchedProperties.whitelistType));
+    }
+    matchResult.ranges = cacheItem.ranges;
+    matchResult.isCacheable = matchResult.isCacheable && cacheItem.isCacheable;
+
+    // Replay the flags selector matching would have set on the style.
+    RenderStyle& style = *m_state.style();
+    if (cacheItem.pseudoStyles)
+        style.setHasPseudoStyles(cacheItem.pseudoStyles);
+    if (cacheItem.affectedByHover)
+        style.setAffectedByHover();
+    if (cacheItem.affectedByActive)
+        style.setAffectedByActive();
+    if (cacheItem.affectedByDrag)
+        style.setAffectedByDrag();
+
+    if (ElementTraversal::firstChild(element))
+        m_matchedRulesCacheParents.set(&element, MatchedRulesCacheParentInfo { cacheItem.identifier, cacheItem.element });
+    return true;
+}
+
+void StyleResolver::addToMatchedRulesCache(const MatchedRulesCacheKey& key, Element& element, const MatchResult& matchResult)
+{
+    static const unsigned maximumMatchedRulesCacheSize = 4096;
+
+    const RenderStyle& style = *m_state.style();
+    if (style.unique() || positionAffectsMatching(element))
+        return;
+    if (m_matchedRulesCache.size() >= maximumMatchedRulesCacheSize)
+        return;
+
+    MatchedRulesCacheItem cacheItem;
+    cacheItem.key = key;
+    cacheItem.identifier = ++m_matchedRulesCacheIdentifier;
+    cacheItem.element = &element;
+    cacheItem.matchedProperties.appendVector(matchResult.matchedProperties());
+    cacheItem.matchedRules.appendVector(matchResult.matchedRules);
+    cacheItem.ranges = matchResult.ranges;
+    cacheItem.isCacheable = matchResult.isCacheable;
+    for (PseudoId pseudoId = FIRST_PUBLIC_PSEUDOID; pseudoId < FIRST_INTERNAL_PSEUDOID; pseudoId = static_cast<PseudoId>(pseudoId + 1)) {
+        if (style.hasPseudoStyle(pseudoId))
+            cacheItem.pseudoStyles.add(pseudoId);
+    }
+    cacheItem.affectedByHover = style.affectedByHover();
+    cacheItem.affectedByActive = style.affectedByActive();
+    cacheItem.affectedByDrag = style.affectedByDrag();
+
+    if (ElementTraversal::firstChild(element))
+        m_matchedRulesCacheParents.set(&element, MatchedRulesCacheParentInfo { cacheItem.identifier, &element });
+
+    unsigned hash = StringHasher::hashMemory(key.data(), key.size() * sizeof(const void*));
+    m_matchedRulesCache.set(hash, WTF::move(cacheItem));
+}
+
 static bool isCacheableInMatchedPropertiesCache(const Element* element, const RenderStyle* style, const RenderStyle* parentStyle)
 {
     // FIXME: CSSPropertyWebkitWritingMode modifies state when applying to document element. We can't skip the applying by caching.
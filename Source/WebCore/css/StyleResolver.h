@@ -37,6 +37,7 @@
 #include "ScrollTypes.h"
 #include "SelectorChecker.h"
 #include "SelectorFilter.h"
+#include "StyleDataInterner.h"
 #include "StyleInheritedData.h"
 #include "ViewportStyleResolver.h"
 #include <memory>
@@ -135,6 +136,24 @@ public:
     RenderScrollbar* scrollbar;
 };
 
+// Counters for the style resolution fast paths. Only touched on the main thread.
+struct StyleResolverStatistics {
+    StyleResolverStatistics() { reset(); }
+
+    void reset();
+    void dump() const;
+
+    uint64_t elementsResolved;
+    uint64_t sharedStyleHits;
+    uint64_t matchedRulesCacheHits;
+    uint64_t matchedRulesCacheMisses;
+    uint64_t matchedRulesCacheIneligible;
+    uint64_t rulesFastRejected;
+    uint64_t rulesMatchedByRuleHash;
+    uint64_t compiledSelectorChecks;
+    uint64_t interpretedSelectorChecks;
+};
+
 // This class selects a RenderStyle for a given element based on a collection of stylesheets.
 class StyleResolver {
     WTF_MAKE_NONCOPYABLE(StyleResolver); WTF_MAKE_FAST_ALLOCATED;
@@ -173,6 +192,16 @@ public:
 
     const MediaQueryEvaluator& mediaQueryEvaluator() const { return *m_medium; }
 
+    static StyleResolverStatistics& statistics();
+
+    // The matched rules cache is only valid while the DOM and the rule sets are frozen, so it is
+    // enabled for the duration of a single style recalc pass.
+    void setMatchedRulesCacheEnabled(bool);
+    void clearMatchedRulesCache();
+
+    const StyleDataInterner& styleDataInterner() const { return m_styleDataInterner; }
+    void clearStyleDataInterner() { m_styleDataInterner.clear(); }
+
 private:
     void initElement(Element*);
     RenderStyle* locateSharedStyle();
@@ -499,6 +528,31 @@ private:
     // the last reference to a style declaration are garbage collected.
     void sweepMatchedPropertiesCache();
 
+    // Elements that have the same tag, the same rule-relevant classes, id, attributes and
+    // dynamic state, and whose parents matched the same rules (or are the same element), match
+    // the same set of rules. This cache reuses that result for elements that cannot share style.
+    typedef Vector<const void*, 16> MatchedRulesCacheKey;
+    struct MatchedRulesCacheItem {
+        MatchedRulesCacheKey key;
+        unsigned identifier;
+        RefPtr<Element> element;
+        Vector<MatchedProperties> matchedProperties;
+        Vector<StyleRule*> matchedRules;
+        MatchRanges ranges;
+        bool isCacheable;
+        PseudoIdSet pseudoStyles;
+        bool affectedByHover;
+        bool affectedByActive;
+        bool affectedByDrag;
+    };
+    struct MatchedRulesCacheParentInfo {
+        unsigned identifier;
+        RefPtr<Element> matchingElement;
+    };
+    bool computeMatchedRulesCacheKey(Element&, MatchedRulesCacheKey&);
+    bool findFromMatchedRulesCache(const MatchedRulesCacheKey&, Element&, MatchResult&);
+    void addToMatchedRulesCache(const MatchedRulesCacheKey&, Element&, const MatchResult&);
+
     bool classNamesAffectedByRules(const SpaceSplitString&) const;
     bool sharingCandidateHasIdenticalStyleAffectingAttributes(StyledElement*) const;
 
@@ -509,6 +563,14 @@ private:
 
     Timer m_matchedPropertiesCacheSweepTimer;
 
+    typedef HashMap<unsigned, MatchedRulesCacheItem> MatchedRulesCache;
+    MatchedRulesCache m_matchedRulesCache;
+    HashMap<RefPtr<Element>, MatchedRulesCacheParentInfo> m_matchedRulesCacheParents;
+    unsigned m_matchedRulesCacheIdentifier { 0 };
+    bool m_matchedRulesCacheEnabled { false };
+
+    StyleDataInterner m_styleDataInterner;
+
     std::unique_ptr<MediaQueryEvaluator> m_medium;
     RefPtr<RenderStyle> m_rootDefaultStyle;
 
@@ -134,7 +134,7 @@ public:
     bool isMutable() const { return m_isMutable; }
     void setMutable() { m_isMutable = true; }
 
-    bool isInMemoryCache() const { return m_isInMemoryCache; }
+    bool isInMemoryCache() const { return m_inMemoryCacheCount; }
     void addedToMemoryCache();
     void removedFromMemoryCache();
 
@@ -163,8 +163,10 @@ private:
     bool m_usesRemUnits : 1;
     bool m_usesStyleBasedEditability : 1;
     bool m_isMutable : 1;
-    bool m_isInMemoryCache : 1;
-    
+
+    // A parsed sheet can be held by several CachedCSSStyleSheets and the StyleSheetContentsCache.
+    unsigned m_inMemoryCacheCount { 0 };
+
     CSSParserContext m_parserContext;
 
     Vector<CSSStyleSheet*> m_clients;
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StyleSheetContentsCache.h"
+
+#include "CSSParserMode.h"
+#include "SharedBuffer.h"
+#include "StyleSheetContents.h"
+#include <wtf/DataLog.h>
+#include <wtf/MainThread.h>
+#include <wtf/SHA1.h>
+#include <wtf/text/CString.h>
+
+namespace WebCore {
+
+static const unsigned defaultCapacity = 16 * 1024 * 1024;
+
+StyleSheetContentsCache& StyleSheetContentsCache::singleton()
+{
+    ASSERT(WTF::isMainThread());
+    static NeverDestroyed<StyleSheetContentsCache> cache;
+    return cache;
+}
+
+StyleSheetContentsCache::StyleSheetContentsCache()
+    : m_capacity(defaultCapacity)
+{
+}
+
+String StyleSheetContentsCache::computeKey(const SharedBuffer& data, const String& encoding)
+{
+    SHA1 sha1;
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    sha1.addBytes(encoding.utf8());
+    return sha1.computeHexDigest().data();
+}
+
+RefPtr<StyleSheetContents> StyleSheetContentsCache::find(const String& key, const CSSParserContext& context)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    for (auto& entry : it->value) {
+        if (entry->contents->parserContext() != context)
+            continue;
+        if (entry->contents->hasFailedOrCanceledSubresources())
+            break;
+        m_lruList.appendOrMoveToLast(entry.get());
+        ++m_hits;
+        return entry->contents;
+    }
+    ++m_misses;
+    return nullptr;
+}
+
+void StyleSheetContentsCache::add(const String& key, StyleSheetContents& contents)
+{
+    ASSERT(contents.isCacheable());
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        for (auto& entry : it->value) {
+            if (entry->contents->parserContext() != contents.parserContext())
+                continue;
+            if (entry->contents == &contents)
+                return;
+            remove(entry.get());
+            break;
+        }
+    }
+
+    unsigned size = contents.estimatedSizeInBytes();
+    if (size > m_capacity / 2)
+        return;
+
+    auto entry = std::make_unique<Entry>(Entry { key, &contents, size });
+    contents.addedToMemoryCache();
+    m_lruList.add(entry.get());
+    m_size += size;
+    m_entries.add(key, Vector<std::unique_ptr<Entry>, 1>()).iterator->value.append(WTF::move(entry));
+
+    prune();
+}
+
+void StyleSheetContentsCache::remove(Entry* entry)
+{
+    m_lruList.remove(entry);
+    entry->contents->removedFromMemoryCache();
+    m_size -= entry->size;
+
+    auto it = m_entries.find(entry->key);
+    ASSERT(it != m_entries.end());
+    it->value.removeFirstMatching([entry] (const std::unique_ptr<Entry>& current) {
+        return current.get() == entry;
+    });
+    if (it->value.isEmpty())
+        m_entries.remove(it);
+}
+
+void StyleSheetContentsCache::prune()
+{
+    while (m_size > m_capacity && !m_lruList.isEmpty())
+        remove(m_lruList.first());
+}
+
+void StyleSheetContentsCache::setCapacity(unsigned bytes)
+{
+    m_capacity = bytes;
+    prune();
+}
+
+void StyleSheetContentsCache::clear()
+{
+    for (auto& entries : m_entries.values()) {
+        for (auto& entry : entries)
+            entry->contents->removedFromMemoryCache();
+    }
+    m_entries.clear();
+    m_lruList.clear();
+    m_size = 0;
+}
+
+void StyleSheetContentsCache::dumpStats() const
+{
+    unsigned count = 0;
+    for (auto& entries : m_entries.values())
+        count += entries.size();
+
+    dataLogF("%-13s %-13s %-13s %-13s %-13s\n", "", "Count", "Size", "Hits", "Misses");
+    dataLogF("%-13s %13u %13u %13u %13u\n\n", "Parsed CSS", count, m_size, m_hits, m_misses);
+}
+
+} // namespace WebCore
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef StyleSheetContentsCache_h
+#define StyleSheetContentsCache_h
+
+#include <memory>
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+class SharedBuffer;
+class StyleSheetContents;
+struct CSSParserContext;
+
+// Keeps parsed author style sheets keyed by a digest of their bytes and encoding, so
+// byte-identical sheets are parsed once per process even after the CachedCSSStyleSheet
+// holding the parse has been evicted from the memory cache or loaded again.
+class StyleSheetContentsCache {
+    WTF_MAKE_NONCOPYABLE(StyleSheetContentsCache); WTF_MAKE_FAST_ALLOCATED;
+    friend NeverDestroyed<StyleSheetContentsCache>;
+public:
+    WEBCORE_EXPORT static StyleSheetContentsCache& singleton();
+
+    static String computeKey(const SharedBuffer&, const String& encoding);
+
+    // Contexts must be identical so we know we would get the same exact result if we parsed again.
+    RefPtr<StyleSheetContents> find(const String& key, const CSSParserContext&);
+    void add(const String& key, StyleSheetContents&);
+
+    WEBCORE_EXPORT void setCapacity(unsigned bytes);
+    WEBCORE_EXPORT void clear();
+
+    WEBCORE_EXPORT void dumpStats() const;
+
+private:
+    StyleSheetContentsCache();
+
+    struct Entry {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        String key;
+        RefPtr<StyleSheetContents> contents;
+        unsigned size;
+    };
+
+    void remove(Entry*);
+    void prune();
+
+    HashMap<String, Vector<std::unique_ptr<Entry>, 1>> m_entries;
+    ListHashSet<Entry*> m_lruList; // Least recently used first.
+    unsigned m_size { 0 };
+    unsigned m_capacity;
+    unsigned m_hits { 0 };
+    unsigned m_misses { 0 };
+};
+
+} // namespace WebCore
+
+#endif // StyleSheetContentsCache_h
@@ -35,6 +35,7 @@
 #include "MemoryCache.h"
 #include "SharedBuffer.h"
 #include "StyleSheetContents.h"
+#include "StyleSheetContentsCache.h"
 #include "TextResourceDecoder.h"
 #include <wtf/CurrentTime.h>
 #include <wtf/Vector.h>
@@ -71,6 +72,7 @@ void CachedCSSStyleSheet::didAddClient(CachedResourceClient* c)
 void CachedCSSStyleSheet::setEncoding(const String& chs)
 {
     m_decoder->setEncoding(chs, TextResourceDecoder::EncodingFromHTTPHeader);
+    m_contentKey = String();
 }
 
 String CachedCSSStyleSheet::encoding() const
@@ -93,6 +95,7 @@ const String CachedCSSStyleSheet::sheetText(bool* hasValidMIMEType) const
 void CachedCSSStyleSheet::finishLoading(SharedBuffer* data)
 {
     m_data = data;
+    m_contentKey = String();
     setEncodedSize(data ? data->size() : 0);
     // Decode the data to find out the encoding and keep the sheet text around during checkNotify()
     if (data)
@@ -145,8 +148,15 @@ void CachedCSSStyleSheet::destroyDecodedData()
 
 PassRefPtr<StyleSheetContents> CachedCSSStyleSheet::restoreParsedStyleSheet(const CSSParserContext& context)
 {
-    if (!m_parsedStyleSheetCache)
-        return 0;
+    if (!m_parsedStyleSheetCache) {
+        if (!m_data || m_data->isEmpty() || !canUseSheet(nullptr))
+            return 0;
+        RefPtr<StyleSheetContents> sheet = StyleSheetContentsCache::singleton().find(contentKey(), context);
+        if (!sheet)
+            return 0;
+        saveParsedStyleSheet(sheet.releaseNonNull());
+        return m_parsedStyleSheetCache;
+    }
     if (m_parsedStyleSheetCache->hasFailedOrCanceledSubresources()) {
         m_parsedStyleSheetCache->removedFromMemoryCache();
         m_parsedStyleSheetCache.clear();
@@ -175,6 +185,17 @@ void CachedCSSStyleSheet::saveParsedStyleSheet(Ref<StyleSheetContents>&& sheet)
     m_parsedStyleSheetCache->addedToMemoryCache();
 
     setDecodedSize(m_parsedStyleSheetCache->estimatedSizeInBytes());
+
+    if (m_data && !m_data->isEmpty())
+        StyleSheetContentsCache::singleton().add(contentKey(), *m_parsedStyleSheetCache);
+}
+
+const String& CachedCSSStyleSheet::contentKey()
+{
+    ASSERT(m_data);
+    if (m_contentKey.isNull())
+        m_contentKey = StyleSheetContentsCache::computeKey(*m_data, encoding());
+    return m_contentKey;
 }
 
 }
@@ -48,6 +48,7 @@ namespace WebCore {
 
     private:
         bool canUseSheet(bool* hasValidMIMEType) const;
+        const String& contentKey();
         virtual bool mayTryReplaceEncodedData() const override { return true; }
 
         virtual void didAddClient(CachedResourceClient*) override;
@@ -62,6 +63,7 @@ namespace WebCore {
 
         RefPtr<TextResourceDecoder> m_decoder;
         String m_decodedSheetText;
+        String m_contentKey;
 
         RefPtr<StyleSheetContents> m_parsedStyleSheetCache;
     };
@@ -36,11 +36,26 @@
 #include "Page.h"
 #include "PageCache.h"
 #include "ScrollingThread.h"
+#include "ShadowBlur.h"
+#include "StyleResolver.h"
+#include "StyleSheetContentsCache.h"
 #include "WorkerThread.h"
 #include <wtf/CurrentTime.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/StdLibExtras.h>
 
+#if USE(CAIRO)
+#include "CairoGlyphCache.h"
+#endif
+
+#if USE(FREETYPE)
+#include "FontConfigCache.h"
+#endif
+
+#if USE(HARFBUZZ)
+#include "HarfBuzzShapeCache.h"
+#endif
+
 namespace WebCore {
 
 WEBCORE_EXPORT bool MemoryPressureHandler::ReliefLogger::s_loggingEnabled = false;
@@ -62,7 +77,15 @@ MemoryPressureHandler::MemoryPressureHandler()
     , m_clearPressureOnMemoryRelease(true)
     , m_releaseMemoryBlock(0)
     , m_observer(0)
-#elif OS(LINUX) && !PLATFORM(FLTK)
+#elif PLATFORM(FLTK)
+    , m_threadID(0)
+    , m_wakeUpFD(-1)
+    , m_holdOffTimer(*this, &MemoryPressureHandler::holdOffTimerFired)
+    , m_stopMonitoring(false)
+    , m_awaitingResponse(false)
+    , m_nonCriticalPercent(15)
+    , m_criticalPercent(5)
+#elif OS(LINUX)
     , m_eventFD(0)
     , m_pressureLevelFD(0)
     , m_threadID(0)
@@ -83,12 +106,46 @@ void MemoryPressureHandler::releaseNoncriticalMemory()
         clearWidthCaches();
     }
 
+    {
+        ReliefLogger log("Clear shadow template cache");
+        ShadowBlur::clearTemplateCache();
+    }
+
+#if USE(CAIRO)
+    {
+        ReliefLogger log("Clear glyph mask cache");
+        CairoGlyphCache::singleton().clear();
+    }
+#endif
+
+#if USE(FREETYPE)
+    {
+        ReliefLogger log("Clear fontconfig cache");
+        FontConfigCache::singleton().clear();
+    }
+#endif
+
+#if USE(HARFBUZZ)
+    {
+        ReliefLogger log("Clear HarfBuzz shape cache");
+        HarfBuzzShapeCache::singleton().clear();
+    }
+#endif
+
     {
         ReliefLogger log("Discard Selector Query Cache");
         for (auto* document : Document::allDocuments())
             document->clearSelectorQueryCache();
     }
 
+    {
+        ReliefLogger log("Clear style data interners");
+        for (auto* document : Document::allDocuments()) {
+            if (StyleResolver* resolver = document->styleResolverIfExists())
+                resolver->clearStyleDataInterner();
+        }
+    }
+
     {
         ReliefLogger log("Clearing JS string cache");
         JSDOMWindow::commonVM().stringCache.clear();
@@ -119,6 +176,11 @@ void MemoryPressureHandler::releaseCriticalMemory()
         cssValuePool().drain();
     }
 
+    {
+        ReliefLogger log("Drop parsed style sheet cache");
+        StyleSheetContentsCache::singleton().clear();
+    }
+
     {
         ReliefLogger log("Discard StyleResolvers");
         for (auto* document : Document::allDocuments())
@@ -156,7 +218,7 @@ void MemoryPressureHandler::releaseMemory(bool critical)
     }
 }
 
-#if !PLATFORM(COCOA) && (!OS(LINUX) || PLATFORM(FLTK))
+#if !PLATFORM(COCOA) && !OS(LINUX)
 void MemoryPressureHandler::install() { }
 void MemoryPressureHandler::uninstall() { }
 void MemoryPressureHandler::holdOff(unsigned) { }
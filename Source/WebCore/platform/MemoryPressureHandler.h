@@ -75,6 +75,11 @@ public:
     WEBCORE_EXPORT void clearMemoryPressure();
     WEBCORE_EXPORT bool shouldWaitForMemoryClearMessage();
     void respondToMemoryPressureIfNeeded();
+#elif PLATFORM(FLTK)
+    // Pressure is signaled when the memory still available falls below these percentages
+    // of the cgroup memory limit, or of MemTotal when the process is not in a limited cgroup.
+    WEBCORE_EXPORT void setThresholds(unsigned nonCriticalPercent, unsigned criticalPercent);
+    static void monitorMemoryPressure(void*);
 #elif OS(LINUX)
     static void waitForMemoryPressureEvent(void*);
 #endif
@@ -135,7 +140,16 @@ private:
     void (^m_releaseMemoryBlock)();
     CFRunLoopObserverRef m_observer;
     Mutex m_observerMutex;
-#elif OS(LINUX) && !PLATFORM(FLTK)
+#elif PLATFORM(FLTK)
+    WTF::ThreadIdentifier m_threadID;
+    int m_wakeUpFD;
+    Timer m_holdOffTimer;
+    void holdOffTimerFired();
+    std::atomic<bool> m_stopMonitoring;
+    std::atomic<bool> m_awaitingResponse;
+    std::atomic<unsigned> m_nonCriticalPercent;
+    std::atomic<unsigned> m_criticalPercent;
+#elif OS(LINUX)
     int m_eventFD;
     int m_pressureLevelFD;
     WTF::ThreadIdentifier m_threadID;
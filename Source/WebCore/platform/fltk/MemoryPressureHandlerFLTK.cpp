@@ -0,0 +1,419 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MemoryPressureHandler.h"
+
+#if PLATFORM(FLTK) && OS(LINUX)
+
+#include "GCController.h"
+#include "Logging.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// Same throttling as the generic Linux handler: after responding, ignore
+// pressure for at least s_minimumHoldOffTime seconds, or s_holdOffMultiplier
+// times as long as the cleanup took.
+static const unsigned s_minimumHoldOffTime = 5;
+static const unsigned s_holdOffMultiplier = 20;
+
+// Available memory is sampled this often (ms) between kernel notifications.
+static const int s_pollInterval = 1000;
+
+// PSI triggers: stall time in us within a window in us. Unprivileged
+// triggers need a window that is a multiple of two seconds.
+static const char* s_nonCriticalTrigger = "some 150000 2000000";
+static const char* s_criticalTrigger = "full 100000 2000000";
+
+enum class PressureLevel {
+	None,
+	NonCritical,
+	Critical
+};
+
+// Parses "key value" lines. The separator is a space in cgroup files and
+// /proc/meminfo, but a tab in /proc/self/status.
+static bool parseKeyedValue(const char *line, const char *key, uint64_t &value)
+{
+	const size_t keyLength = strlen(key);
+	if (strncmp(line, key, keyLength) || (line[keyLength] != ' ' && line[keyLength] != '\t'))
+		return false;
+
+	unsigned long long parsed;
+	if (sscanf(line + keyLength, "%llu", &parsed) != 1)
+		return false;
+	value = parsed;
+	return true;
+}
+
+static bool readKeyedValue(const char *path, const char *key, uint64_t &value)
+{
+	FILE *file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	char line[256];
+	bool found = false;
+	while (!found && fgets(line, sizeof(line), file))
+		found = parseKeyedValue(line, key, value);
+
+	fclose(file);
+	return found;
+}
+
+// Reads a single-value cgroup file. "max" means no limit and is treated as missing.
+static bool readValue(const char *path, uint64_t &value)
+{
+	FILE *file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	unsigned long long parsed;
+	const bool found = fscanf(file, "%llu", &parsed) == 1;
+	fclose(file);
+
+	if (found)
+		value = parsed;
+	return found;
+}
+
+// The cgroup v2 directory of this process, or a null string outside the unified hierarchy.
+static String cgroupDirectory()
+{
+	FILE *file = fopen("/proc/self/cgroup", "r");
+	if (!file)
+		return String();
+
+	char line[512];
+	String directory;
+	while (fgets(line, sizeof(line), file)) {
+		if (strncmp(line, "0::", 3))
+			continue;
+		line[strcspn(line, "\n")] = 0;
+		directory = String("/sys/fs/cgroup") + String(line + 3);
+		break;
+	}
+	fclose(file);
+
+	if (directory.isNull() || access(directory.utf8().data(), R_OK))
+		return String();
+	return directory;
+}
+
+static bool availableMemory(const String &cgroup, uint64_t &total, uint64_t &available)
+{
+	if (!cgroup.isNull()) {
+		uint64_t limit, current, inactiveFile = 0;
+		if (readValue((cgroup + "/memory.max").utf8().data(), limit)
+			&& readValue((cgroup + "/memory.current").utf8().data(), current)) {
+			// Inactive page cache is reclaimed before the limit is hit.
+			readKeyedValue((cgroup + "/memory.stat").utf8().data(), "inactive_file", inactiveFile);
+			const uint64_t used = current > inactiveFile ? current - inactiveFile : 0;
+			total = limit;
+			available = limit > used ? limit - used : 0;
+			return true;
+		}
+	}
+
+	if (!readKeyedValue("/proc/meminfo", "MemTotal:", total)
+		|| !readKeyedValue("/proc/meminfo", "MemAvailable:", available))
+		return false;
+	return true;
+}
+
+static int openTrigger(const String &cgroup, const char *trigger)
+{
+	int fd = -1;
+	if (!cgroup.isNull())
+		fd = open((cgroup + "/memory.pressure").utf8().data(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0)
+		fd = open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0)
+		return -1;
+
+	if (write(fd, trigger, strlen(trigger) + 1) < 0) {
+		LOG(MemoryPressure, "Failed to set PSI trigger \"%s\", error : %m", trigger);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+struct MemoryEvents {
+	uint64_t high { 0 };
+	uint64_t max { 0 };
+	uint64_t oom { 0 };
+};
+
+// Reads the counters through the descriptor that is polled: kernfs keeps
+// reporting POLLPRI until that descriptor has been read again, so it is
+// rewound and drained to EOF on every wakeup.
+static void readMemoryEvents(int fd, MemoryEvents &events)
+{
+	if (lseek(fd, 0, SEEK_SET) < 0)
+		return;
+
+	char contents[1024];
+	size_t length = 0;
+	for (;;) {
+		char chunk[256];
+		const ssize_t bytes = read(fd, chunk, sizeof(chunk));
+		if (bytes < 0 && errno == EINTR)
+			continue;
+		if (bytes <= 0)
+			break;
+		const size_t copied = std::min(static_cast<size_t>(bytes), sizeof(contents) - 1 - length);
+		memcpy(contents + length, chunk, copied);
+		length += copied;
+	}
+	contents[length] = 0;
+
+	for (char *line = strtok(contents, "\n"); line; line = strtok(nullptr, "\n")) {
+		if (!parseKeyedValue(line, "high", events.high)
+			&& !parseKeyedValue(line, "max", events.max))
+			parseKeyedValue(line, "oom", events.oom);
+	}
+}
+
+void MemoryPressureHandler::monitorMemoryPressure(void*)
+{
+	ASSERT(!isMainThread());
+	MemoryPressureHandler &handler = MemoryPressureHandler::singleton();
+
+	const String cgroup = cgroupDirectory();
+	const int nonCriticalFD = openTrigger(cgroup, s_nonCriticalTrigger);
+	const int criticalFD = openTrigger(cgroup, s_criticalTrigger);
+	int eventsFD = -1;
+	MemoryEvents lastEvents;
+	if (!cgroup.isNull()) {
+		eventsFD = open((cgroup + "/memory.events").utf8().data(), O_RDONLY | O_CLOEXEC);
+		if (eventsFD >= 0)
+			readMemoryEvents(eventsFD, lastEvents);
+	}
+
+	if (nonCriticalFD < 0 && criticalFD < 0 && eventsFD < 0)
+		LOG(MemoryPressure, "No PSI or cgroup notifications, polling /proc/meminfo only.");
+
+	while (!handler.m_stopMonitoring) {
+		// uninstall() signals the wake-up descriptor so that it does not have to
+		// wait out the poll interval before joining this thread.
+		struct pollfd fds[4];
+		fds[0].fd = handler.m_wakeUpFD;
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+		nfds_t count = 1;
+		for (int fd : { nonCriticalFD, criticalFD, eventsFD }) {
+			if (fd < 0)
+				continue;
+			fds[count].fd = fd;
+			fds[count].events = POLLPRI;
+			fds[count].revents = 0;
+			count++;
+		}
+
+		if (poll(fds, count, s_pollInterval) < 0 && errno != EINTR) {
+			LOG(MemoryPressure, "poll() failed: %m");
+			sleep(1);
+		}
+
+		if (handler.m_stopMonitoring)
+			break;
+
+		PressureLevel level = PressureLevel::None;
+		for (nfds_t i = 1; i < count; i++) {
+			if (!(fds[i].revents & POLLPRI))
+				continue;
+
+			if (fds[i].fd == criticalFD) {
+				level = PressureLevel::Critical;
+			} else if (fds[i].fd == nonCriticalFD) {
+				level = std::max(level, PressureLevel::NonCritical);
+			} else {
+				MemoryEvents events;
+				readMemoryEvents(eventsFD, events);
+				if (events.max > lastEvents.max || events.oom > lastEvents.oom)
+					level = PressureLevel::Critical;
+				else if (events.high > lastEvents.high)
+					level = std::max(level, PressureLevel::NonCritical);
+				lastEvents = events;
+			}
+		}
+
+		uint64_t total, available;
+		if (availableMemory(cgroup, total, available) && total) {
+			const uint64_t percent = available * 100 / total;
+			if (percent < handler.m_criticalPercent)
+				level = PressureLevel::Critical;
+			else if (percent < handler.m_nonCriticalPercent)
+				level = std::max(level, PressureLevel::NonCritical);
+		}
+
+		if (level == PressureLevel::None)
+			continue;
+
+		// Still releasing or holding off from the previous notification.
+		if (handler.m_awaitingResponse.exchange(true))
+			continue;
+
+		const bool critical = level == PressureLevel::Critical;
+		if (ReliefLogger::loggingEnabled())
+			LOG(MemoryPressure, "Got memory pressure notification (%s)", critical ? "critical" : "non-critical");
+
+		handler.setUnderMemoryPressure(true);
+		callOnMainThread([critical] {
+			MemoryPressureHandler::singleton().respondToMemoryPressure(critical);
+		});
+	}
+
+	for (int fd : { nonCriticalFD, criticalFD, eventsFD }) {
+		if (fd >= 0)
+			close(fd);
+	}
+}
+
+void MemoryPressureHandler::setThresholds(unsigned nonCriticalPercent, unsigned criticalPercent)
+{
+	m_nonCriticalPercent = std::min(nonCriticalPercent, 100u);
+	m_criticalPercent = std::min(criticalPercent, static_cast<unsigned>(m_nonCriticalPercent));
+}
+
+void MemoryPressureHandler::install()
+{
+	if (m_installed)
+		return;
+
+	m_wakeUpFD = eventfd(0, EFD_CLOEXEC);
+	if (m_wakeUpFD < 0) {
+		LOG(MemoryPressure, "Failed to create an eventfd for MemoryPressureHandler: %m");
+		return;
+	}
+
+	m_stopMonitoring = false;
+	m_threadID = createThread(monitorMemoryPressure, this, "WebCore: MemoryPressureHandler");
+	if (!m_threadID) {
+		LOG(MemoryPressure, "Failed to create a thread for MemoryPressureHandler");
+		close(m_wakeUpFD);
+		m_wakeUpFD = -1;
+		return;
+	}
+
+	setUnderMemoryPressure(false);
+	m_installed = true;
+}
+
+void MemoryPressureHandler::uninstall()
+{
+	if (!m_installed)
+		return;
+
+	// Join rather than detach, so that a later install() cannot race an old
+	// monitor thread that has not yet noticed it should stop.
+	m_stopMonitoring = true;
+	const uint64_t wakeUp = 1;
+	if (write(m_wakeUpFD, &wakeUp, sizeof(wakeUp)) < 0)
+		LOG(MemoryPressure, "Failed to wake up the MemoryPressureHandler thread: %m");
+	waitForThreadCompletion(m_threadID);
+	m_threadID = 0;
+	close(m_wakeUpFD);
+	m_wakeUpFD = -1;
+	m_holdOffTimer.stop();
+	m_awaitingResponse = false;
+	m_installed = false;
+}
+
+void MemoryPressureHandler::holdOffTimerFired()
+{
+	if (ReliefLogger::loggingEnabled() && isUnderMemoryPressure())
+		LOG(MemoryPressure, "System is no longer under memory pressure.");
+
+	setUnderMemoryPressure(false);
+	m_awaitingResponse = false;
+}
+
+void MemoryPressureHandler::holdOff(unsigned seconds)
+{
+	m_holdOffTimer.startOneShot(seconds);
+}
+
+void MemoryPressureHandler::respondToMemoryPressure(bool critical)
+{
+	double startTime = monotonicallyIncreasingTime();
+	m_lowMemoryHandler(critical);
+	unsigned holdOffTime = (monotonicallyIncreasingTime() - startTime) * s_holdOffMultiplier;
+	holdOff(std::max(holdOffTime, s_minimumHoldOffTime));
+}
+
+void MemoryPressureHandler::platformReleaseMemory(bool critical)
+{
+	{
+		ReliefLogger log("Collect JS garbage");
+		if (critical)
+			gcController().garbageCollectNow();
+		else
+			gcController().garbageCollectSoon();
+	}
+
+#ifdef __GLIBC__
+	ReliefLogger log("Run malloc_trim");
+	malloc_trim(0);
+#endif
+}
+
+void MemoryPressureHandler::ReliefLogger::platformLog()
+{
+	size_t currentMemory = platformMemoryUsage();
+	if (currentMemory == static_cast<size_t>(-1) || m_initialMemory == static_cast<size_t>(-1)) {
+		LOG(MemoryPressure, "%s (Unable to get resident memory information for process)", m_logString);
+		return;
+	}
+
+	ssize_t memoryDiff = currentMemory - m_initialMemory;
+	LOG(MemoryPressure, "Pressure relief: %s: %+ld bytes resident (from %lu to %lu)", m_logString,
+		static_cast<long>(memoryDiff), static_cast<unsigned long>(m_initialMemory),
+		static_cast<unsigned long>(currentMemory));
+}
+
+size_t MemoryPressureHandler::ReliefLogger::platformMemoryUsage()
+{
+	uint64_t rss; // KB
+	if (!readKeyedValue("/proc/self/status", "VmRSS:", rss))
+		return static_cast<size_t>(-1);
+	return rss * KB;
+}
+
+} // namespace WebCore
+
+#endif // PLATFORM(FLTK) && OS(LINUX)
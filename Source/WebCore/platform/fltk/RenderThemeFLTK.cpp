@@ -120,6 +120,11 @@ bool RenderThemeFLTK::paintThemePart(const RenderObject& object, const FormType
 	if (info.context->paintingDisabled())
 		return false;
 
+	// FLTK draws straight into the X drawable, which a recording context
+	// doesn't have. Let the CSS fallback paint the control instead.
+	if (info.context->isRecording())
+		return true;
+
 	cairo_t* cairo = info.context->platformContext()->cr();
 	ASSERT(cairo);
 
@@ -28,6 +28,7 @@
 
 #include "config.h"
 
+#include "GraphicsContext.h"
 #include "myscroll.h"
 #include "NotImplemented.h"
 #include "ScrollbarThemeClient.h"
@@ -106,6 +107,17 @@ bool ScrollbarThemeFLTK::paint(ScrollbarThemeClient *bar, GraphicsContext *gc,
 	if (gc->paintingDisabled())
 		return false;
 
+	// FLTK draws straight into the X drawable, which a recording context
+	// doesn't have. Record a flat track and thumb in its place.
+	if (gc->isRecording()) {
+		GraphicsContextStateSaver saver(*gc);
+		gc->clip(rect);
+		gc->fillRect(bar->frameRect(), Color(224, 224, 224), ColorSpaceDeviceRGB);
+		if (hasThumb(bar))
+			gc->fillRect(thumbRect(bar), Color(160, 160, 160), ColorSpaceDeviceRGB);
+		return true;
+	}
+
 	cairo_t* cairo = gc->platformContext()->cr();
 	ASSERT(cairo);
 
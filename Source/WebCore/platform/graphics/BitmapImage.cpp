@@ -57,6 +57,9 @@ BitmapImage::BitmapImage(ImageObserver* observer)
     , m_decodedSize(0)
     , m_decodedPropertiesSize(0)
     , m_frameCount(0)
+#if !USE(CG)
+    , m_asynchronousDecodingGeneration(0)
+#endif
 #if PLATFORM(IOS)
     // FIXME: We should expose a setting to enable/disable progressive loading remove the PLATFORM(IOS)-guard.
     , m_progressiveLoadChunkTime(0)
@@ -74,6 +77,10 @@ BitmapImage::BitmapImage(ImageObserver* observer)
     , m_hasUniformFrameSize(true)
     , m_haveFrameCount(false)
     , m_animationFinishedWhenCatchingUp(false)
+#if !USE(CG)
+    , m_isDecodingFrameAsynchronously(false)
+    , m_asynchronousDecodingFailed(false)
+#endif
 {
 }
 
@@ -177,6 +184,12 @@ void BitmapImage::destroyMetadataAndNotify(unsigned frameBytesCleared)
     m_checkedForSolidColor = false;
     invalidatePlatformData();
 
+#if !USE(CG)
+    // Any frame still being decoded was decoded from data we no longer trust or want.
+    ++m_asynchronousDecodingGeneration;
+    m_isDecodingFrameAsynchronously = false;
+#endif
+
     ASSERT(m_decodedSize >= frameBytesCleared);
     m_decodedSize -= frameBytesCleared;
     if (frameBytesCleared > 0) {
@@ -216,16 +229,20 @@ void BitmapImage::cacheFrame(size_t index, SubsamplingLevel subsamplingLevel, Im
     if (!subsamplingLevel && frameSize != m_size)
         m_hasUniformFrameSize = false;
 
-    if (m_frames[index].m_frame) {
-        int deltaBytes = safeCast<int>(m_frames[index].m_frameBytes);
-        m_decodedSize += deltaBytes;
-        // The fully-decoded frame will subsume the partially decoded data used
-        // to determine image properties.
-        deltaBytes -= m_decodedPropertiesSize;
-        m_decodedPropertiesSize = 0;
-        if (imageObserver())
-            imageObserver()->decodedSizeChanged(this, deltaBytes);
-    }
+    if (m_frames[index].m_frame)
+        didCacheFrameData(index);
+}
+
+void BitmapImage::didCacheFrameData(size_t index)
+{
+    int deltaBytes = safeCast<int>(m_frames[index].m_frameBytes);
+    m_decodedSize += deltaBytes;
+    // The fully-decoded frame will subsume the partially decoded data used
+    // to determine image properties.
+    deltaBytes -= m_decodedPropertiesSize;
+    m_decodedPropertiesSize = 0;
+    if (imageObserver())
+        imageObserver()->decodedSizeChanged(this, deltaBytes);
 }
 
 void BitmapImage::didDecodeProperties() const
@@ -390,6 +407,12 @@ bool BitmapImage::ensureFrameIsCached(size_t index, ImageFrameCaching frameCachi
     if (index >= frameCount())
         return false;
 
+#if !USE(CG)
+    // Caching the metadata would decode the frame on this thread after all.
+    if (m_isDecodingFrameAsynchronously && (index >= m_frames.size() || !m_frames[index].m_haveMetadata))
+        return false;
+#endif
+
     if (index >= m_frames.size()
         || (frameCaching == CacheMetadataAndFrame && !m_frames[index].m_frame)
         || (frameCaching == CacheMetadataOnly && !m_frames[index].m_haveMetadata))
@@ -407,15 +430,8 @@ PassNativeImagePtr BitmapImage::frameAtIndex(size_t index, float presentationSca
 
     // We may have cached a frame with a higher subsampling level, in which case we need to
     // re-decode with a lower level.
-    if (index < m_frames.size() && m_frames[index].m_frame && subsamplingLevel < m_frames[index].m_subsamplingLevel) {
-        // If the image is already cached, but at too small a size, re-decode a larger version.
-        int sizeChange = -m_frames[index].m_frameBytes;
-        m_frames[index].clear(true);
-        invalidatePlatformData();
-        m_decodedSize += sizeChange;
-        if (imageObserver())
-            imageObserver()->decodedSizeChanged(this, sizeChange);
-    }
+    if (index < m_frames.size() && m_frames[index].m_frame && subsamplingLevel < m_frames[index].m_subsamplingLevel)
+        destroyFrameAtIndex(index);
 
     // If we haven't fetched a frame yet, do so.
     if (index >= m_frames.size() || !m_frames[index].m_frame)
@@ -424,6 +440,96 @@ PassNativeImagePtr BitmapImage::frameAtIndex(size_t index, float presentationSca
     return m_frames[index].m_frame;
 }
 
+#if !USE(CG)
+static const int minimumPixelsForAsynchronousDecoding = 512 * 512;
+
+bool BitmapImage::canDecodeFrameAsynchronously(size_t index)
+{
+    // Progressively loaded and animated images keep decoding on the main thread, where the
+    // decoder state they rely on lives.
+    if (m_asynchronousDecodingFailed || !m_allDataReceived || !data())
+        return false;
+    if (index || frameCount() != 1)
+        return false;
+    updateSize();
+    return m_size.area() >= minimumPixelsForAsynchronousDecoding;
+}
+
+PassNativeImagePtr BitmapImage::frameAtIndexDecodingAsynchronously(size_t index, float presentationScaleHint)
+{
+    if (!canDecodeFrameAsynchronously(index))
+        return frameAtIndex(index, presentationScaleHint);
+
+    SubsamplingLevel subsamplingLevel = std::min(m_source.subsamplingLevelForScale(presentationScaleHint), m_minimumSubsamplingLevel);
+    bool haveFrame = index < m_frames.size() && m_frames[index].m_frame;
+    if (haveFrame && subsamplingLevel >= m_frames[index].m_subsamplingLevel)
+        return m_frames[index].m_frame;
+
+    if (!m_isDecodingFrameAsynchronously) {
+        m_isDecodingFrameAsynchronously = true;
+
+        // Keep ourselves alive until the decoded frame comes back to the main thread.
+        ref();
+        unsigned generation = m_asynchronousDecodingGeneration;
+        m_source.createFrameAtIndexAsynchronously(*data(), index, subsamplingLevel, [this, index, subsamplingLevel, generation] (ImageSource::DecodedFrame& decodedFrame) {
+            if (generation == m_asynchronousDecodingGeneration) {
+                m_isDecodingFrameAsynchronously = false;
+                didDecodeFrameAsynchronously(index, subsamplingLevel, decodedFrame);
+            }
+            deref();
+        });
+    }
+
+    // Paint the smaller frame we already have, if any, until the larger one arrives.
+    return haveFrame ? m_frames[index].m_frame : nullptr;
+}
+
+void BitmapImage::didDecodeFrameAsynchronously(size_t index, SubsamplingLevel subsamplingLevel, ImageSource::DecodedFrame& decodedFrame)
+{
+    if (index < m_frames.size() && m_frames[index].m_frame) {
+        // Someone decoded a frame at least as large on the main thread in the meantime.
+        if (m_frames[index].m_subsamplingLevel <= subsamplingLevel)
+            return;
+        destroyFrameAtIndex(index);
+    }
+
+    if (decodedFrame.frame) {
+        size_t numFrames = frameCount();
+        ASSERT(index < numFrames);
+        if (m_frames.size() < numFrames)
+            m_frames.grow(numFrames);
+
+        FrameData& frameData = m_frames[index];
+        frameData.m_frame = decodedFrame.frame;
+        frameData.m_subsamplingLevel = subsamplingLevel;
+        frameData.m_orientation = m_source.orientationAtIndex(index);
+        frameData.m_haveMetadata = true;
+        frameData.m_isComplete = decodedFrame.isComplete;
+        frameData.m_hasAlpha = decodedFrame.hasAlpha;
+        frameData.m_frameBytes = decodedFrame.frameBytes;
+
+        checkForSolidColor();
+        didCacheFrameData(index);
+    } else {
+        // Let the next paint decode the frame on the main thread, which reports the error.
+        m_asynchronousDecodingFailed = true;
+    }
+
+    if (imageObserver())
+        imageObserver()->changedInRect(this, IntRect(IntPoint(), m_size));
+}
+#endif
+
+void BitmapImage::destroyFrameAtIndex(size_t index)
+{
+    int sizeChange = -m_frames[index].m_frameBytes;
+    m_frames[index].clear(true);
+    invalidatePlatformData();
+    m_decodedSize += sizeChange;
+    if (imageObserver())
+        imageObserver()->decodedSizeChanged(this, sizeChange);
+}
+
 bool BitmapImage::frameIsCompleteAtIndex(size_t index)
 {
     if (!ensureFrameIsCached(index, CacheMetadataOnly))
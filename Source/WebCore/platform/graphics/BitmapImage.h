@@ -216,6 +216,15 @@ protected:
     PassNativeImagePtr frameAtIndex(size_t, float presentationScaleHint = 1);
     PassNativeImagePtr copyUnscaledFrameAtIndex(size_t);
 
+#if !USE(CG)
+    // Like frameAtIndex(), except that a large frame that isn't decoded yet, or only at too small
+    // a size, is decoded on a decoding thread instead. Until that finishes this returns the smaller
+    // frame or null; then our observer is told that the image changed so that it can repaint.
+    PassNativeImagePtr frameAtIndexDecodingAsynchronously(size_t, float presentationScaleHint = 1);
+    bool canDecodeFrameAsynchronously(size_t);
+    void didDecodeFrameAsynchronously(size_t, SubsamplingLevel, ImageSource::DecodedFrame&);
+#endif
+
     bool haveFrameAtIndex(size_t);
 
     bool frameIsCompleteAtIndex(size_t);
@@ -227,9 +236,16 @@ protected:
     enum ImageFrameCaching { CacheMetadataOnly, CacheMetadataAndFrame };
     void cacheFrame(size_t index, SubsamplingLevel, ImageFrameCaching = CacheMetadataAndFrame);
 
-    // Called before accessing m_frames[index] for info without decoding. Returns false on index out of bounds.
+    // Called before accessing m_frames[index] for info without decoding. Returns false on index out of bounds,
+    // or while the frame is being decoded on a decoding thread.
     bool ensureFrameIsCached(size_t index, ImageFrameCaching = CacheMetadataAndFrame);
 
+    // Reports the memory used by a newly cached frame to our observer.
+    void didCacheFrameData(size_t index);
+
+    // Throws away a cached frame along with its metadata so that it can be decoded again.
+    void destroyFrameAtIndex(size_t index);
+
     // Called to invalidate cached data. When |destroyAll| is true, we wipe out
     // the entire frame buffer cache and tell the image source to destroy
     // everything; this is used when e.g. we want to free some room in the image
@@ -320,6 +336,9 @@ private:
     unsigned m_decodedSize; // The current size of all decoded frames.
     mutable unsigned m_decodedPropertiesSize; // The size of data decoded by the source to determine image properties (e.g. size, frame count, etc).
     size_t m_frameCount;
+#if !USE(CG)
+    unsigned m_asynchronousDecodingGeneration; // Bumped whenever an asynchronously decoded frame would be stale.
+#endif
 
 #if PLATFORM(IOS)
     // FIXME: We should expose a setting to enable/disable progressive loading remove the PLATFORM(IOS)-guard.
@@ -339,6 +358,10 @@ private:
     mutable bool m_hasUniformFrameSize : 1;
     mutable bool m_haveFrameCount : 1;
     bool m_animationFinishedWhenCatchingUp : 1;
+#if !USE(CG)
+    bool m_isDecodingFrameAsynchronously : 1;
+    bool m_asynchronousDecodingFailed : 1; // Whether the decoding thread failed to produce a frame; we decode synchronously from then on.
+#endif
 
     RefPtr<Image> m_cachedImage;
 };
@@ -43,6 +43,10 @@
 #include <wtf/text/AtomicStringHash.h>
 #include <wtf/text/StringHash.h>
 
+#if USE(FREETYPE)
+#include "FontConfigCache.h"
+#endif
+
 #if ENABLE(OPENTYPE_VERTICAL)
 #include "OpenTypeVerticalData.h"
 #endif
@@ -535,6 +539,9 @@ void FontCache::invalidate()
 
     fontPlatformDataCache().clear();
     invalidateFontCascadeCache();
+#if USE(FREETYPE)
+    FontConfigCache::singleton().clear();
+#endif
 
     gGeneration++;
 
@@ -28,6 +28,7 @@
 
 #include "BidiResolver.h"
 #include "BitmapImage.h"
+#include "DisplayListRecorder.h"
 #include "FloatRoundedRect.h"
 #include "Gradient.h"
 #include "ImageBuffer.h"
@@ -100,11 +101,21 @@ private:
 
 GraphicsContext::GraphicsContext(PlatformGraphicsContext* platformGraphicsContext)
     : m_updatingControlTints(false)
+    , m_decodesImagesAsynchronously(false)
     , m_transparencyCount(0)
 {
     platformInit(platformGraphicsContext);
 }
 
+GraphicsContext::GraphicsContext(DisplayList::Recorder& recorder)
+    : m_data(nullptr)
+    , m_updatingControlTints(false)
+    , m_decodesImagesAsynchronously(false)
+    , m_transparencyCount(0)
+    , m_displayListRecorder(&recorder)
+{
+}
+
 GraphicsContext::~GraphicsContext()
 {
     ASSERT(m_stack.isEmpty());
@@ -119,6 +130,11 @@ void GraphicsContext::save()
 
     m_stack.append(m_state);
 
+    if (isRecording()) {
+        m_displayListRecorder->save();
+        return;
+    }
+
     savePlatformState();
 }
 
@@ -134,6 +150,11 @@ void GraphicsContext::restore()
     m_state = m_stack.last();
     m_stack.removeLast();
 
+    if (isRecording()) {
+        m_displayListRecorder->restore();
+        return;
+    }
+
     restorePlatformState();
 }
 
@@ -160,12 +181,16 @@ void GraphicsContext::drawRaisedEllipse(const FloatRect& rect, const Color& elli
 void GraphicsContext::setStrokeThickness(float thickness)
 {
     m_state.strokeThickness = thickness;
+    if (isRecording())
+        return;
     setPlatformStrokeThickness(thickness);
 }
 
 void GraphicsContext::setStrokeStyle(StrokeStyle style)
 {
     m_state.strokeStyle = style;
+    if (isRecording())
+        return;
     setPlatformStrokeStyle(style);
 }
 
@@ -175,6 +200,8 @@ void GraphicsContext::setStrokeColor(const Color& color, ColorSpace colorSpace)
     m_state.strokeColorSpace = colorSpace;
     m_state.strokeGradient.clear();
     m_state.strokePattern.clear();
+    if (isRecording())
+        return;
     setPlatformStrokeColor(color, colorSpace);
 }
 
@@ -184,6 +211,8 @@ void GraphicsContext::setShadow(const FloatSize& offset, float blur, const Color
     m_state.shadowBlur = blur;
     m_state.shadowColor = color;
     m_state.shadowColorSpace = colorSpace;
+    if (isRecording())
+        return;
     setPlatformShadow(offset, blur, color, colorSpace);
 }
 
@@ -196,6 +225,8 @@ void GraphicsContext::setLegacyShadow(const FloatSize& offset, float blur, const
 #if USE(CG)
     m_state.shadowsUseLegacyRadius = true;
 #endif
+    if (isRecording())
+        return;
     setPlatformShadow(offset, blur, color, colorSpace);
 }
 
@@ -205,6 +236,8 @@ void GraphicsContext::clearShadow()
     m_state.shadowBlur = 0;
     m_state.shadowColor = Color();
     m_state.shadowColorSpace = ColorSpaceDeviceRGB;
+    if (isRecording())
+        return;
     clearPlatformShadow();
 }
 
@@ -242,18 +275,24 @@ void GraphicsContext::setFillColor(const Color& color, ColorSpace colorSpace)
     m_state.fillColorSpace = colorSpace;
     m_state.fillGradient.clear();
     m_state.fillPattern.clear();
+    if (isRecording())
+        return;
     setPlatformFillColor(color, colorSpace);
 }
 
 void GraphicsContext::setShouldAntialias(bool shouldAntialias)
 {
     m_state.shouldAntialias = shouldAntialias;
+    if (isRecording())
+        return;
     setPlatformShouldAntialias(shouldAntialias);
 }
 
 void GraphicsContext::setShouldSmoothFonts(bool shouldSmoothFonts)
 {
     m_state.shouldSmoothFonts = shouldSmoothFonts;
+    if (isRecording())
+        return;
     setPlatformShouldSmoothFonts(shouldSmoothFonts);
 }
 
@@ -288,13 +327,19 @@ void GraphicsContext::setFillGradient(Ref<Gradient>&& gradient)
 
 void GraphicsContext::beginTransparencyLayer(float opacity)
 {
-    beginPlatformTransparencyLayer(opacity);
+    if (isRecording())
+        m_displayListRecorder->beginTransparencyLayer(opacity);
+    else
+        beginPlatformTransparencyLayer(opacity);
     ++m_transparencyCount;
 }
 
 void GraphicsContext::endTransparencyLayer()
 {
-    endPlatformTransparencyLayer();
+    if (isRecording())
+        m_displayListRecorder->endTransparencyLayer();
+    else
+        endPlatformTransparencyLayer();
     ASSERT(m_transparencyCount > 0);
     --m_transparencyCount;
 }
@@ -318,6 +363,11 @@ void GraphicsContext::drawGlyphs(const FontCascade& fontCascade, const Font& fon
     if (paintingDisabled())
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawGlyphs(fontCascade, font, buffer, from, numGlyphs, point);
+        return;
+    }
+
     fontCascade.drawGlyphs(this, &font, buffer, from, numGlyphs, point);
 }
 
@@ -389,6 +439,11 @@ void GraphicsContext::drawImage(Image* image, ColorSpace colorSpace, const Float
     if (paintingDisabled() || !image)
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawImage(*image, colorSpace, destination, source, imagePaintingOptions);
+        return;
+    }
+
     // FIXME (49002): Should be InterpolationLow
     InterpolationQualityMaintainer interpolationQualityForThisScope(*this, imagePaintingOptions.m_useLowQualityScale ? InterpolationNone : imageInterpolationQuality());
     image->draw(this, destination, source, colorSpace, imagePaintingOptions.m_compositeOperator, imagePaintingOptions.m_blendMode, imagePaintingOptions.m_orientationDescription);
@@ -400,6 +455,11 @@ void GraphicsContext::drawTiledImage(Image* image, ColorSpace colorSpace, const
     if (paintingDisabled() || !image)
         return;
 
+    if (isRecording()) {
+        m_displayListRecorder->drawTiledImage(*image, colorSpace, destination, source, tileSize, imagePaintingOptions);
+        return;
+    }
+
     InterpolationQualityMaintainer interpolationQualityForThisScope(*this, imagePaintingOptions.m_useLowQualityScale ? InterpolationLow : imageInterpolationQuality());
     image->drawTiled(this, destination, source, tileSize, colorSpace, imagePaintingOptions.m_compositeOperator, imagePaintingOptions.m_blendMode);
 }
@@ -416,6 +476,11 @@ void GraphicsContext::drawTiledImage(Image* image, ColorSpace colorSpace, const
         return;
     }
 
+    if (isRecording()) {
+        m_displayListRecorder->drawTiledImage(*image, colorSpace, destination, source, tileScaleFactor, hRule, vRule, imagePaintingOptions);
+        return;
+    }
+
     InterpolationQualityMaintainer interpolationQualityForThisScope(*this, imagePaintingOptions.m_useLowQualityScale ? InterpolationLow : imageInterpolationQuality());
     image->drawTiled(this, destination, source, tileScaleFactor, hRule, vRule, colorSpace, imagePaintingOptions.m_compositeOperator);
 }
@@ -439,6 +504,13 @@ void GraphicsContext::drawImageBuffer(ImageBuffer* image, ColorSpace colorSpace,
     if (paintingDisabled() || !image)
         return;
 
+    // Snapshot the buffer, it is usually drawn into again before the list is replayed.
+    if (isRecording()) {
+        if (RefPtr<Image> copy = image->copyImage(CopyBackingStore))
+            m_displayListRecorder->drawImage(*copy, colorSpace, destination, source, imagePaintingOptions);
+        return;
+    }
+
     // FIXME (49002): Should be InterpolationLow
     InterpolationQualityMaintainer interpolationQualityForThisScope(*this, imagePaintingOptions.m_useLowQualityScale ? InterpolationNone : imageInterpolationQuality());
     image->draw(this, colorSpace, destination, source, imagePaintingOptions.m_compositeOperator, imagePaintingOptions.m_blendMode, imagePaintingOptions.m_useLowQualityScale);
@@ -478,6 +550,10 @@ void GraphicsContext::clipToImageBuffer(ImageBuffer* buffer, const FloatRect& re
 {
     if (paintingDisabled())
         return;
+    if (isRecording()) {
+        m_displayListRecorder->clipToImageBuffer(*buffer, rect);
+        return;
+    }
     buffer->clip(this, rect);
 }
 
@@ -492,7 +568,7 @@ IntRect GraphicsContext::clipBounds() const
 void GraphicsContext::setTextDrawingMode(TextDrawingModeFlags mode)
 {
     m_state.textDrawingMode = mode;
-    if (paintingDisabled())
+    if (paintingDisabled() || isRecording())
         return;
     setPlatformTextDrawingMode(mode);
 }
@@ -501,6 +577,10 @@ void GraphicsContext::fillRect(const FloatRect& rect, Gradient& gradient)
 {
     if (paintingDisabled())
         return;
+    if (isRecording()) {
+        m_displayListRecorder->fillRect(rect, gradient);
+        return;
+    }
     gradient.fill(this, rect);
 }
 
@@ -517,6 +597,11 @@ void GraphicsContext::fillRect(const FloatRect& rect, const Color& color, ColorS
 
 void GraphicsContext::fillRoundedRect(const FloatRoundedRect& rect, const Color& color, ColorSpace colorSpace, BlendMode blendMode)
 {
+    if (isRecording()) {
+        m_displayListRecorder->fillRoundedRect(rect, color, colorSpace, blendMode);
+        return;
+    }
+
     if (rect.isRounded()) {
         setCompositeOperation(compositeOperation(), blendMode);
         platformFillRoundedRect(rect, color, colorSpace);
@@ -556,6 +641,8 @@ void GraphicsContext::fillRectWithRoundedHole(const IntRect& rect, const FloatRo
 void GraphicsContext::setAlpha(float alpha)
 {
     m_state.alpha = alpha;
+    if (isRecording())
+        return;
     setPlatformAlpha(alpha);
 }
 
@@ -563,6 +650,8 @@ void GraphicsContext::setCompositeOperation(CompositeOperator compositeOperation
 {
     m_state.compositeOperator = compositeOperation;
     m_state.blendMode = blendMode;
+    if (isRecording())
+        return;
     setPlatformCompositeOperation(compositeOperation, blendMode);
 }
 
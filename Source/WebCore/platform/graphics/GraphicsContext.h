@@ -84,6 +84,10 @@ namespace WebCore {
     class TextRun;
     class TransformationMatrix;
 
+    namespace DisplayList {
+    class Recorder;
+    }
+
     enum TextDrawingMode {
         TextModeFill = 1 << 0,
         TextModeStroke = 1 << 1,
@@ -202,10 +206,14 @@ namespace WebCore {
         WTF_MAKE_NONCOPYABLE(GraphicsContext); WTF_MAKE_FAST_ALLOCATED;
     public:
         WEBCORE_EXPORT GraphicsContext(PlatformGraphicsContext*);
+        // A context without a platform context, which hands everything drawn into it to the recorder.
+        explicit GraphicsContext(DisplayList::Recorder&);
         WEBCORE_EXPORT ~GraphicsContext();
 
         WEBCORE_EXPORT PlatformGraphicsContext* platformContext() const;
 
+        bool isRecording() const { return m_displayListRecorder; }
+
         void setStrokeThickness(float);
         float strokeThickness() const { return m_state.strokeThickness; }
 
@@ -369,6 +377,11 @@ namespace WebCore {
         void setUpdatingControlTints(bool);
         bool updatingControlTints() const { return m_updatingControlTints; }
 
+        // Whether large images that aren't decoded yet may be skipped and decoded on another thread
+        // while painting into this context. Only set this for contexts that get repainted.
+        void setDecodesImagesAsynchronously(bool decodesImagesAsynchronously) { m_decodesImagesAsynchronously = decodesImagesAsynchronously; }
+        bool decodesImagesAsynchronously() const { return m_decodesImagesAsynchronously; }
+
         WEBCORE_EXPORT void beginTransparencyLayer(float opacity);
         WEBCORE_EXPORT void endTransparencyLayer();
         bool isInTransparencyLayer() const { return (m_transparencyCount > 0) && supportsTransparencyLayers(); }
@@ -561,7 +574,12 @@ namespace WebCore {
         GraphicsContextState m_state;
         Vector<GraphicsContextState> m_stack;
         bool m_updatingControlTints;
+        bool m_decodesImagesAsynchronously;
         unsigned m_transparencyCount;
+
+        // While recording, state setters only update m_state; the recorder snapshots it before
+        // each drawing operation instead of recording every change.
+        DisplayList::Recorder* m_displayListRecorder { nullptr };
     };
 
     class GraphicsContextStateSaver {
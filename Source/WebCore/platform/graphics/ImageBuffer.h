@@ -73,6 +73,10 @@ enum ScaleBehavior {
     Unscaled
 };
 
+// Below this many pixels per job, waking up the ParallelJobs threads costs more than it
+// saves for per-pixel work as heavy as a blur pass. Cheaper work needs larger jobs.
+static const int minimalAreaPerParallelPixelJob = 128 * 128;
+
 class ImageBuffer {
     WTF_MAKE_NONCOPYABLE(ImageBuffer); WTF_MAKE_FAST_ALLOCATED;
 public:
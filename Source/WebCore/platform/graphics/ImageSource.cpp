@@ -35,6 +35,12 @@
 
 #include "ImageOrientation.h"
 #include "NotImplemented.h"
+#include <mutex>
+#include <wtf/MainThread.h>
+#include <wtf/MathExtras.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/NumberOfCores.h>
 
 namespace WebCore {
 
@@ -42,6 +48,35 @@ namespace WebCore {
 unsigned ImageSource::s_maxPixelsPerDecodedImage = 1024 * 1024;
 #endif
 
+static const int maximumImageDecodingThreads = 4;
+
+static void callOnImageDecodingThread(std::function<void ()>&& function)
+{
+    ASSERT(isMainThread());
+    ASSERT(function);
+
+    static NeverDestroyed<MessageQueue<std::function<void ()>>> queue;
+
+    static std::once_flag createDecodingThreadsOnce;
+    std::call_once(createDecodingThreadsOnce, [] {
+        // Leave a core to the main thread.
+        int threadCount = std::max(1, std::min(WTF::numberOfProcessorCores() - 1, maximumImageDecodingThreads));
+        for (int i = 0; i < threadCount; ++i) {
+            createThread("WebCore: ImageDecoder", [] {
+                for (;;) {
+                    auto function = queue.get().waitForMessage();
+
+                    // This can never be null because we never kill the MessageQueue.
+                    ASSERT(function);
+                    (*function)();
+                }
+            });
+        }
+    });
+
+    queue.get().append(std::make_unique<std::function<void ()>>(WTF::move(function)));
+}
+
 ImageSource::ImageSource(ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
     : m_decoder(0)
     , m_alphaOption(alphaOption)
@@ -96,14 +131,23 @@ String ImageSource::filenameExtension() const
     return m_decoder ? m_decoder->filenameExtension() : String();
 }
 
-SubsamplingLevel ImageSource::subsamplingLevelForScale(float) const
+SubsamplingLevel ImageSource::subsamplingLevelForScale(float scale) const
 {
-    return 0;
+    // Changing the level means starting the decode over, which we can't do halfway through loading.
+    if (!m_decoder || !m_decoder->supportsSubsampling() || !m_decoder->isAllDataReceived())
+        return 0;
+
+    // There are four subsampling levels: 0 = 1x, 1 = 0.5x, 2 = 0.25x, 3 = 0.125x. Pick the
+    // smallest frame that is still at least as large as it will be drawn.
+    float clampedScale = std::max<float>(0.125, std::min<float>(1, scale));
+    int result = floorf(log2f(1 / clampedScale));
+    ASSERT(result >= 0 && result <= 3);
+    return result;
 }
 
 bool ImageSource::allowSubsamplingOfFrameAtIndex(size_t) const
 {
-    return false;
+    return m_decoder && m_decoder->supportsSubsampling();
 }
 
 bool ImageSource::isSizeAvailable()
@@ -116,12 +160,14 @@ IntSize ImageSource::size(ImageOrientationDescription description) const
     return frameSizeAtIndex(0, 0, description);
 }
 
-IntSize ImageSource::frameSizeAtIndex(size_t index, SubsamplingLevel, ImageOrientationDescription description) const
+IntSize ImageSource::frameSizeAtIndex(size_t index, SubsamplingLevel subsamplingLevel, ImageOrientationDescription description) const
 {
     if (!m_decoder)
         return IntSize();
 
     IntSize size = m_decoder->frameSizeAtIndex(index);
+    if (subsamplingLevel && m_decoder->supportsSubsampling())
+        size = ImageDecoder::subsampledSize(size, subsamplingLevel);
     if ((description.respectImageOrientation() == RespectImageOrientation) && m_decoder->orientation().usesWidthAsHeight())
         return IntSize(size.height(), size.width());
 
@@ -148,11 +194,22 @@ size_t ImageSource::frameCount() const
     return m_decoder ? m_decoder->frameCount() : 0;
 }
 
-PassNativeImagePtr ImageSource::createFrameAtIndex(size_t index, SubsamplingLevel)
+PassNativeImagePtr ImageSource::createFrameAtIndex(size_t index, SubsamplingLevel subsamplingLevel)
 {
     if (!m_decoder)
         return 0;
 
+    // A decoder produces its frames at a single subsampling level, so switching levels means
+    // decoding again from the start.
+    if (m_decoder->supportsSubsampling() && subsamplingLevel != m_decoder->subsamplingLevel()) {
+        RefPtr<SharedBuffer> data = m_decoder->data();
+        bool allDataReceived = m_decoder->isAllDataReceived();
+        clear(true, 0, data.get(), allDataReceived);
+        if (!m_decoder)
+            return 0;
+        m_decoder->setSubsamplingLevel(subsamplingLevel);
+    }
+
     ImageFrame* buffer = m_decoder->frameBufferAtIndex(index);
     if (!buffer || buffer->status() == ImageFrame::FrameEmpty)
         return 0;
@@ -214,6 +271,48 @@ unsigned ImageSource::frameBytesAtIndex(size_t index, SubsamplingLevel) const
     return m_decoder->frameBytesAtIndex(index);
 }
 
+void ImageSource::createFrameAtIndexAsynchronously(SharedBuffer& data, size_t index, SubsamplingLevel subsamplingLevel, std::function<void (DecodedFrame&)> completionHandler) const
+{
+    // Nobody else holds a reference to the copy, so the decoding thread may own it.
+    SharedBuffer* dataCopy = data.copy().leakRef();
+    AlphaOption alphaOption = m_alphaOption;
+    GammaAndColorProfileOption gammaAndColorProfileOption = m_gammaAndColorProfileOption;
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    unsigned maxPixelsPerDecodedImage = s_maxPixelsPerDecodedImage;
+#endif
+
+    callOnImageDecodingThread([=] {
+        DecodedFrame decodedFrame;
+        decodedFrame.hasAlpha = true;
+        decodedFrame.isComplete = false;
+        decodedFrame.frameBytes = 0;
+
+        {
+            RefPtr<SharedBuffer> encodedData = adoptRef(dataCopy);
+            std::unique_ptr<ImageDecoder> decoder(ImageDecoder::create(*encodedData, alphaOption, gammaAndColorProfileOption));
+            if (decoder) {
+                decoder->setSubsamplingLevel(subsamplingLevel);
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+                if (maxPixelsPerDecodedImage)
+                    decoder->setMaxNumPixels(maxPixelsPerDecodedImage);
+#endif
+                decoder->setData(encodedData.get(), true);
+                ImageFrame* buffer = decoder->frameBufferAtIndex(index);
+                if (buffer && buffer->status() != ImageFrame::FrameEmpty && !decoder->size().isEmpty()) {
+                    decodedFrame.frame = buffer->asNewNativeImage();
+                    decodedFrame.hasAlpha = decoder->frameHasAlphaAtIndex(index);
+                    decodedFrame.isComplete = buffer->status() == ImageFrame::FrameComplete;
+                    decodedFrame.frameBytes = decoder->frameBytesAtIndex(index);
+                }
+            }
+        }
+
+        callOnMainThread([decodedFrame, completionHandler]() mutable {
+            completionHandler(decodedFrame);
+        });
+    });
+}
+
 }
 
 #endif // USE(CG)
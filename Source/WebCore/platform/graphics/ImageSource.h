@@ -30,6 +30,7 @@
 #include "ImageOrientation.h"
 #include "NativeImagePtr.h"
 
+#include <functional>
 #include <wtf/Forward.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/Vector.h>
@@ -157,6 +158,20 @@ public:
     // decoded then return 0.
     unsigned frameBytesAtIndex(size_t, SubsamplingLevel = 0) const;
 
+#if !USE(CG)
+    struct DecodedFrame {
+        NativeImagePtr frame;
+        bool hasAlpha;
+        bool isComplete;
+        unsigned frameBytes;
+    };
+
+    // Decodes a frame of |data| on a decoding thread, using a decoder of its own so that this
+    // ImageSource stays usable meanwhile, and hands the result to |completionHandler| on the
+    // main thread. |data| should be complete; it is copied before decoding starts.
+    void createFrameAtIndexAsynchronously(SharedBuffer& data, size_t, SubsamplingLevel, std::function<void (DecodedFrame&)> completionHandler) const;
+#endif
+
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
     static unsigned maxPixelsPerDecodedImage() { return s_maxPixelsPerDecodedImage; }
     static void setMaxPixelsPerDecodedImage(unsigned maxPixels) { s_maxPixelsPerDecodedImage = maxPixels; }
@@ -35,8 +35,17 @@
 #include "GraphicsContext.h"
 #include "ImageBuffer.h"
 #include "Timer.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashTraits.h>
 #include <wtf/MathExtras.h>
+#include <wtf/NeverDestroyed.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/ParallelJobs.h>
+#include <wtf/StdLibExtras.h>
+
+#if HAVE(X86_SSE2_INTRINSICS)
+#include "ShadowBlurSSE2.h"
+#endif
 
 namespace WebCore {
 
@@ -165,6 +174,150 @@ ScratchBuffer& ScratchBuffer::singleton()
     return scratchBuffer;
 }
 
+// Everything the pixels of a blurred and colored nine-patch template depend on. The
+// template size already follows from the blur and the corner radii, so shadows of boxes
+// of any size share one template.
+struct ShadowTemplateKey {
+    ShadowTemplateKey() { }
+    ShadowTemplateKey(WTF::HashTableDeletedValueType) : isInset(-1) { }
+    ShadowTemplateKey(bool inset, const FloatSize& blurRadius, bool shadowsIgnoreTransforms, const Color& color, ColorSpace colorSpace, const FloatRoundedRect::Radii& radii, const IntSize& templateSize)
+        : isInset(inset)
+        , shadowsIgnoreTransforms(shadowsIgnoreTransforms)
+        , blurRadius(blurRadius)
+        , color(color)
+        , colorSpace(colorSpace)
+        , radii(radii)
+        , templateSize(templateSize)
+    {
+    }
+
+    bool isHashTableDeletedValue() const { return isInset == -1; }
+
+    bool operator==(const ShadowTemplateKey& other) const
+    {
+        return isInset == other.isInset && shadowsIgnoreTransforms == other.shadowsIgnoreTransforms && blurRadius == other.blurRadius
+            && color == other.color && colorSpace == other.colorSpace && radii == other.radii && templateSize == other.templateSize;
+    }
+
+    int isInset { 0 };
+    bool shadowsIgnoreTransforms { false };
+    FloatSize blurRadius;
+    Color color;
+    ColorSpace colorSpace { ColorSpaceDeviceRGB };
+    FloatRoundedRect::Radii radii;
+    IntSize templateSize;
+};
+
+struct ShadowTemplateKeyHash {
+    static unsigned hash(const ShadowTemplateKey& key)
+    {
+        unsigned hash = WTF::pairIntHash(key.templateSize.width(), key.templateSize.height());
+        hash = WTF::pairIntHash(hash, WTF::pairIntHash(bitwise_cast<unsigned>(key.blurRadius.width()), bitwise_cast<unsigned>(key.blurRadius.height())));
+        hash = WTF::pairIntHash(hash, WTF::pairIntHash(bitwise_cast<unsigned>(key.radii.topLeft().width()), bitwise_cast<unsigned>(key.radii.bottomRight().height())));
+        return WTF::pairIntHash(hash, WTF::pairIntHash(key.color.rgb(), key.isInset));
+    }
+    static bool equal(const ShadowTemplateKey& a, const ShadowTemplateKey& b) { return a == b; }
+    static const bool safeToCompareToEmptyOrDeleted = true;
+};
+
+struct ShadowTemplateKeyTraits : WTF::SimpleClassHashTraits<ShadowTemplateKey> {
+    static const bool emptyValueIsZero = false;
+};
+
+// Blurred nine-patch templates for the tiled rect and inset shadow paths, so pages that
+// repeat the same box-shadow on many elements blur it once instead of every time the
+// single scratch buffer is reused for a different shadow. Least recently used templates
+// go first when the cache is full, and all of them are dropped after a while without use.
+class ShadowTemplateCache {
+    WTF_MAKE_NONCOPYABLE(ShadowTemplateCache); WTF_MAKE_FAST_ALLOCATED;
+    friend NeverDestroyed<ShadowTemplateCache>;
+public:
+    static ShadowTemplateCache& singleton();
+
+    ImageBuffer* find(const ShadowTemplateKey& key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return nullptr;
+
+        it->value.lastUse = ++m_useCounter;
+        schedulePurge();
+        return it->value.image.get();
+    }
+
+    // Returns a cleared buffer of the template size that the caller draws the template
+    // into, or null if the template is too large to be worth keeping.
+    ImageBuffer* add(const ShadowTemplateKey& key, const IntSize& templateSize)
+    {
+        size_t templateBytes = static_cast<size_t>(templateSize.width()) * templateSize.height() * 4;
+        if (templateBytes > maximumSize / 4)
+            return nullptr;
+
+        prune(maximumSize - templateBytes);
+
+        std::unique_ptr<ImageBuffer> image = ImageBuffer::create(templateSize, 1);
+        if (!image)
+            return nullptr;
+
+        ImageBuffer* result = image.get();
+        m_entries.set(key, Entry { std::move(image), templateBytes, ++m_useCounter });
+        m_size += templateBytes;
+        schedulePurge();
+        return result;
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_size = 0;
+        m_purgeTimer.stop();
+    }
+
+private:
+    ShadowTemplateCache()
+        : m_purgeTimer(*this, &ShadowTemplateCache::clear)
+    {
+    }
+
+    static const size_t maximumSize = 4 * 1024 * 1024;
+
+    struct Entry {
+        std::unique_ptr<ImageBuffer> image;
+        size_t size;
+        unsigned lastUse;
+    };
+
+    void prune(size_t targetSize)
+    {
+        while (m_size > targetSize) {
+            auto leastRecentlyUsed = m_entries.begin();
+            for (auto it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+                if (it->value.lastUse < leastRecentlyUsed->value.lastUse)
+                    leastRecentlyUsed = it;
+            }
+            m_size -= leastRecentlyUsed->value.size;
+            m_entries.remove(leastRecentlyUsed);
+        }
+    }
+
+    void schedulePurge()
+    {
+        const double templateCachePurgeInterval = 30;
+        m_purgeTimer.startOneShot(templateCachePurgeInterval);
+    }
+
+    HashMap<ShadowTemplateKey, Entry, ShadowTemplateKeyHash, ShadowTemplateKeyTraits> m_entries;
+    size_t m_size { 0 };
+    unsigned m_useCounter { 0 };
+    Timer m_purgeTimer;
+};
+
+ShadowTemplateCache& ShadowTemplateCache::singleton()
+{
+    static NeverDestroyed<ShadowTemplateCache> cache;
+    return cache;
+}
+
 static const int templateSideLength = 1;
 
 #if USE(CG)
@@ -283,6 +436,11 @@ static void calculateLobes(int lobes[][2], float blurRadius, bool shadowsIgnoreT
     }
 }
 
+void ShadowBlur::clearTemplateCache()
+{
+    ShadowTemplateCache::singleton().clear();
+}
+
 void ShadowBlur::clear()
 {
     m_type = NoShadow;
@@ -291,86 +449,138 @@ void ShadowBlur::clear()
     m_offset = FloatSize();
 }
 
-void ShadowBlur::blurLayerImage(unsigned char* imageData, const IntSize& size, int rowStride)
+struct BlurLinesParameters {
+    unsigned char* pixels;
+    int numberOfLines;
+    int delta;
+    int stride;
+    int dim;
+    const int (*lobes)[2];
+};
+
+static void blurLines(BlurLinesParameters* parameters)
 {
     const int channels[4] = { 3, 0, 1, 3 };
 
-    int lobes[3][2]; // indexed by pass, and left/right lobe
-    calculateLobes(lobes, m_blurRadius.width(), m_shadowsIgnoreTransforms);
+    const int (*lobes)[2] = parameters->lobes;
+    int stride = parameters->stride;
+    int dim = parameters->dim;
+    unsigned char* pixels = parameters->pixels;
+    int j = 0;
+
+#if HAVE(X86_SSE2_INTRINSICS)
+    // In the vertical pass the lines are adjacent columns, which are blurred four at a time.
+    if (parameters->delta == 4 && cpuSupportsSSE2()) {
+        for (; j + 4 <= parameters->numberOfLines; j += 4, pixels += 4 * parameters->delta)
+            blurFourColumnsSSE2(pixels, stride, dim, lobes, blurSumShift);
+    }
+#endif
 
-    // First pass is horizontal.
-    int stride = 4;
-    int delta = rowStride;
-    int final = size.height();
-    int dim = size.width();
-
-    // Two stages: horizontal and vertical
-    for (int pass = 0; pass < 2; ++pass) {
-        unsigned char* pixels = imageData;
-        
-        if (!pass && !m_blurRadius.width())
-            final = 0; // Do no work if horizonal blur is zero.
-
-        for (int j = 0; j < final; ++j, pixels += delta) {
-            // For each step, we blur the alpha in a channel and store the result
-            // in another channel for the subsequent step.
-            // We use sliding window algorithm to accumulate the alpha values.
-            // This is much more efficient than computing the sum of each pixels
-            // covered by the box kernel size for each x.
-            for (int step = 0; step < 3; ++step) {
-                int side1 = lobes[step][leftLobe];
-                int side2 = lobes[step][rightLobe];
-                int pixelCount = side1 + 1 + side2;
-                int invCount = ((1 << blurSumShift) + pixelCount - 1) / pixelCount;
-                int ofs = 1 + side2;
-                int alpha1 = pixels[channels[step]];
-                int alpha2 = pixels[(dim - 1) * stride + channels[step]];
-
-                unsigned char* ptr = pixels + channels[step + 1];
-                unsigned char* prev = pixels + stride + channels[step];
-                unsigned char* next = pixels + ofs * stride + channels[step];
-
-                int i;
-                int sum = side1 * alpha1 + alpha1;
-                int limit = (dim < side2 + 1) ? dim : side2 + 1;
-
-                for (i = 1; i < limit; ++i, prev += stride)
-                    sum += *prev;
-
-                if (limit <= side2)
-                    sum += (side2 - limit + 1) * alpha2;
-
-                limit = (side1 < dim) ? side1 : dim;
-                for (i = 0; i < limit; ptr += stride, next += stride, ++i, ++ofs) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += ((ofs < dim) ? *next : alpha2) - alpha1;
-                }
-                
-                prev = pixels + channels[step];
-                for (; ofs < dim; ptr += stride, prev += stride, next += stride, ++i, ++ofs) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += (*next) - (*prev);
-                }
-                
-                for (; i < dim; ptr += stride, prev += stride, ++i) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += alpha2 - (*prev);
-                }
+    for (; j < parameters->numberOfLines; ++j, pixels += parameters->delta) {
+        // For each step, we blur the alpha in a channel and store the result
+        // in another channel for the subsequent step.
+        // We use sliding window algorithm to accumulate the alpha values.
+        // This is much more efficient than computing the sum of each pixels
+        // covered by the box kernel size for each x.
+        for (int step = 0; step < 3; ++step) {
+            int side1 = lobes[step][leftLobe];
+            int side2 = lobes[step][rightLobe];
+            int pixelCount = side1 + 1 + side2;
+            int invCount = ((1 << blurSumShift) + pixelCount - 1) / pixelCount;
+            int ofs = 1 + side2;
+            int alpha1 = pixels[channels[step]];
+            int alpha2 = pixels[(dim - 1) * stride + channels[step]];
+
+            unsigned char* ptr = pixels + channels[step + 1];
+            unsigned char* prev = pixels + stride + channels[step];
+            unsigned char* next = pixels + ofs * stride + channels[step];
+
+            int i;
+            int sum = side1 * alpha1 + alpha1;
+            int limit = (dim < side2 + 1) ? dim : side2 + 1;
+
+            for (i = 1; i < limit; ++i, prev += stride)
+                sum += *prev;
+
+            if (limit <= side2)
+                sum += (side2 - limit + 1) * alpha2;
+
+            limit = (side1 < dim) ? side1 : dim;
+            for (i = 0; i < limit; ptr += stride, next += stride, ++i, ++ofs) {
+                *ptr = (sum * invCount) >> blurSumShift;
+                sum += ((ofs < dim) ? *next : alpha2) - alpha1;
+            }
+            
+            prev = pixels + channels[step];
+            for (; ofs < dim; ptr += stride, prev += stride, next += stride, ++i, ++ofs) {
+                *ptr = (sum * invCount) >> blurSumShift;
+                sum += (*next) - (*prev);
+            }
+            
+            for (; i < dim; ptr += stride, prev += stride, ++i) {
+                *ptr = (sum * invCount) >> blurSumShift;
+                sum += alpha2 - (*prev);
             }
         }
+    }
+}
 
-        // Last pass is vertical.
-        stride = rowStride;
-        delta = 4;
-        final = size.width();
-        dim = size.height();
+// The lines of a pass are blurred independently of each other, so large layers split them into jobs.
+static void blurLinesInParallel(BlurLinesParameters& parameters)
+{
+    int optimalNumberOfJobs = (parameters.numberOfLines * parameters.dim) / minimalAreaPerParallelPixelJob;
+    if (optimalNumberOfJobs > 1) {
+        ParallelJobs<BlurLinesParameters> parallelJobs(&blurLines, optimalNumberOfJobs);
+        int numberOfJobs = parallelJobs.numberOfJobs();
+        if (numberOfJobs > 1) {
+            const int jobSize = parameters.numberOfLines / numberOfJobs;
+            const int jobsWithExtra = parameters.numberOfLines % numberOfJobs;
+            unsigned char* pixels = parameters.pixels;
+            for (int job = 0; job < numberOfJobs; ++job) {
+                BlurLinesParameters& jobParameters = parallelJobs.parameter(job);
+                jobParameters = parameters;
+                jobParameters.pixels = pixels;
+                jobParameters.numberOfLines = job < jobsWithExtra ? jobSize + 1 : jobSize;
+                pixels += jobParameters.numberOfLines * parameters.delta;
+            }
+            parallelJobs.execute();
+            return;
+        }
+    }
 
-        if (!m_blurRadius.height())
-            break;
+    blurLines(&parameters);
+}
 
-        if (m_blurRadius.width() != m_blurRadius.height())
-            calculateLobes(lobes, m_blurRadius.height(), m_shadowsIgnoreTransforms);
-    }
+void ShadowBlur::blurLayerImage(unsigned char* imageData, const IntSize& size, int rowStride)
+{
+    int lobes[3][2]; // indexed by pass, and left/right lobe
+    calculateLobes(lobes, m_blurRadius.width(), m_shadowsIgnoreTransforms);
+
+    // First pass is horizontal.
+    BlurLinesParameters parameters;
+    parameters.pixels = imageData;
+    parameters.numberOfLines = size.height();
+    parameters.delta = rowStride;
+    parameters.stride = 4;
+    parameters.dim = size.width();
+    parameters.lobes = lobes;
+
+    // Do no work if horizonal blur is zero.
+    if (m_blurRadius.width())
+        blurLinesInParallel(parameters);
+
+    if (!m_blurRadius.height())
+        return;
+
+    if (m_blurRadius.width() != m_blurRadius.height())
+        calculateLobes(lobes, m_blurRadius.height(), m_shadowsIgnoreTransforms);
+
+    // Last pass is vertical.
+    parameters.numberOfLines = size.width();
+    parameters.delta = 4;
+    parameters.stride = rowStride;
+    parameters.dim = size.height();
+    blurLinesInParallel(parameters);
 }
 
 void ShadowBlur::adjustBlurRadius(GraphicsContext* context)
@@ -675,16 +885,28 @@ void ShadowBlur::drawInsetShadowWithoutTiling(GraphicsContext* graphicsContext,
 
 void ShadowBlur::drawInsetShadowWithTiling(GraphicsContext* graphicsContext, const FloatRect& rect, const FloatRoundedRect& holeRect, const IntSize& templateSize, const IntSize& edgeSize)
 {
-    m_layerImage = ScratchBuffer::singleton().getScratchBuffer(templateSize);
-    if (!m_layerImage)
-        return;
-
     // Draw the rectangle with hole.
     FloatRect templateBounds(0, 0, templateSize.width(), templateSize.height());
     FloatRect templateHole = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    bool redrawNeeded = ScratchBuffer::singleton().setCachedInsetShadowValues(m_blurRadius, m_color, m_colorSpace, templateBounds, templateHole, holeRect.radii());
+    bool redrawNeeded = false;
+    bool usesScratchBuffer = false;
+    ShadowTemplateKey templateKey(true, m_blurRadius, m_shadowsIgnoreTransforms, m_color, m_colorSpace, holeRect.radii(), templateSize);
+    m_layerImage = ShadowTemplateCache::singleton().find(templateKey);
+    if (!m_layerImage) {
+        m_layerImage = ShadowTemplateCache::singleton().add(templateKey, templateSize);
+        redrawNeeded = true;
+    }
+    if (!m_layerImage) {
+        m_layerImage = ScratchBuffer::singleton().getScratchBuffer(templateSize);
+        if (!m_layerImage)
+            return;
+        usesScratchBuffer = true;
+
+        // Only redraw in the scratch buffer if its cached contents don't match our needs
+        redrawNeeded = ScratchBuffer::singleton().setCachedInsetShadowValues(m_blurRadius, m_color, m_colorSpace, templateBounds, templateHole, holeRect.radii());
+    }
+
     if (redrawNeeded) {
         // Draw shadow into a new ImageBuffer.
         GraphicsContext* shadowContext = m_layerImage->context();
@@ -735,20 +957,33 @@ void ShadowBlur::drawInsetShadowWithTiling(GraphicsContext* graphicsContext, con
     drawLayerPieces(graphicsContext, destHoleBounds, holeRect.radii(), edgeSize, templateSize, InnerShadow);
 
     m_layerImage = 0;
-    ScratchBuffer::singleton().scheduleScratchBufferPurge();
+    if (usesScratchBuffer)
+        ScratchBuffer::singleton().scheduleScratchBufferPurge();
 }
 
 void ShadowBlur::drawRectShadowWithTiling(GraphicsContext* graphicsContext, const FloatRoundedRect& shadowedRect, const IntSize& templateSize, const IntSize& edgeSize)
 {
-    auto& scratchBuffer = ScratchBuffer::singleton();
-    m_layerImage = scratchBuffer.getScratchBuffer(templateSize);
-    if (!m_layerImage)
-        return;
-
     FloatRect templateShadow = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    bool redrawNeeded = scratchBuffer.setCachedShadowValues(m_blurRadius, m_color, m_colorSpace, templateShadow, shadowedRect.radii(), m_layerSize);
+    bool redrawNeeded = false;
+    bool usesScratchBuffer = false;
+    ShadowTemplateKey templateKey(false, m_blurRadius, m_shadowsIgnoreTransforms, m_color, m_colorSpace, shadowedRect.radii(), templateSize);
+    m_layerImage = ShadowTemplateCache::singleton().find(templateKey);
+    if (!m_layerImage) {
+        m_layerImage = ShadowTemplateCache::singleton().add(templateKey, templateSize);
+        redrawNeeded = true;
+    }
+    if (!m_layerImage) {
+        auto& scratchBuffer = ScratchBuffer::singleton();
+        m_layerImage = scratchBuffer.getScratchBuffer(templateSize);
+        if (!m_layerImage)
+            return;
+        usesScratchBuffer = true;
+
+        // Only redraw in the scratch buffer if its cached contents don't match our needs
+        redrawNeeded = scratchBuffer.setCachedShadowValues(m_blurRadius, m_color, m_colorSpace, templateShadow, shadowedRect.radii(), m_layerSize);
+    }
+
     if (redrawNeeded) {
         // Draw shadow into the ImageBuffer.
         GraphicsContext* shadowContext = m_layerImage->context();
@@ -781,7 +1016,8 @@ void ShadowBlur::drawRectShadowWithTiling(GraphicsContext* graphicsContext, cons
     drawLayerPieces(graphicsContext, shadowBounds, shadowedRect.radii(), edgeSize, templateSize, OuterShadow);
 
     m_layerImage = 0;
-    ScratchBuffer::singleton().scheduleScratchBufferPurge();
+    if (usesScratchBuffer)
+        ScratchBuffer::singleton().scheduleScratchBufferPurge();
 }
 
 void ShadowBlur::drawLayerPieces(GraphicsContext* graphicsContext, const FloatRect& shadowBounds, const FloatRoundedRect::Radii& radii, const IntSize& bufferPadding, const IntSize& templateSize, ShadowDirection direction)
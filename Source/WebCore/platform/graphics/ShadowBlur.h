@@ -70,6 +70,9 @@ public:
 
     void clear();
 
+    // Drops the blurred templates kept for the tiled rect and inset shadow paths.
+    static void clearTemplateCache();
+
     ShadowType type() const { return m_type; }
 
 private:
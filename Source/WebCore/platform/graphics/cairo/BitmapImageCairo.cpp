@@ -48,6 +48,7 @@ BitmapImage::BitmapImage(PassRefPtr<cairo_surface_t> nativeImage, ImageObserver*
     , m_repetitionsComplete(0)
     , m_decodedSize(m_size.width() * m_size.height() * 4)
     , m_frameCount(1)
+    , m_asynchronousDecodingGeneration(0)
     , m_isSolidColor(false)
     , m_checkedForSolidColor(false)
     , m_animationFinished(true)
@@ -55,6 +56,8 @@ BitmapImage::BitmapImage(PassRefPtr<cairo_surface_t> nativeImage, ImageObserver*
     , m_haveSize(true)
     , m_sizeAvailable(true)
     , m_haveFrameCount(true)
+    , m_isDecodingFrameAsynchronously(false)
+    , m_asynchronousDecodingFailed(false)
 {
     m_frames.grow(1);
     m_frames[0].m_hasAlpha = cairo_surface_get_content(nativeImage.get()) != CAIRO_CONTENT_COLOR;
@@ -72,7 +75,13 @@ void BitmapImage::draw(GraphicsContext* context, const FloatRect& dst, const Flo
 
     startAnimation();
 
-    RefPtr<cairo_surface_t> surface = frameAtIndex(m_currentFrame);
+    // Decode the frame only as large as it ends up on the device.
+    FloatRect transformedDestinationRect = context->getCTM().mapRect(dst);
+    float subsamplingScale = std::min<float>(1, std::max(transformedDestinationRect.width() / src.width(), transformedDestinationRect.height() / src.height()));
+
+    RefPtr<cairo_surface_t> surface = context->decodesImagesAsynchronously()
+        ? frameAtIndexDecodingAsynchronously(m_currentFrame, subsamplingScale)
+        : frameAtIndex(m_currentFrame, subsamplingScale);
     if (!surface) // If it's too early we won't have an image yet.
         return;
 
@@ -89,12 +98,12 @@ void BitmapImage::draw(GraphicsContext* context, const FloatRect& dst, const Flo
     else
         context->setCompositeOperation(op, blendMode);
 
-#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    // Subsampling or down-sampling may have given us a frame that is smaller than size(), and
+    // src is in the coordinates of the full-size image.
     IntSize scaledSize = cairoSurfaceSize(surface.get());
-    FloatRect adjustedSrcRect = adjustSourceRectForDownSampling(src, scaledSize);
-#else
     FloatRect adjustedSrcRect(src);
-#endif
+    if (scaledSize != m_size)
+        adjustedSrcRect.scale(static_cast<float>(scaledSize.width()) / m_size.width(), static_cast<float>(scaledSize.height()) / m_size.height());
 
     ImageOrientation frameOrientation(description.imageOrientation());
     if (description.respectImageOrientation() == RespectImageOrientation)
@@ -124,7 +133,10 @@ void BitmapImage::draw(GraphicsContext* context, const FloatRect& dst, const Flo
 
 void BitmapImage::determineMinimumSubsamplingLevel() const
 {
-    m_minimumSubsamplingLevel = 0;
+    // frameAtIndex() picks a subsampling level from the size the image is drawn at and caps it at
+    // this one, so let it go as far as the decoder can.
+    const SubsamplingLevel maxSubsamplingLevel = 3;
+    m_minimumSubsamplingLevel = m_allowSubsampling && m_source.allowSubsamplingOfFrameAtIndex(0) ? maxSubsamplingLevel : 0;
 }
 
 void BitmapImage::checkForSolidColor()
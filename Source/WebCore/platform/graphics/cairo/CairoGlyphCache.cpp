@@ -0,0 +1,309 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CairoGlyphCache.h"
+
+#if USE(CAIRO)
+
+#include "CairoUtilities.h"
+#include <algorithm>
+#include <cmath>
+#include <wtf/DataLog.h>
+
+#if USE(FREETYPE)
+#include <cairo-ft.h>
+#endif
+
+namespace WebCore {
+
+// cairo only positions glyphs at fractions of a pixel since 1.17.2; older versions
+// round each glyph to whole pixels, so one mask per glyph is all they can use.
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 17, 2)
+static const unsigned subpixelPositions = 4;
+#else
+static const unsigned subpixelPositions = 1;
+#endif
+
+// Larger glyphs are rare and expensive to keep around, so cairo draws them directly.
+static const int maximumGlyphSize = 128;
+
+static cairo_user_data_key_t glyphCacheKey;
+
+CairoGlyphCache& CairoGlyphCache::singleton()
+{
+    static NeverDestroyed<CairoGlyphCache> cache;
+    return cache;
+}
+
+static bool canUseGlyphMasks(cairo_t* context, cairo_scaled_font_t* scaledFont, double& translationX, double& translationY)
+{
+    if (cairo_get_operator(context) != CAIRO_OPERATOR_OVER)
+        return false;
+
+    // One mask per glyph only pays off against cairo's software rasterizer. Xlib surfaces
+    // draw a whole run in one request from the server's XRender glyph sets.
+    if (cairo_surface_get_type(cairo_get_group_target(context)) != CAIRO_SURFACE_TYPE_IMAGE)
+        return false;
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix(context, &matrix);
+    if (matrix.xx != 1 || matrix.yy != 1 || matrix.xy || matrix.yx)
+        return false;
+
+#if HAVE_CAIRO_SURFACE_SET_DEVICE_SCALE
+    double deviceScaleX, deviceScaleY;
+    cairo_surface_get_device_scale(cairo_get_group_target(context), &deviceScaleX, &deviceScaleY);
+    if (deviceScaleX != 1 || deviceScaleY != 1)
+        return false;
+#endif
+
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_scaled_font_get_font_options(scaledFont, options);
+    bool subpixelAntialiasing = cairo_font_options_get_antialias(options) == CAIRO_ANTIALIAS_SUBPIXEL;
+    cairo_font_options_destroy(options);
+    if (subpixelAntialiasing)
+        return false;
+
+    translationX = matrix.x0;
+    translationY = matrix.y0;
+    return true;
+}
+
+// Color glyphs, e.g. emoji, are rendered in color by cairo and would lose it in an A8 mask.
+static bool hasColorGlyphs(cairo_scaled_font_t* scaledFont)
+{
+#if USE(FREETYPE) && defined(FT_HAS_COLOR)
+    if (cairo_scaled_font_get_type(scaledFont) != CAIRO_FONT_TYPE_FT)
+        return false;
+
+    FT_Face face = cairo_ft_scaled_font_lock_face(scaledFont);
+    if (!face)
+        return false;
+
+    bool hasColor = FT_HAS_COLOR(face);
+    cairo_ft_scaled_font_unlock_face(scaledFont);
+    return hasColor;
+#else
+    UNUSED_PARAM(scaledFont);
+    return false;
+#endif
+}
+
+bool CairoGlyphCache::drawGlyphs(cairo_t* context, cairo_scaled_font_t* scaledFont, const cairo_glyph_t* glyphs, int numGlyphs, float syntheticBoldOffset)
+{
+    if (!m_maximumSize || !scaledFont || cairo_scaled_font_status(scaledFont) != CAIRO_STATUS_SUCCESS)
+        return false;
+
+    double translationX, translationY;
+    if (!canUseGlyphMasks(context, scaledFont, translationX, translationY))
+        return false;
+
+    FontAtlas& atlas = atlasForFont(scaledFont);
+    if (atlas.hasColorGlyphs)
+        return false;
+    atlas.lastUse = ++m_useCounter;
+
+    // Masks are placed in device space so that they land on whole pixels.
+    cairo_save(context);
+    cairo_identity_matrix(context);
+
+    auto drawGlyphMask = [&](const cairo_glyph_t& glyph, double x, double y) {
+        double left = std::floor(x);
+        unsigned subpixelPosition = static_cast<unsigned>((x - left) * subpixelPositions + 0.5);
+        if (subpixelPosition == subpixelPositions) {
+            left++;
+            subpixelPosition = 0;
+        }
+
+        const GlyphMask& mask = glyphMask(atlas, scaledFont, glyph.index, subpixelPosition);
+        if (mask.tooLarge)
+            return false;
+        if (mask.surface)
+            cairo_mask_surface(context, mask.surface.get(), left + mask.offset.x(), std::round(y) + mask.offset.y());
+        return true;
+    };
+
+    Vector<cairo_glyph_t, 16> uncachedGlyphs;
+    for (int i = 0; i < numGlyphs; ++i) {
+        double x = glyphs[i].x + translationX;
+        double y = glyphs[i].y + translationY;
+        if (!drawGlyphMask(glyphs[i], x, y)) {
+            uncachedGlyphs.append(glyphs[i]);
+            continue;
+        }
+        if (syntheticBoldOffset)
+            drawGlyphMask(glyphs[i], x + syntheticBoldOffset, y);
+    }
+
+    cairo_restore(context);
+
+    if (!uncachedGlyphs.isEmpty()) {
+        cairo_set_scaled_font(context, scaledFont);
+        cairo_show_glyphs(context, uncachedGlyphs.data(), uncachedGlyphs.size());
+        if (syntheticBoldOffset) {
+            cairo_save(context);
+            cairo_translate(context, syntheticBoldOffset, 0);
+            cairo_show_glyphs(context, uncachedGlyphs.data(), uncachedGlyphs.size());
+            cairo_restore(context);
+        }
+    }
+
+    return true;
+}
+
+void CairoGlyphCache::scaledFontDestroyed(void* scaledFont)
+{
+    CairoGlyphCache& cache = singleton();
+    auto it = cache.m_atlases.find(static_cast<cairo_scaled_font_t*>(scaledFont));
+    if (it != cache.m_atlases.end())
+        cache.removeAtlas(it);
+}
+
+CairoGlyphCache::FontAtlas& CairoGlyphCache::atlasForFont(cairo_scaled_font_t* scaledFont)
+{
+    auto& atlas = m_atlases.add(scaledFont, nullptr).iterator->value;
+    if (!atlas) {
+        atlas = std::make_unique<FontAtlas>();
+        atlas->hasColorGlyphs = hasColorGlyphs(scaledFont);
+        // Drop the masks together with the font, before cairo can hand out its address again.
+        if (!cairo_scaled_font_get_user_data(scaledFont, &glyphCacheKey))
+            cairo_scaled_font_set_user_data(scaledFont, &glyphCacheKey, scaledFont, scaledFontDestroyed);
+    }
+    return *atlas;
+}
+
+const CairoGlyphCache::GlyphMask& CairoGlyphCache::glyphMask(FontAtlas& atlas, cairo_scaled_font_t* scaledFont, unsigned glyph, unsigned subpixelPosition)
+{
+    unsigned key = glyph * subpixelPositions + subpixelPosition;
+    auto it = atlas.glyphs.find(key);
+    if (it != atlas.glyphs.end()) {
+        ++m_hitCount;
+        return it->value;
+    }
+    ++m_missCount;
+
+    GlyphMask mask;
+    cairo_glyph_t cairoGlyph = { glyph, 0, 0 };
+    cairo_text_extents_t extents;
+    cairo_scaled_font_glyph_extents(scaledFont, &cairoGlyph, 1, &extents);
+    if (extents.width > 0 && extents.height > 0) {
+        // Decided on the glyph alone, so that all subpixel positions of a glyph agree.
+        if (std::max(extents.width, extents.height) + 3 > maximumGlyphSize)
+            mask.tooLarge = true;
+        else {
+            double subpixelOffset = static_cast<double>(subpixelPosition) / subpixelPositions;
+            // A pixel of padding on each side keeps antialiased edges inside the mask.
+            int left = std::floor(extents.x_bearing + subpixelOffset) - 1;
+            int top = std::floor(extents.y_bearing) - 1;
+            int right = std::ceil(extents.x_bearing + extents.width + subpixelOffset) + 1;
+            int bottom = std::ceil(extents.y_bearing + extents.height) + 1;
+
+            mask.surface = allocateMask(atlas, right - left, bottom - top);
+            mask.offset = IntPoint(left, top);
+
+            RefPtr<cairo_t> cr = adoptRef(cairo_create(mask.surface.get()));
+            cairo_set_scaled_font(cr.get(), scaledFont);
+            cairoGlyph.x = subpixelOffset - left;
+            cairoGlyph.y = -top;
+            cairo_show_glyphs(cr.get(), &cairoGlyph, 1);
+        }
+    }
+
+    return atlas.glyphs.add(key, WTF::move(mask)).iterator->value;
+}
+
+RefPtr<cairo_surface_t> CairoGlyphCache::allocateMask(FontAtlas& atlas, int width, int height)
+{
+    ASSERT(width <= pageSize && height <= pageSize);
+
+    if (!atlas.pages.isEmpty() && atlas.shelfOrigin.x() + width > pageSize) {
+        atlas.shelfOrigin = IntPoint(0, atlas.shelfOrigin.y() + atlas.shelfHeight);
+        atlas.shelfHeight = 0;
+    }
+
+    if (atlas.pages.isEmpty() || atlas.shelfOrigin.y() + height > pageSize) {
+        pruneForNewPage(atlas);
+        atlas.pages.append(adoptRef(cairo_image_surface_create(CAIRO_FORMAT_A8, pageSize, pageSize)));
+        ++m_pageCount;
+        atlas.shelfOrigin = IntPoint();
+        atlas.shelfHeight = 0;
+    }
+
+    IntPoint location = atlas.shelfOrigin;
+    atlas.shelfOrigin.move(width, 0);
+    atlas.shelfHeight = std::max(atlas.shelfHeight, height);
+    return adoptRef(cairo_surface_create_for_rectangle(atlas.pages.last().get(), location.x(), location.y(), width, height));
+}
+
+void CairoGlyphCache::pruneForNewPage(FontAtlas& atlasInUse)
+{
+    while (size() + pageSizeInBytes > m_maximumSize) {
+        auto leastRecentlyUsed = m_atlases.end();
+        for (auto it = m_atlases.begin(), end = m_atlases.end(); it != end; ++it) {
+            if (it->value.get() == &atlasInUse)
+                continue;
+            if (leastRecentlyUsed == m_atlases.end() || it->value->lastUse < leastRecentlyUsed->value->lastUse)
+                leastRecentlyUsed = it;
+        }
+
+        if (leastRecentlyUsed == m_atlases.end()) {
+            // The font being drawn uses the whole budget on its own, so start it over.
+            m_pageCount -= atlasInUse.pages.size();
+            atlasInUse.pages.clear();
+            atlasInUse.glyphs.clear();
+            return;
+        }
+
+        removeAtlas(leastRecentlyUsed);
+    }
+}
+
+void CairoGlyphCache::removeAtlas(HashMap<cairo_scaled_font_t*, std::unique_ptr<FontAtlas>>::iterator it)
+{
+    m_pageCount -= it->value->pages.size();
+    m_atlases.remove(it);
+}
+
+void CairoGlyphCache::setMaximumSize(size_t maximumSize)
+{
+    m_maximumSize = maximumSize;
+    if (size() > m_maximumSize)
+        clear();
+}
+
+void CairoGlyphCache::clear()
+{
+    m_atlases.clear();
+    m_pageCount = 0;
+}
+
+void CairoGlyphCache::dumpStats() const
+{
+    dataLogF("%-13s %-13s %-13s %-13s %-13s %-13s\n", "", "Fonts", "Size", "Limit", "Hits", "Misses");
+    dataLogF("%-13s %13u %13zu %13zu %13u %13u\n\n", "Glyph masks", m_atlases.size(), size(), m_maximumSize, m_hitCount, m_missCount);
+}
+
+} // namespace WebCore
+
+#endif // USE(CAIRO)
@@ -0,0 +1,120 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CairoGlyphCache_h
+#define CairoGlyphCache_h
+
+#if USE(CAIRO)
+
+#include "IntPoint.h"
+#include "RefPtrCairo.h"
+#include <cairo.h>
+#include <memory>
+#include <wtf/HashMap.h>
+#include <wtf/HashTraits.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// Glyph coverage masks rasterized once per scaled font, glyph and quarter-pixel
+// horizontal position, and composited with the current source of the context
+// when text is drawn. Masks are packed into A8 atlas pages that belong to the
+// scaled font; the least recently drawn fonts lose their pages first when the
+// cache grows beyond its limit. Only image surfaces use the cache; other surfaces,
+// like Xlib windows, keep cairo's batched glyph rendering. Each glyph costs a mask
+// composite instead of being part of one cairo_show_glyphs call, so the cache is off
+// until an embedder gives it a size.
+class CairoGlyphCache {
+    WTF_MAKE_NONCOPYABLE(CairoGlyphCache); WTF_MAKE_FAST_ALLOCATED;
+    friend NeverDestroyed<CairoGlyphCache>;
+public:
+    WEBCORE_EXPORT static CairoGlyphCache& singleton();
+
+    // Returns false without drawing anything when the context or the font needs
+    // cairo's own glyph rendering, e.g. for a target that is not an image surface,
+    // a scaled or rotated transformation, subpixel antialiasing or color glyphs,
+    // which an A8 mask cannot represent.
+    bool drawGlyphs(cairo_t*, cairo_scaled_font_t*, const cairo_glyph_t*, int numGlyphs, float syntheticBoldOffset);
+
+    size_t maximumSize() const { return m_maximumSize; }
+    WEBCORE_EXPORT void setMaximumSize(size_t);
+    size_t size() const { return m_pageCount * pageSizeInBytes; }
+
+    unsigned hitCount() const { return m_hitCount; }
+    unsigned missCount() const { return m_missCount; }
+
+    WEBCORE_EXPORT void clear();
+
+    WEBCORE_EXPORT void dumpStats() const;
+
+private:
+    CairoGlyphCache() { }
+
+    static const int pageSize = 256;
+    static const size_t pageSizeInBytes = pageSize * pageSize;
+
+    struct GlyphMask {
+        // Null for glyphs that have no ink, like spaces, and for glyphs too large to cache.
+        RefPtr<cairo_surface_t> surface;
+        IntPoint offset;
+        bool tooLarge { false };
+    };
+
+    typedef HashMap<unsigned, GlyphMask, IntHash<unsigned>, WTF::UnsignedWithZeroKeyHashTraits<unsigned>> GlyphMaskMap;
+
+    struct FontAtlas {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        Vector<RefPtr<cairo_surface_t>> pages;
+        // Masks are packed in rows ("shelves") of the last page.
+        IntPoint shelfOrigin;
+        int shelfHeight { 0 };
+        GlyphMaskMap glyphs;
+        unsigned lastUse { 0 };
+        // Checked once per font; such fonts never get masks.
+        bool hasColorGlyphs { false };
+    };
+
+    static void scaledFontDestroyed(void*);
+
+    FontAtlas& atlasForFont(cairo_scaled_font_t*);
+    const GlyphMask& glyphMask(FontAtlas&, cairo_scaled_font_t*, unsigned glyph, unsigned subpixelPosition);
+    RefPtr<cairo_surface_t> allocateMask(FontAtlas&, int width, int height);
+    void pruneForNewPage(FontAtlas& atlasInUse);
+    void removeAtlas(HashMap<cairo_scaled_font_t*, std::unique_ptr<FontAtlas>>::iterator);
+
+    HashMap<cairo_scaled_font_t*, std::unique_ptr<FontAtlas>> m_atlases;
+    size_t m_maximumSize { 0 };
+    size_t m_pageCount { 0 };
+    unsigned m_useCounter { 0 };
+    unsigned m_hitCount { 0 };
+    unsigned m_missCount { 0 };
+};
+
+} // namespace WebCore
+
+#endif // USE(CAIRO)
+
+#endif // CairoGlyphCache_h
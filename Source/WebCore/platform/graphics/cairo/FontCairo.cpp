@@ -34,6 +34,7 @@
 #if USE(CAIRO)
 
 #include "AffineTransform.h"
+#include "CairoGlyphCache.h"
 #include "CairoUtilities.h"
 #include "Font.h"
 #include "GlyphBuffer.h"
@@ -49,8 +50,11 @@ namespace WebCore {
 
 static void drawGlyphsToContext(cairo_t* context, const Font* font, GlyphBufferGlyph* glyphs, int numGlyphs)
 {
-    cairo_matrix_t originalTransform;
     float syntheticBoldOffset = font->syntheticBoldOffset();
+    if (CairoGlyphCache::singleton().drawGlyphs(context, font->platformData().scaledFont(), glyphs, numGlyphs, syntheticBoldOffset))
+        return;
+
+    cairo_matrix_t originalTransform;
     if (syntheticBoldOffset)
         cairo_get_matrix(context, &originalTransform);
 
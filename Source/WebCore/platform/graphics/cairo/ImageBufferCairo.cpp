@@ -43,6 +43,7 @@
 #include <cairo.h>
 #include <runtime/JSCInlines.h>
 #include <runtime/TypedArrayInlines.h>
+#include <wtf/ParallelJobs.h>
 #include <wtf/Vector.h>
 #include <wtf/text/Base64.h>
 #include <wtf/text/WTFString.h>
@@ -202,6 +203,113 @@ PassRefPtr<cairo_surface_t> copySurfaceToImageAndAdjustRect(cairo_surface_t* sur
     return adoptRef(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, rect.width(), rect.height()));
 }
 
+struct PixelConversionParameters {
+    unsigned char* source;
+    unsigned sourceBytesPerRow;
+    unsigned char* destination;
+    unsigned destinationBytesPerRow;
+    int numRows;
+    int numColumns;
+};
+
+template <Multiply multiplied>
+static void convertRowsFromCairo(PixelConversionParameters* parameters)
+{
+    unsigned char* srcRows = parameters->source;
+    unsigned char* destRows = parameters->destination;
+    for (int y = 0; y < parameters->numRows; ++y) {
+        unsigned* row = reinterpret_cast_ptr<unsigned*>(srcRows);
+        for (int x = 0; x < parameters->numColumns; x++) {
+            int basex = x * 4;
+            unsigned* pixel = row + x;
+
+            // Avoid calling Color::colorFromPremultipliedARGB() because one
+            // function call per pixel is too expensive.
+            unsigned alpha = (*pixel & 0xFF000000) >> 24;
+            unsigned red = (*pixel & 0x00FF0000) >> 16;
+            unsigned green = (*pixel & 0x0000FF00) >> 8;
+            unsigned blue = (*pixel & 0x000000FF);
+
+            if (multiplied == Unmultiplied) {
+                if (alpha && alpha != 255) {
+                    red = red * 255 / alpha;
+                    green = green * 255 / alpha;
+                    blue = blue * 255 / alpha;
+                }
+            }
+
+            destRows[basex]     = red;
+            destRows[basex + 1] = green;
+            destRows[basex + 2] = blue;
+            destRows[basex + 3] = alpha;
+        }
+        srcRows += parameters->sourceBytesPerRow;
+        destRows += parameters->destinationBytesPerRow;
+    }
+}
+
+template <Multiply multiplied>
+static void convertRowsToCairo(PixelConversionParameters* parameters)
+{
+    unsigned char* srcRows = parameters->source;
+    unsigned char* destRows = parameters->destination;
+    for (int y = 0; y < parameters->numRows; ++y) {
+        unsigned* row = reinterpret_cast_ptr<unsigned*>(destRows);
+        for (int x = 0; x < parameters->numColumns; x++) {
+            int basex = x * 4;
+            unsigned* pixel = row + x;
+
+            // Avoid calling Color::premultipliedARGBFromColor() because one
+            // function call per pixel is too expensive.
+            unsigned red = srcRows[basex];
+            unsigned green = srcRows[basex + 1];
+            unsigned blue = srcRows[basex + 2];
+            unsigned alpha = srcRows[basex + 3];
+
+            if (multiplied == Unmultiplied) {
+                if (alpha != 255) {
+                    red = (red * alpha + 254) / 255;
+                    green = (green * alpha + 254) / 255;
+                    blue = (blue * alpha + 254) / 255;
+                }
+            }
+
+            *pixel = (alpha << 24) | red  << 16 | green  << 8 | blue;
+        }
+        srcRows += parameters->sourceBytesPerRow;
+        destRows += parameters->destinationBytesPerRow;
+    }
+}
+
+// Converting a pixel is a few times cheaper than blurring one, see minimalAreaPerParallelPixelJob.
+static const int minimalAreaPerConversionJob = 4 * minimalAreaPerParallelPixelJob;
+
+static void convertRowsInParallel(void (*convertRows)(PixelConversionParameters*), PixelConversionParameters& parameters)
+{
+    int optimalNumberOfJobs = (parameters.numRows * parameters.numColumns) / minimalAreaPerConversionJob;
+    if (optimalNumberOfJobs > 1) {
+        ParallelJobs<PixelConversionParameters> parallelJobs(convertRows, optimalNumberOfJobs);
+        int numberOfJobs = parallelJobs.numberOfJobs();
+        if (numberOfJobs > 1) {
+            const int jobSize = parameters.numRows / numberOfJobs;
+            const int jobsWithExtra = parameters.numRows % numberOfJobs;
+            int currentRow = 0;
+            for (int job = 0; job < numberOfJobs; ++job) {
+                PixelConversionParameters& jobParameters = parallelJobs.parameter(job);
+                jobParameters = parameters;
+                jobParameters.source += currentRow * parameters.sourceBytesPerRow;
+                jobParameters.destination += currentRow * parameters.destinationBytesPerRow;
+                jobParameters.numRows = job < jobsWithExtra ? jobSize + 1 : jobSize;
+                currentRow += jobParameters.numRows;
+            }
+            parallelJobs.execute();
+            return;
+        }
+    }
+
+    convertRows(&parameters);
+}
+
 template <Multiply multiplied>
 PassRefPtr<Uint8ClampedArray> getImageData(const IntRect& rect, const ImageBufferData& data, const IntSize& size)
 {
@@ -246,35 +354,14 @@ PassRefPtr<Uint8ClampedArray> getImageData(const IntRect& rect, const ImageBuffe
     int stride = cairo_image_surface_get_stride(imageSurface.get());
     unsigned destBytesPerRow = 4 * rect.width();
 
-    unsigned char* destRows = dataDst + desty * destBytesPerRow + destx * 4;
-    for (int y = 0; y < numRows; ++y) {
-        unsigned* row = reinterpret_cast_ptr<unsigned*>(dataSrc + stride * (y + originy));
-        for (int x = 0; x < numColumns; x++) {
-            int basex = x * 4;
-            unsigned* pixel = row + x + originx;
-
-            // Avoid calling Color::colorFromPremultipliedARGB() because one
-            // function call per pixel is too expensive.
-            unsigned alpha = (*pixel & 0xFF000000) >> 24;
-            unsigned red = (*pixel & 0x00FF0000) >> 16;
-            unsigned green = (*pixel & 0x0000FF00) >> 8;
-            unsigned blue = (*pixel & 0x000000FF);
-
-            if (multiplied == Unmultiplied) {
-                if (alpha && alpha != 255) {
-                    red = red * 255 / alpha;
-                    green = green * 255 / alpha;
-                    blue = blue * 255 / alpha;
-                }
-            }
-
-            destRows[basex]     = red;
-            destRows[basex + 1] = green;
-            destRows[basex + 2] = blue;
-            destRows[basex + 3] = alpha;
-        }
-        destRows += destBytesPerRow;
-    }
+    PixelConversionParameters parameters;
+    parameters.source = dataSrc + stride * originy + originx * 4;
+    parameters.sourceBytesPerRow = stride;
+    parameters.destination = dataDst + desty * destBytesPerRow + destx * 4;
+    parameters.destinationBytesPerRow = destBytesPerRow;
+    parameters.numRows = numRows;
+    parameters.numColumns = numColumns;
+    convertRowsInParallel(&convertRowsFromCairo<multiplied>, parameters);
 
     return result.release();
 }
@@ -328,32 +415,17 @@ void ImageBuffer::putByteArray(Multiply multiplied, Uint8ClampedArray* source, c
     unsigned srcBytesPerRow = 4 * sourceSize.width();
     int stride = cairo_image_surface_get_stride(imageSurface.get());
 
-    unsigned char* srcRows = source->data() + originy * srcBytesPerRow + originx * 4;
-    for (int y = 0; y < numRows; ++y) {
-        unsigned* row = reinterpret_cast_ptr<unsigned*>(pixelData + stride * (y + desty));
-        for (int x = 0; x < numColumns; x++) {
-            int basex = x * 4;
-            unsigned* pixel = row + x + destx;
-
-            // Avoid calling Color::premultipliedARGBFromColor() because one
-            // function call per pixel is too expensive.
-            unsigned red = srcRows[basex];
-            unsigned green = srcRows[basex + 1];
-            unsigned blue = srcRows[basex + 2];
-            unsigned alpha = srcRows[basex + 3];
-
-            if (multiplied == Unmultiplied) {
-                if (alpha != 255) {
-                    red = (red * alpha + 254) / 255;
-                    green = (green * alpha + 254) / 255;
-                    blue = (blue * alpha + 254) / 255;
-                }
-            }
-
-            *pixel = (alpha << 24) | red  << 16 | green  << 8 | blue;
-        }
-        srcRows += srcBytesPerRow;
-    }
+    PixelConversionParameters parameters;
+    parameters.source = source->data() + originy * srcBytesPerRow + originx * 4;
+    parameters.sourceBytesPerRow = srcBytesPerRow;
+    parameters.destination = pixelData + stride * desty + destx * 4;
+    parameters.destinationBytesPerRow = stride;
+    parameters.numRows = numRows;
+    parameters.numColumns = numColumns;
+    if (multiplied == Unmultiplied)
+        convertRowsInParallel(&convertRowsToCairo<Unmultiplied>, parameters);
+    else
+        convertRowsInParallel(&convertRowsToCairo<Premultiplied>, parameters);
 
     cairo_surface_mark_dirty_rectangle(imageSurface.get(), destx, desty, numColumns, numRows);
 
@@ -0,0 +1,120 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEBlendSSE2_h
+#define FEBlendSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "SSE2Helpers.h"
+#include <string.h>
+
+namespace WebCore {
+
+// The same arithmetic as FEBlendUtilitiesNEON, on two premultiplied pixels widened to 16 bits per channel.
+class FEBlendUtilitiesSSE2 {
+public:
+    static SSE2_FUNCTION __m128i div255(__m128i num)
+    {
+        __m128i quotient = _mm_srli_epi16(num, 8);
+        __m128i remainder = _mm_add_epi16(_mm_sub_epi16(num, _mm_mullo_epi16(_mm_set1_epi16(255), quotient)), _mm_set1_epi16(1));
+        return _mm_add_epi16(quotient, _mm_srli_epi16(remainder, 8));
+    }
+
+    static SSE2_FUNCTION __m128i normal(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i)
+    {
+        __m128i sixteenConst255 = _mm_set1_epi16(255);
+        return _mm_add_epi16(div255(_mm_mullo_epi16(_mm_sub_epi16(sixteenConst255, alphaA), pixelB)), pixelA);
+    }
+
+    static SSE2_FUNCTION __m128i multiply(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i alphaB)
+    {
+        __m128i sixteenConst255 = _mm_set1_epi16(255);
+        __m128i tmp1 = _mm_mullo_epi16(_mm_sub_epi16(sixteenConst255, alphaA), pixelB);
+        __m128i tmp2 = _mm_mullo_epi16(_mm_add_epi16(_mm_sub_epi16(sixteenConst255, alphaB), pixelB), pixelA);
+        return div255(_mm_add_epi16(tmp1, tmp2));
+    }
+
+    static SSE2_FUNCTION __m128i screen(__m128i pixelA, __m128i pixelB, __m128i, __m128i)
+    {
+        return _mm_sub_epi16(_mm_add_epi16(pixelA, pixelB), div255(_mm_mullo_epi16(pixelA, pixelB)));
+    }
+
+    static SSE2_FUNCTION __m128i darken(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i alphaB)
+    {
+        // All values are below 256, so the signed minimum is safe.
+        return _mm_min_epi16(normal(pixelA, pixelB, alphaA, alphaB), normal(pixelB, pixelA, alphaB, alphaA));
+    }
+
+    static SSE2_FUNCTION __m128i lighten(__m128i pixelA, __m128i pixelB, __m128i alphaA, __m128i alphaB)
+    {
+        return _mm_max_epi16(normal(pixelA, pixelB, alphaA, alphaB), normal(pixelB, pixelA, alphaB, alphaA));
+    }
+};
+
+template<__m128i (*blendFunction)(__m128i, __m128i, __m128i, __m128i)>
+SSE2_FUNCTION __m128i blendTwoPixelsSSE2(__m128i pixelA, __m128i pixelB)
+{
+    __m128i alphaA = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixelA, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i alphaB = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixelB, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i result = blendFunction(pixelA, pixelB, alphaA, alphaB);
+
+    // The result alpha is 255 - (255 - alphaA) * (255 - alphaB) / 255 for every blend mode.
+    __m128i sixteenConst255 = _mm_set1_epi16(255);
+    __m128i inverseAlpha = _mm_mullo_epi16(_mm_sub_epi16(sixteenConst255, alphaA), _mm_sub_epi16(sixteenConst255, alphaB));
+    __m128i alphaR = _mm_sub_epi16(sixteenConst255, FEBlendUtilitiesSSE2::div255(inverseAlpha));
+    __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    return _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, alphaR));
+}
+
+template<__m128i (*blendFunction)(__m128i, __m128i, __m128i, __m128i)>
+SSE2_FUNCTION void blendSSE2(const unsigned char* srcPixelArrayA, const unsigned char* srcPixelArrayB, unsigned char* dstPixelArray,
+    unsigned colorArrayLength)
+{
+    __m128i zero = _mm_setzero_si128();
+    unsigned colorOffset = 0;
+    for (; colorOffset + 16 <= colorArrayLength; colorOffset += 16) {
+        __m128i fourPixelsA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixelArrayA + colorOffset));
+        __m128i fourPixelsB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixelArrayB + colorOffset));
+        __m128i low = blendTwoPixelsSSE2<blendFunction>(_mm_unpacklo_epi8(fourPixelsA, zero), _mm_unpacklo_epi8(fourPixelsB, zero));
+        __m128i high = blendTwoPixelsSSE2<blendFunction>(_mm_unpackhi_epi8(fourPixelsA, zero), _mm_unpackhi_epi8(fourPixelsB, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixelArray + colorOffset), _mm_packus_epi16(low, high));
+    }
+
+    // Blend the last one to three pixels through zero padded copies.
+    unsigned remainingLength = colorArrayLength - colorOffset;
+    if (!remainingLength)
+        return;
+    unsigned char sourceA[16] = { 0 };
+    unsigned char sourceBAndDest[16] = { 0 };
+    memcpy(sourceA, srcPixelArrayA + colorOffset, remainingLength);
+    memcpy(sourceBAndDest, srcPixelArrayB + colorOffset, remainingLength);
+    blendSSE2<blendFunction>(sourceA, sourceBAndDest, sourceBAndDest, 16);
+    memcpy(dstPixelArray + colorOffset, sourceBAndDest, remainingLength);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEBlendSSE2_h
@@ -0,0 +1,93 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEColorMatrixSSE2_h
+#define FEColorMatrixSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "SSE2Helpers.h"
+
+namespace WebCore {
+
+struct ColorMatrixSSE2 {
+    __m128 redColumn;
+    __m128 greenColumn;
+    __m128 blueColumn;
+    __m128 alphaColumn;
+    __m128 offset;
+};
+
+SSE2_FUNCTION __m128i applyColorMatrixToPixelSSE2(__m128i pixel, const ColorMatrixSSE2& matrix)
+{
+    __m128 pixelAsFloat = _mm_cvtepi32_ps(pixel);
+    __m128 red = _mm_shuffle_ps(pixelAsFloat, pixelAsFloat, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 green = _mm_shuffle_ps(pixelAsFloat, pixelAsFloat, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 blue = _mm_shuffle_ps(pixelAsFloat, pixelAsFloat, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 alpha = _mm_shuffle_ps(pixelAsFloat, pixelAsFloat, _MM_SHUFFLE(3, 3, 3, 3));
+
+    // Summed in the same order as matrix() in FEColorMatrix.cpp.
+    __m128 result = _mm_mul_ps(matrix.redColumn, red);
+    result = _mm_add_ps(result, _mm_mul_ps(matrix.greenColumn, green));
+    result = _mm_add_ps(result, _mm_mul_ps(matrix.blueColumn, blue));
+    result = _mm_add_ps(result, _mm_mul_ps(matrix.alphaColumn, alpha));
+    result = _mm_add_ps(result, matrix.offset);
+
+    // Round to nearest like Uint8ClampedArray::set(); packing clamps to 0..255.
+    return _mm_cvtps_epi32(result);
+}
+
+// Applies the 5x4 row-major matrix of feColorMatrix type 'matrix' to unpremultiplied RGBA8 pixels in place.
+SSE2_FUNCTION void colorMatrixSSE2(unsigned char* pixelArray, unsigned pixelArrayLength, const float values[20])
+{
+    ColorMatrixSSE2 matrix;
+    matrix.redColumn = _mm_setr_ps(values[0], values[5], values[10], values[15]);
+    matrix.greenColumn = _mm_setr_ps(values[1], values[6], values[11], values[16]);
+    matrix.blueColumn = _mm_setr_ps(values[2], values[7], values[12], values[17]);
+    matrix.alphaColumn = _mm_setr_ps(values[3], values[8], values[13], values[18]);
+    matrix.offset = _mm_mul_ps(_mm_setr_ps(values[4], values[9], values[14], values[19]), _mm_set1_ps(255));
+
+    unsigned colorOffset = 0;
+    for (; colorOffset + 16 <= pixelArrayLength; colorOffset += 16) {
+        __m128i* fourPixels = reinterpret_cast<__m128i*>(pixelArray + colorOffset);
+        __m128i pixel0, pixel1, pixel2, pixel3;
+        unpackRGBA8x4AsInt32(_mm_loadu_si128(fourPixels), pixel0, pixel1, pixel2, pixel3);
+        __m128i result = packInt32x4AsRGBA8(
+            applyColorMatrixToPixelSSE2(pixel0, matrix),
+            applyColorMatrixToPixelSSE2(pixel1, matrix),
+            applyColorMatrixToPixelSSE2(pixel2, matrix),
+            applyColorMatrixToPixelSSE2(pixel3, matrix));
+        _mm_storeu_si128(fourPixels, result);
+    }
+
+    for (; colorOffset < pixelArrayLength; colorOffset += 4) {
+        uint32_t* pixel = reinterpret_cast<uint32_t*>(pixelArray + colorOffset);
+        storeInt32AsRGBA8(applyColorMatrixToPixelSSE2(loadRGBA8AsInt32(pixel), matrix), pixel);
+    }
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEColorMatrixSSE2_h
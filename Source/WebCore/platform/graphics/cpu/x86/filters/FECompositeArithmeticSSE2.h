@@ -0,0 +1,105 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FECompositeArithmeticSSE2_h
+#define FECompositeArithmeticSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "SSE2Helpers.h"
+
+namespace WebCore {
+
+template <int b1, int b4>
+SSE2_FUNCTION __m128i computeArithmeticPixelSSE2(__m128i sourcePixel, __m128i destinationPixel, __m128 k1x4, __m128 k2x4, __m128 k3x4, __m128 k4x4)
+{
+    __m128 sourcePixelAsFloat = _mm_cvtepi32_ps(sourcePixel);
+    __m128 destinationPixelAsFloat = _mm_cvtepi32_ps(destinationPixel);
+
+    __m128 result = _mm_add_ps(_mm_mul_ps(k2x4, sourcePixelAsFloat), _mm_mul_ps(k3x4, destinationPixelAsFloat));
+    if (b1)
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(k1x4, sourcePixelAsFloat), destinationPixelAsFloat));
+    if (b4)
+        result = _mm_add_ps(result, k4x4);
+
+    // Truncate like computeArithmeticPixels(); packing clamps to 0..255.
+    return _mm_cvttps_epi32(result);
+}
+
+template <int b1, int b4>
+SSE2_FUNCTION void computeArithmeticPixelsSSE2(const unsigned char* source, unsigned char* destination,
+    unsigned pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+    __m128 k1x4 = _mm_set1_ps(k1 / 255);
+    __m128 k2x4 = _mm_set1_ps(k2);
+    __m128 k3x4 = _mm_set1_ps(k3);
+    __m128 k4x4 = _mm_set1_ps(k4 * 255);
+
+    unsigned colorOffset = 0;
+    for (; colorOffset + 16 <= pixelArrayLength; colorOffset += 16) {
+        __m128i source0, source1, source2, source3;
+        __m128i destination0, destination1, destination2, destination3;
+        unpackRGBA8x4AsInt32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + colorOffset)), source0, source1, source2, source3);
+        unpackRGBA8x4AsInt32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + colorOffset)), destination0, destination1, destination2, destination3);
+
+        __m128i result = packInt32x4AsRGBA8(
+            computeArithmeticPixelSSE2<b1, b4>(source0, destination0, k1x4, k2x4, k3x4, k4x4),
+            computeArithmeticPixelSSE2<b1, b4>(source1, destination1, k1x4, k2x4, k3x4, k4x4),
+            computeArithmeticPixelSSE2<b1, b4>(source2, destination2, k1x4, k2x4, k3x4, k4x4),
+            computeArithmeticPixelSSE2<b1, b4>(source3, destination3, k1x4, k2x4, k3x4, k4x4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + colorOffset), result);
+    }
+
+    for (; colorOffset < pixelArrayLength; colorOffset += 4) {
+        const uint32_t* sourcePixel = reinterpret_cast<const uint32_t*>(source + colorOffset);
+        uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(destination + colorOffset);
+        __m128i result = computeArithmeticPixelSSE2<b1, b4>(loadRGBA8AsInt32(sourcePixel), loadRGBA8AsInt32(destinationPixel), k1x4, k2x4, k3x4, k4x4);
+        storeInt32AsRGBA8(result, destinationPixel);
+    }
+}
+
+SSE2_FUNCTION void platformArithmeticSSE2(const unsigned char* source, unsigned char* destination,
+    unsigned pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+    if (!k4) {
+        if (!k1) {
+            computeArithmeticPixelsSSE2<0, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+            return;
+        }
+
+        computeArithmeticPixelsSSE2<1, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        return;
+    }
+
+    if (!k1) {
+        computeArithmeticPixelsSSE2<0, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        return;
+    }
+    computeArithmeticPixelsSSE2<1, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FECompositeArithmeticSSE2_h
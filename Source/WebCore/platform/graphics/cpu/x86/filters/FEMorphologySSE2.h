@@ -0,0 +1,103 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEMorphologySSE2_h
+#define FEMorphologySSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "SSE2Helpers.h"
+#include <algorithm>
+
+namespace WebCore {
+
+template<bool erode>
+SSE2_FUNCTION __m128i morphologyExtremumSSE2(__m128i a, __m128i b)
+{
+    return erode ? _mm_min_epu8(a, b) : _mm_max_epu8(a, b);
+}
+
+// Erodes or dilates rows yStart..yEnd - 1 of a premultiplied RGBA8 image. Every row first takes the
+// extremum of each column over the vertical window into columnExtrema, which is padded on both
+// sides with radiusX neutral pixels, and then the extremum of the horizontal window of that row.
+// Both passes handle all four channels of four pixels at once. columnExtrema must hold
+// width + 2 * radiusX pixels.
+template<bool erode>
+SSE2_FUNCTION void morphologySSE2(const unsigned char* srcPixelArray, unsigned char* dstPixelArray, int width, int height,
+    int radiusX, int radiusY, int yStart, int yEnd, uint32_t* columnExtrema)
+{
+    const uint32_t* sourcePixel = reinterpret_cast<const uint32_t*>(srcPixelArray);
+    uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(dstPixelArray);
+
+    const uint32_t neutral = erode ? 0xffffffff : 0;
+    std::fill(columnExtrema, columnExtrema + radiusX, neutral);
+    std::fill(columnExtrema + radiusX + width, columnExtrema + 2 * radiusX + width, neutral);
+    uint32_t* columns = columnExtrema + radiusX;
+
+    for (int y = yStart; y < yEnd; ++y) {
+        int yStartExtrema = std::max(0, y - radiusY);
+        int yEndExtrema = std::min(height - 1, y + radiusY);
+
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            const uint32_t* column = sourcePixel + yStartExtrema * width + x;
+            __m128i extremum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column));
+            for (int i = yStartExtrema + 1; i <= yEndExtrema; ++i) {
+                column += width;
+                extremum = morphologyExtremumSSE2<erode>(extremum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(column)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(columns + x), extremum);
+        }
+        for (; x < width; ++x) {
+            const uint32_t* column = sourcePixel + yStartExtrema * width + x;
+            __m128i extremum = _mm_cvtsi32_si128(*column);
+            for (int i = yStartExtrema + 1; i <= yEndExtrema; ++i) {
+                column += width;
+                extremum = morphologyExtremumSSE2<erode>(extremum, _mm_cvtsi32_si128(*column));
+            }
+            columns[x] = _mm_cvtsi128_si32(extremum);
+        }
+
+        uint32_t* destinationLine = destinationPixel + y * width;
+        for (x = 0; x + 4 <= width; x += 4) {
+            const uint32_t* window = columnExtrema + x;
+            __m128i extremum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window));
+            for (int i = 1; i <= 2 * radiusX; ++i)
+                extremum = morphologyExtremumSSE2<erode>(extremum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destinationLine + x), extremum);
+        }
+        for (; x < width; ++x) {
+            const uint32_t* window = columnExtrema + x;
+            __m128i extremum = _mm_cvtsi32_si128(*window);
+            for (int i = 1; i <= 2 * radiusX; ++i)
+                extremum = morphologyExtremumSSE2<erode>(extremum, _mm_cvtsi32_si128(window[i]));
+            destinationLine[x] = _mm_cvtsi128_si32(extremum);
+        }
+    }
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEMorphologySSE2_h
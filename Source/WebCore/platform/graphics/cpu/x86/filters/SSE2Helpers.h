@@ -0,0 +1,93 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SSE2Helpers_h
+#define SSE2Helpers_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include <emmintrin.h>
+#include <stdint.h>
+
+// x86-64 always has SSE2. 32-bit builds without -msse2 compile the kernels for SSE2 on their own
+// and only call them after checking the CPU at runtime.
+#if defined(__SSE2__)
+#define SSE2_FUNCTION inline
+#else
+#define SSE2_FUNCTION inline __attribute__((__target__("sse2")))
+#endif
+
+namespace WebCore {
+
+inline bool cpuSupportsSSE2()
+{
+#if defined(__SSE2__)
+    return true;
+#else
+    static const bool supportsSSE2 = __builtin_cpu_supports("sse2");
+    return supportsSSE2;
+#endif
+}
+
+SSE2_FUNCTION __m128i loadRGBA8AsInt32(const uint32_t* source)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i pixel = _mm_cvtsi32_si128(*source);
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(pixel, zero), zero);
+}
+
+SSE2_FUNCTION __m128 loadRGBA8AsFloat(const uint32_t* source)
+{
+    return _mm_cvtepi32_ps(loadRGBA8AsInt32(source));
+}
+
+// Values outside 0..255 are clamped.
+SSE2_FUNCTION void storeInt32AsRGBA8(__m128i data, uint32_t* destination)
+{
+    __m128i packed = _mm_packs_epi32(data, data);
+    *destination = _mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+}
+
+// Splits four RGBA8 pixels into one vector of 32-bit channels per pixel.
+SSE2_FUNCTION void unpackRGBA8x4AsInt32(__m128i pixels, __m128i& pixel0, __m128i& pixel1, __m128i& pixel2, __m128i& pixel3)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i low = _mm_unpacklo_epi8(pixels, zero);
+    __m128i high = _mm_unpackhi_epi8(pixels, zero);
+    pixel0 = _mm_unpacklo_epi16(low, zero);
+    pixel1 = _mm_unpackhi_epi16(low, zero);
+    pixel2 = _mm_unpacklo_epi16(high, zero);
+    pixel3 = _mm_unpackhi_epi16(high, zero);
+}
+
+// The inverse of unpackRGBA8x4AsInt32(). Values outside 0..255 are clamped.
+SSE2_FUNCTION __m128i packInt32x4AsRGBA8(__m128i pixel0, __m128i pixel1, __m128i pixel2, __m128i pixel3)
+{
+    return _mm_packus_epi16(_mm_packs_epi32(pixel0, pixel1), _mm_packs_epi32(pixel2, pixel3));
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // SSE2Helpers_h
@@ -0,0 +1,122 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ShadowBlurSSE2_h
+#define ShadowBlurSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "SSE2Helpers.h"
+#include <algorithm>
+
+namespace WebCore {
+
+namespace ShadowBlurSSE2 {
+
+// Lanes hold values whose products fit in 32 bits; SSE2 has no 32-bit mullo.
+SSE2_FUNCTION __m128i multiply(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_or_si128(_mm_and_si128(even, _mm_set_epi32(0, -1, 0, -1)), _mm_slli_epi64(odd, 32));
+}
+
+// The four columns are adjacent, so each row of them is a single 16-byte load.
+SSE2_FUNCTION __m128i loadChannel(const unsigned char* pixels, __m128i channelShift)
+{
+    __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    return _mm_and_si128(_mm_srl_epi32(data, channelShift), _mm_set1_epi32(0xff));
+}
+
+SSE2_FUNCTION void storeChannel(unsigned char* pixels, __m128i values, __m128i channelShift, __m128i otherChannels)
+{
+    __m128i* destination = reinterpret_cast<__m128i*>(pixels);
+    __m128i data = _mm_and_si128(_mm_loadu_si128(destination), otherChannels);
+    _mm_storeu_si128(destination, _mm_or_si128(data, _mm_sll_epi32(values, channelShift)));
+}
+
+} // namespace ShadowBlurSSE2
+
+// The three box-blur passes of blurLines() in ShadowBlur.cpp for four adjacent columns at
+// once, one column per lane. Each pass blurs the alpha accumulated in one channel into the
+// next one (3, 0, 1, then 3), so the passes run in place. lobes[pass][0] and lobes[pass][1]
+// are the left and right lobes, and the fixed-point arithmetic is the same as blurLines(),
+// so both produce the same bytes. Only the vertical pass uses it: walking down a column
+// touches a new cache line for every pixel, whereas the rows of the horizontal pass are
+// already contiguous.
+SSE2_FUNCTION void blurFourColumnsSSE2(unsigned char* pixels, int stride, int dim, const int (*lobes)[2], int sumShift)
+{
+    using namespace ShadowBlurSSE2;
+
+    static const int channels[4] = { 3, 0, 1, 3 };
+
+    for (int step = 0; step < 3; ++step) {
+        int side1 = lobes[step][0];
+        int side2 = lobes[step][1];
+        int pixelCount = side1 + 1 + side2;
+        __m128i invCount = _mm_set1_epi32(((1 << sumShift) + pixelCount - 1) / pixelCount);
+        __m128i shift = _mm_cvtsi32_si128(sumShift);
+        __m128i inputShift = _mm_cvtsi32_si128(channels[step] * 8);
+        __m128i outputShift = _mm_cvtsi32_si128(channels[step + 1] * 8);
+        __m128i otherChannels = _mm_set1_epi32(static_cast<int>(~(0xffu << (channels[step + 1] * 8))));
+
+        __m128i alpha1 = loadChannel(pixels, inputShift);
+        __m128i alpha2 = loadChannel(pixels + (dim - 1) * stride, inputShift);
+
+        __m128i sum = multiply(alpha1, _mm_set1_epi32(side1 + 1));
+        int limit = std::min(dim, side2 + 1);
+        for (int i = 1; i < limit; ++i)
+            sum = _mm_add_epi32(sum, loadChannel(pixels + i * stride, inputShift));
+
+        if (limit <= side2)
+            sum = _mm_add_epi32(sum, multiply(alpha2, _mm_set1_epi32(side2 - limit + 1)));
+
+        int i = 0;
+        int ofs = 1 + side2;
+        limit = std::min(side1, dim);
+        for (; i < limit; ++i, ++ofs) {
+            storeChannel(pixels + i * stride, _mm_srl_epi32(multiply(sum, invCount), shift), outputShift, otherChannels);
+            __m128i next = ofs < dim ? loadChannel(pixels + ofs * stride, inputShift) : alpha2;
+            sum = _mm_add_epi32(sum, _mm_sub_epi32(next, alpha1));
+        }
+
+        for (; ofs < dim; ++i, ++ofs) {
+            storeChannel(pixels + i * stride, _mm_srl_epi32(multiply(sum, invCount), shift), outputShift, otherChannels);
+            __m128i next = loadChannel(pixels + ofs * stride, inputShift);
+            __m128i prev = loadChannel(pixels + (i - side1) * stride, inputShift);
+            sum = _mm_add_epi32(sum, _mm_sub_epi32(next, prev));
+        }
+
+        for (; i < dim; ++i) {
+            storeChannel(pixels + i * stride, _mm_srl_epi32(multiply(sum, invCount), shift), outputShift, otherChannels);
+            __m128i prev = loadChannel(pixels + (i - side1) * stride, inputShift);
+            sum = _mm_add_epi32(sum, _mm_sub_epi32(alpha2, prev));
+        }
+    }
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // ShadowBlurSSE2_h
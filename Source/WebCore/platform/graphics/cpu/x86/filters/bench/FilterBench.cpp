@@ -0,0 +1,353 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Times the SSE2 filter kernels against scalar versions of the loops in
+// platform/graphics/filters and ShadowBlur on a random premultiplied image, and checks that
+// both produce the same pixels. The kernels are header only, so this builds
+// without the rest of WebCore: make filter-bench && ./filter-bench [width height].
+
+#include <wtf/Platform.h>
+
+#include "FEBlendSSE2.h"
+#include "FEColorMatrixSSE2.h"
+#include "FECompositeArithmeticSSE2.h"
+#include "FEGaussianBlurSSE2.h"
+#include "FEMorphologySSE2.h"
+#include "ShadowBlurSSE2.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#if !HAVE(X86_SSE2_INTRINSICS)
+#error "The filter benchmark needs an x86 compiler with SSE2 intrinsics."
+#endif
+
+using namespace WebCore;
+
+namespace {
+
+typedef std::vector<unsigned char> Pixels;
+
+// Deterministic, so every run sees the same image.
+class Random {
+public:
+    explicit Random(unsigned seed) : m_state(seed * 2654435761u + 1) { }
+
+    unsigned next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+private:
+    unsigned m_state;
+};
+
+Pixels randomPremultipliedImage(int width, int height, unsigned seed)
+{
+    Random random(seed);
+    Pixels pixels(width * height * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        unsigned alpha = random.next() % 256;
+        for (int channel = 0; channel < 3; ++channel)
+            pixels[i + channel] = random.next() % (alpha + 1);
+        pixels[i + 3] = alpha;
+    }
+    return pixels;
+}
+
+// Scalar versions of the generic loops in platform/graphics/filters.
+
+void boxBlurScalar(const unsigned char* srcData, unsigned char* dstData, unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+    const int maxKernelSize = std::min(dxRight, effectWidth);
+    for (int y = 0; y < effectHeight; ++y) {
+        int line = y * strideLine;
+        int sum[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < maxKernelSize; ++i) {
+            for (int channel = 0; channel < 4; ++channel)
+                sum[channel] += srcData[line + i * stride + channel];
+        }
+        for (int x = 0; x < effectWidth; ++x) {
+            unsigned pixelByteOffset = line + x * stride;
+            for (int channel = 0; channel < 4; ++channel)
+                dstData[pixelByteOffset + channel] = static_cast<unsigned char>(sum[channel] / dx);
+            if (x >= dxLeft) {
+                for (int channel = 0; channel < 4; ++channel)
+                    sum[channel] -= srcData[pixelByteOffset - dxLeft * stride + channel];
+            }
+            if (x + dxRight < effectWidth) {
+                for (int channel = 0; channel < 4; ++channel)
+                    sum[channel] += srcData[pixelByteOffset + dxRight * stride + channel];
+            }
+        }
+    }
+}
+
+// blurLines() from ShadowBlur.cpp: three box blurs of the alpha, chained through channels 3, 0, 1 and 3.
+void shadowBlurLinesScalar(unsigned char* pixels, int numberOfLines, int delta, int stride, int dim, const int (*lobes)[2])
+{
+    const int channels[4] = { 3, 0, 1, 3 };
+    for (int j = 0; j < numberOfLines; ++j, pixels += delta) {
+        for (int step = 0; step < 3; ++step) {
+            int side1 = lobes[step][0];
+            int side2 = lobes[step][1];
+            int pixelCount = side1 + 1 + side2;
+            int invCount = ((1 << 15) + pixelCount - 1) / pixelCount;
+            int ofs = 1 + side2;
+            int alpha1 = pixels[channels[step]];
+            int alpha2 = pixels[(dim - 1) * stride + channels[step]];
+
+            unsigned char* ptr = pixels + channels[step + 1];
+            unsigned char* prev = pixels + stride + channels[step];
+            unsigned char* next = pixels + ofs * stride + channels[step];
+
+            int i;
+            int sum = side1 * alpha1 + alpha1;
+            int limit = (dim < side2 + 1) ? dim : side2 + 1;
+            for (i = 1; i < limit; ++i, prev += stride)
+                sum += *prev;
+            if (limit <= side2)
+                sum += (side2 - limit + 1) * alpha2;
+
+            limit = (side1 < dim) ? side1 : dim;
+            for (i = 0; i < limit; ptr += stride, next += stride, ++i, ++ofs) {
+                *ptr = (sum * invCount) >> 15;
+                sum += ((ofs < dim) ? *next : alpha2) - alpha1;
+            }
+            prev = pixels + channels[step];
+            for (; ofs < dim; ptr += stride, prev += stride, next += stride, ++i, ++ofs) {
+                *ptr = (sum * invCount) >> 15;
+                sum += (*next) - (*prev);
+            }
+            for (; i < dim; ptr += stride, prev += stride, ++i) {
+                *ptr = (sum * invCount) >> 15;
+                sum += alpha2 - (*prev);
+            }
+        }
+    }
+}
+
+void shadowBlurLinesSSE2(unsigned char* pixels, int numberOfLines, int delta, int stride, int dim, const int (*lobes)[2])
+{
+    int j = 0;
+    if (delta == 4) {
+        for (; j + 4 <= numberOfLines; j += 4, pixels += 4 * delta)
+            blurFourColumnsSSE2(pixels, stride, dim, lobes, 15);
+    }
+    shadowBlurLinesScalar(pixels, numberOfLines - j, delta, stride, dim, lobes);
+}
+
+void blendNormalScalar(const unsigned char* sourceA, const unsigned char* sourceB, unsigned char* destination, unsigned length)
+{
+    for (unsigned offset = 0; offset < length; offset += 4) {
+        unsigned alphaA = sourceA[offset + 3];
+        unsigned alphaB = sourceB[offset + 3];
+        for (int channel = 0; channel < 3; ++channel)
+            destination[offset + channel] = (255 - alphaA) * sourceB[offset + channel] / 255 + sourceA[offset + channel];
+        destination[offset + 3] = 255 - (255 - alphaA) * (255 - alphaB) / 255;
+    }
+}
+
+void arithmeticScalar(const unsigned char* source, unsigned char* destination, unsigned length, float k1, float k2, float k3, float k4)
+{
+    float scaledK1 = k1 / 255.0f;
+    float scaledK4 = k4 * 255.0f;
+    for (unsigned i = 0; i < length; ++i) {
+        float result = k2 * source[i] + k3 * destination[i];
+        result += scaledK1 * source[i] * destination[i];
+        result += scaledK4;
+        if (result <= 0)
+            destination[i] = 0;
+        else if (result >= 255)
+            destination[i] = 255;
+        else
+            destination[i] = result;
+    }
+}
+
+void colorMatrixScalar(unsigned char* pixels, unsigned length, const float values[20])
+{
+    for (unsigned offset = 0; offset < length; offset += 4) {
+        float red = pixels[offset];
+        float green = pixels[offset + 1];
+        float blue = pixels[offset + 2];
+        float alpha = pixels[offset + 3];
+        for (int row = 0; row < 4; ++row) {
+            const float* v = values + row * 5;
+            float result = v[0] * red + v[1] * green + v[2] * blue + v[3] * alpha + v[4] * 255;
+            pixels[offset + row] = std::isnan(result) || result < 0 ? 0 : result > 255 ? 255 : static_cast<unsigned char>(lrint(result));
+        }
+    }
+}
+
+void erodeScalar(const unsigned char* source, unsigned char* destination, int width, int height, int radiusX, int radiusY)
+{
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int channel = 0; channel < 4; ++channel) {
+                unsigned char extremum = 255;
+                for (int i = std::max(0, y - radiusY); i <= std::min(height - 1, y + radiusY); ++i) {
+                    for (int j = std::max(0, x - radiusX); j <= std::min(width - 1, x + radiusX); ++j)
+                        extremum = std::min(extremum, source[(i * width + j) * 4 + channel]);
+                }
+                destination[(y * width + x) * 4 + channel] = extremum;
+            }
+        }
+    }
+}
+
+double millisecondsPerRun(const std::function<void()>& function)
+{
+    function();
+    unsigned runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> elapsed;
+    do {
+        function();
+        ++runs;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 500);
+    return elapsed.count() / runs;
+}
+
+int maximumDifference(const Pixels& a, const Pixels& b)
+{
+    int difference = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    return difference;
+}
+
+bool report(const char* name, double scalar, double sse2, const Pixels& expected, const Pixels& actual)
+{
+    int difference = maximumDifference(expected, actual);
+    printf("%-24s %10.3f %10.3f %8.2fx %6d\n", name, scalar, sse2, scalar / sse2, difference);
+    return difference <= 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int width = argc > 2 ? atoi(argv[1]) : 1024;
+    int height = argc > 2 ? atoi(argv[2]) : 768;
+    if (width <= 0 || height <= 0) {
+        fprintf(stderr, "usage: %s [width height]\n", argv[0]);
+        return 1;
+    }
+    if (!cpuSupportsSSE2()) {
+        fprintf(stderr, "This CPU does not support SSE2.\n");
+        return 1;
+    }
+
+    unsigned length = width * height * 4;
+    Pixels imageA = randomPremultipliedImage(width, height, 1);
+    Pixels imageB = randomPremultipliedImage(width, height, 2);
+    Pixels expected(length);
+    Pixels actual(length);
+    bool matches = true;
+
+    printf("%dx%d pixels\n", width, height);
+    printf("%-24s %10s %10s %9s %6s\n", "kernel", "scalar ms", "SSE2 ms", "speedup", "diff");
+
+    unsigned kernelSize = 21;
+    int dxLeft = kernelSize / 2;
+    int dxRight = kernelSize - dxLeft;
+    double scalar = millisecondsPerRun([&] {
+        boxBlurScalar(imageA.data(), expected.data(), kernelSize, dxLeft, dxRight, 4, width * 4, width, height);
+        boxBlurScalar(expected.data(), imageB.data(), kernelSize, dxLeft, dxRight, width * 4, 4, height, width);
+    });
+    Pixels blurredScalar = imageB;
+    imageB = randomPremultipliedImage(width, height, 2);
+    double sse2 = millisecondsPerRun([&] {
+        boxBlurSSE2(imageA.data(), actual.data(), kernelSize, dxLeft, dxRight, 4, width * 4, width, height);
+        boxBlurSSE2(actual.data(), imageB.data(), kernelSize, dxLeft, dxRight, width * 4, 4, height, width);
+    });
+    matches &= report("box blur (21x21)", scalar, sse2, blurredScalar, imageB);
+    imageB = randomPremultipliedImage(width, height, 2);
+
+    // An even diameter, so the lobes of the three passes differ.
+    const int lobes[3][2] = { { 8, 7 }, { 7, 8 }, { 8, 8 } };
+    scalar = millisecondsPerRun([&] {
+        std::copy(imageA.begin(), imageA.end(), expected.begin());
+        shadowBlurLinesScalar(expected.data(), height, width * 4, 4, width, lobes);
+        shadowBlurLinesScalar(expected.data(), width, 4, width * 4, height, lobes);
+    });
+    sse2 = millisecondsPerRun([&] {
+        std::copy(imageA.begin(), imageA.end(), actual.begin());
+        shadowBlurLinesSSE2(actual.data(), height, width * 4, 4, width, lobes);
+        shadowBlurLinesSSE2(actual.data(), width, 4, width * 4, height, lobes);
+    });
+    matches &= report("shadow blur (d=16)", scalar, sse2, expected, actual);
+
+    scalar = millisecondsPerRun([&] { blendNormalScalar(imageA.data(), imageB.data(), expected.data(), length); });
+    sse2 = millisecondsPerRun([&] { blendSSE2<FEBlendUtilitiesSSE2::normal>(imageA.data(), imageB.data(), actual.data(), length); });
+    matches &= report("blend normal", scalar, sse2, expected, actual);
+
+    const float k1 = 0.5f, k2 = 0.25f, k3 = 0.75f, k4 = -0.125f;
+    scalar = millisecondsPerRun([&] {
+        std::copy(imageB.begin(), imageB.end(), expected.begin());
+        arithmeticScalar(imageA.data(), expected.data(), length, k1, k2, k3, k4);
+    });
+    sse2 = millisecondsPerRun([&] {
+        std::copy(imageB.begin(), imageB.end(), actual.begin());
+        platformArithmeticSSE2(imageA.data(), actual.data(), length, k1, k2, k3, k4);
+    });
+    matches &= report("composite arithmetic", scalar, sse2, expected, actual);
+
+    const float sepia[20] = {
+        0.393f, 0.769f, 0.189f, 0, 0,
+        0.349f, 0.686f, 0.168f, 0, 0,
+        0.272f, 0.534f, 0.131f, 0, 0,
+        0, 0, 0, 1, 0
+    };
+    scalar = millisecondsPerRun([&] {
+        std::copy(imageA.begin(), imageA.end(), expected.begin());
+        colorMatrixScalar(expected.data(), length, sepia);
+    });
+    sse2 = millisecondsPerRun([&] {
+        std::copy(imageA.begin(), imageA.end(), actual.begin());
+        colorMatrixSSE2(actual.data(), length, sepia);
+    });
+    matches &= report("color matrix", scalar, sse2, expected, actual);
+
+    int radius = 3;
+    std::vector<uint32_t> columnExtrema(width + 2 * radius);
+    scalar = millisecondsPerRun([&] { erodeScalar(imageA.data(), expected.data(), width, height, radius, radius); });
+    sse2 = millisecondsPerRun([&] { morphologySSE2<true>(imageA.data(), actual.data(), width, height, radius, radius, 0, height, columnExtrema.data()); });
+    matches &= report("morphology erode (7x7)", scalar, sse2, expected, actual);
+
+    if (!matches) {
+        fprintf(stderr, "SSE2 results differ from the scalar loops.\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DisplayList.h"
+
+#include "TextStream.h"
+
+namespace WebCore {
+namespace DisplayList {
+
+void DisplayList::clear()
+{
+    m_list.clear();
+}
+
+Optional<FloatRect> DisplayList::extent() const
+{
+    FloatRect result;
+    for (const auto& item : m_list) {
+        if (!item->isDrawingItem())
+            continue;
+
+        const Optional<FloatRect>& itemExtent = static_cast<const DrawingItem&>(item.get()).extent();
+        if (!itemExtent)
+            return Nullopt;
+        result.unite(itemExtent.value());
+    }
+    return result;
+}
+
+String DisplayList::description() const
+{
+    TextStream ts;
+    for (size_t i = 0; i < m_list.size(); ++i)
+        ts << i << ": " << m_list[i].get() << "\n";
+    return ts.release();
+}
+
+} // namespace DisplayList
+} // namespace WebCore
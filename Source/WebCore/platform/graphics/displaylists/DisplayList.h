@@ -0,0 +1,69 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DisplayList_h
+#define DisplayList_h
+
+#include "DisplayListItems.h"
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+namespace DisplayList {
+
+// A sequence of GraphicsContext operations, filled in by a Recorder and played back into a real
+// context by a Replayer. The items keep the images, fonts and gradients they use alive, so a list
+// can be replayed after the render tree that produced it has changed.
+class DisplayList {
+    WTF_MAKE_NONCOPYABLE(DisplayList); WTF_MAKE_FAST_ALLOCATED;
+    friend class Recorder;
+public:
+    DisplayList() { }
+
+    WEBCORE_EXPORT void clear();
+    bool isEmpty() const { return m_list.isEmpty(); }
+    size_t itemCount() const { return m_list.size(); }
+
+    const Item& itemAt(size_t index) const { return m_list[index].get(); }
+
+    // The union of the extents of all drawing items, or Nullopt if one of them has none.
+    Optional<FloatRect> extent() const;
+
+    // One line per item with the extent of each drawing item, for logging what a paint did.
+    WEBCORE_EXPORT String description() const;
+
+private:
+    Item& append(Ref<Item>&& item)
+    {
+        m_list.append(WTF::move(item));
+        return m_list.last().get();
+    }
+
+    Vector<Ref<Item>> m_list;
+};
+
+} // namespace DisplayList
+} // namespace WebCore
+
+#endif // DisplayList_h
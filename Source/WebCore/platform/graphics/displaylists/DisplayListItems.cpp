@@ -0,0 +1,508 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DisplayListItems.h"
+
+#include "TextStream.h"
+
+namespace WebCore {
+namespace DisplayList {
+
+// Miter joins can reach miterLimit * thickness / 2 past the geometry; this covers the
+// default limit of 10 without having to track the current one.
+static inline FloatRect inflatedForStroke(const FloatRect& rect, float strokeThickness)
+{
+    FloatRect result = rect;
+    result.inflate(std::max(strokeThickness, 1.f) * 5);
+    return result;
+}
+
+static FloatRect boundsOfPoints(const Vector<FloatPoint>& points)
+{
+    FloatRect result;
+    if (points.isEmpty())
+        return result;
+
+    result.setLocation(points[0]);
+    for (size_t i = 1; i < points.size(); ++i)
+        result.extend(points[i]);
+    return result;
+}
+
+void Save::apply(GraphicsContext& context) const
+{
+    context.save();
+}
+
+void Restore::apply(GraphicsContext& context) const
+{
+    context.restore();
+}
+
+void Translate::apply(GraphicsContext& context) const
+{
+    context.translate(m_x, m_y);
+}
+
+void Rotate::apply(GraphicsContext& context) const
+{
+    context.rotate(m_angle);
+}
+
+void Scale::apply(GraphicsContext& context) const
+{
+    context.scale(m_size);
+}
+
+void ConcatenateCTM::apply(GraphicsContext& context) const
+{
+    context.concatCTM(m_transform);
+}
+
+void SetCTM::apply(GraphicsContext& context) const
+{
+    context.setCTM(m_transform);
+}
+
+void SetState::apply(GraphicsContext& context) const
+{
+    context.setStrokeThickness(m_state.strokeThickness);
+    context.setStrokeStyle(m_state.strokeStyle);
+    context.setStrokeColor(m_state.strokeColor, m_state.strokeColorSpace);
+    if (m_state.strokeGradient)
+        context.setStrokeGradient(*m_state.strokeGradient);
+    else if (m_state.strokePattern)
+        context.setStrokePattern(*m_state.strokePattern);
+
+    context.setFillRule(m_state.fillRule);
+    context.setFillColor(m_state.fillColor, m_state.fillColorSpace);
+    if (m_state.fillGradient)
+        context.setFillGradient(*m_state.fillGradient);
+    else if (m_state.fillPattern)
+        context.setFillPattern(*m_state.fillPattern);
+
+    // Must precede setShadow(), which interprets the offset differently when transforms are ignored.
+    context.setShadowsIgnoreTransforms(m_state.shadowsIgnoreTransforms);
+    if (m_state.shadowColor.isValid())
+        context.setShadow(m_state.shadowOffset, m_state.shadowBlur, m_state.shadowColor, m_state.shadowColorSpace);
+    else
+        context.clearShadow();
+
+    context.setTextDrawingMode(m_state.textDrawingMode);
+    context.setAlpha(m_state.alpha);
+    context.setCompositeOperation(m_state.compositeOperator, m_state.blendMode);
+    context.setShouldAntialias(m_state.shouldAntialias);
+    context.setShouldSmoothFonts(m_state.shouldSmoothFonts);
+    context.setAntialiasedFontDilationEnabled(m_state.antialiasedFontDilationEnabled);
+    context.setShouldSubpixelQuantizeFonts(m_state.shouldSubpixelQuantizeFonts);
+    context.setDrawLuminanceMask(m_state.drawLuminanceMask);
+}
+
+void SetLineCap::apply(GraphicsContext& context) const
+{
+    context.setLineCap(m_lineCap);
+}
+
+void SetLineDash::apply(GraphicsContext& context) const
+{
+    context.setLineDash(m_dashArray, m_dashOffset);
+}
+
+void SetLineJoin::apply(GraphicsContext& context) const
+{
+    context.setLineJoin(m_lineJoin);
+}
+
+void SetMiterLimit::apply(GraphicsContext& context) const
+{
+    context.setMiterLimit(m_miterLimit);
+}
+
+void SetImageInterpolationQuality::apply(GraphicsContext& context) const
+{
+    context.setImageInterpolationQuality(m_quality);
+}
+
+void Clip::apply(GraphicsContext& context) const
+{
+    context.clip(m_rect);
+}
+
+void ClipOut::apply(GraphicsContext& context) const
+{
+    context.clipOut(m_rect);
+}
+
+void ClipOutToPath::apply(GraphicsContext& context) const
+{
+    context.clipOut(m_path);
+}
+
+void ClipPath::apply(GraphicsContext& context) const
+{
+    context.clip(m_path, m_windRule);
+}
+
+ClipConvexPolygon::ClipConvexPolygon(size_t numPoints, const FloatPoint* points, bool antialias)
+    : Item(ItemType::ClipConvexPolygon)
+    , m_antialias(antialias)
+{
+    m_points.append(points, numPoints);
+}
+
+void ClipConvexPolygon::apply(GraphicsContext& context) const
+{
+    context.clipConvexPolygon(m_points.size(), m_points.data(), m_antialias);
+}
+
+void ClipToImageBuffer::apply(GraphicsContext& context) const
+{
+    context.clipToImageBuffer(m_buffer.get(), m_destination);
+}
+
+void BeginTransparencyLayer::apply(GraphicsContext& context) const
+{
+    context.beginTransparencyLayer(m_opacity);
+}
+
+void EndTransparencyLayer::apply(GraphicsContext& context) const
+{
+    context.endTransparencyLayer();
+}
+
+DrawGlyphs::DrawGlyphs(const FontCascade& fontCascade, const Font& font, const GlyphBuffer& glyphBuffer, int from, int numGlyphs, const FloatPoint& point)
+    : DrawingItem(ItemType::DrawGlyphs)
+    , m_fontCascade(fontCascade)
+    , m_font(const_cast<Font&>(font))
+    , m_point(point)
+{
+    for (int i = from; i < from + numGlyphs; ++i)
+        m_glyphBuffer.add(glyphBuffer.glyphAt(i), glyphBuffer.fontAt(i), glyphBuffer.advanceAt(i));
+}
+
+void DrawGlyphs::apply(GraphicsContext& context) const
+{
+    context.drawGlyphs(m_fontCascade, m_font.get(), m_glyphBuffer, 0, m_glyphBuffer.size(), m_point);
+}
+
+Optional<FloatRect> DrawGlyphs::localBounds(const GraphicsContext& context) const
+{
+    float width = 0;
+    for (int i = 0; i < m_glyphBuffer.size(); ++i)
+        width += m_glyphBuffer.advanceAt(i).width();
+
+    // Advances don't bound the ink: leave room for overhanging italics and marks above the ascent.
+    const FontMetrics& metrics = m_font->fontMetrics();
+    float ascent = metrics.floatAscent();
+    float descent = metrics.floatDescent();
+    FloatRect bounds(m_point.x(), m_point.y() - ascent, width, ascent + descent);
+    bounds.inflate(ascent);
+
+    if (context.textDrawingMode() & TextModeStroke)
+        bounds.inflate(context.strokeThickness());
+    return bounds;
+}
+
+void DrawImage::apply(GraphicsContext& context) const
+{
+    context.drawImage(const_cast<Image*>(&m_image.get()), m_colorSpace, m_destination, m_source, m_options);
+}
+
+void DrawTiledImage::apply(GraphicsContext& context) const
+{
+    context.drawTiledImage(const_cast<Image*>(&m_image.get()), m_colorSpace, m_destination, m_source, m_tileSize, m_options);
+}
+
+void DrawTiledScaledImage::apply(GraphicsContext& context) const
+{
+    context.drawTiledImage(const_cast<Image*>(&m_image.get()), m_colorSpace, m_destination, m_source, m_tileScaleFactor, m_hRule, m_vRule, m_options);
+}
+
+void DrawRect::apply(GraphicsContext& context) const
+{
+    context.drawRect(m_rect, m_borderThickness);
+}
+
+void DrawLine::apply(GraphicsContext& context) const
+{
+    context.drawLine(m_point1, m_point2);
+}
+
+Optional<FloatRect> DrawLine::localBounds(const GraphicsContext& context) const
+{
+    FloatRect bounds(m_point1, FloatSize());
+    bounds.extend(m_point2);
+    bounds.inflate(std::max(context.strokeThickness(), 1.f));
+    return bounds;
+}
+
+void DrawLinesForText::apply(GraphicsContext& context) const
+{
+    context.drawLinesForText(m_point, m_widths, m_printing, m_doubleLines);
+}
+
+Optional<FloatRect> DrawLinesForText::localBounds(const GraphicsContext& context) const
+{
+    if (m_widths.isEmpty())
+        return FloatRect();
+
+    // The lines may be snapped to the next device pixel and double lines sit one thickness apart.
+    float thickness = std::max(context.strokeThickness(), 0.5f);
+    FloatRect bounds(m_point.x(), m_point.y(), m_widths.last(), m_doubleLines ? 3 * thickness : thickness);
+    bounds.inflate(1);
+    return bounds;
+}
+
+void DrawLineForDocumentMarker::apply(GraphicsContext& context) const
+{
+    context.drawLineForDocumentMarker(m_point, m_width, m_style);
+}
+
+Optional<FloatRect> DrawLineForDocumentMarker::localBounds(const GraphicsContext&) const
+{
+    FloatRect bounds(m_point.x(), m_point.y(), m_width, cMisspellingLineThickness);
+    bounds.inflate(cMisspellingLineThickness);
+    return bounds;
+}
+
+void DrawEllipse::apply(GraphicsContext& context) const
+{
+    context.drawEllipse(m_rect);
+}
+
+Optional<FloatRect> DrawEllipse::localBounds(const GraphicsContext& context) const
+{
+    FloatRect bounds = m_rect;
+    bounds.inflate(context.strokeThickness());
+    return bounds;
+}
+
+DrawConvexPolygon::DrawConvexPolygon(size_t numPoints, const FloatPoint* points, bool antialias)
+    : DrawingItem(ItemType::DrawConvexPolygon)
+    , m_antialias(antialias)
+{
+    m_points.append(points, numPoints);
+}
+
+void DrawConvexPolygon::apply(GraphicsContext& context) const
+{
+    context.drawConvexPolygon(m_points.size(), m_points.data(), m_antialias);
+}
+
+Optional<FloatRect> DrawConvexPolygon::localBounds(const GraphicsContext& context) const
+{
+    return inflatedForStroke(boundsOfPoints(m_points), context.strokeThickness());
+}
+
+void DrawFocusRingPath::apply(GraphicsContext& context) const
+{
+    context.drawFocusRing(m_path, m_width, m_offset, m_color);
+}
+
+Optional<FloatRect> DrawFocusRingPath::localBounds(const GraphicsContext&) const
+{
+    FloatRect bounds = m_path.fastBoundingRect();
+    bounds.inflate(m_width + m_offset);
+    return bounds;
+}
+
+void DrawFocusRingRects::apply(GraphicsContext& context) const
+{
+    context.drawFocusRing(m_rects, m_width, m_offset, m_color);
+}
+
+Optional<FloatRect> DrawFocusRingRects::localBounds(const GraphicsContext&) const
+{
+    FloatRect bounds;
+    for (const auto& rect : m_rects)
+        bounds.unite(rect);
+    bounds.inflate(m_width + m_offset);
+    return bounds;
+}
+
+void FillRect::apply(GraphicsContext& context) const
+{
+    context.fillRect(m_rect);
+}
+
+void FillRectWithColor::apply(GraphicsContext& context) const
+{
+    context.fillRect(m_rect, m_color, m_colorSpace);
+}
+
+void FillRectWithGradient::apply(GraphicsContext& context) const
+{
+    context.fillRect(m_rect, const_cast<Gradient&>(m_gradient.get()));
+}
+
+void FillRoundedRect::apply(GraphicsContext& context) const
+{
+    context.fillRoundedRect(m_rect, m_color, m_colorSpace, m_blendMode);
+}
+
+void FillRectWithRoundedHole::apply(GraphicsContext& context) const
+{
+    context.fillRectWithRoundedHole(m_rect, m_roundedHoleRect, m_color, m_colorSpace);
+}
+
+void FillPath::apply(GraphicsContext& context) const
+{
+    context.fillPath(m_path);
+}
+
+void StrokeRect::apply(GraphicsContext& context) const
+{
+    context.strokeRect(m_rect, m_lineWidth);
+}
+
+Optional<FloatRect> StrokeRect::localBounds(const GraphicsContext&) const
+{
+    return inflatedForStroke(m_rect, m_lineWidth);
+}
+
+void StrokePath::apply(GraphicsContext& context) const
+{
+    context.strokePath(m_path);
+}
+
+Optional<FloatRect> StrokePath::localBounds(const GraphicsContext& context) const
+{
+    return inflatedForStroke(m_path.fastBoundingRect(), context.strokeThickness());
+}
+
+void ClearRect::apply(GraphicsContext& context) const
+{
+    context.clearRect(m_rect);
+}
+
+const char* itemName(ItemType type)
+{
+    switch (type) {
+    case ItemType::Save:
+        return "save";
+    case ItemType::Restore:
+        return "restore";
+    case ItemType::Translate:
+        return "translate";
+    case ItemType::Rotate:
+        return "rotate";
+    case ItemType::Scale:
+        return "scale";
+    case ItemType::ConcatenateCTM:
+        return "concatenate-ctm";
+    case ItemType::SetCTM:
+        return "set-ctm";
+    case ItemType::SetState:
+        return "set-state";
+    case ItemType::SetLineCap:
+        return "set-line-cap";
+    case ItemType::SetLineDash:
+        return "set-line-dash";
+    case ItemType::SetLineJoin:
+        return "set-line-join";
+    case ItemType::SetMiterLimit:
+        return "set-miter-limit";
+    case ItemType::SetImageInterpolationQuality:
+        return "set-image-interpolation-quality";
+    case ItemType::Clip:
+        return "clip";
+    case ItemType::ClipOut:
+        return "clip-out";
+    case ItemType::ClipOutToPath:
+        return "clip-out-to-path";
+    case ItemType::ClipPath:
+        return "clip-path";
+    case ItemType::ClipConvexPolygon:
+        return "clip-convex-polygon";
+    case ItemType::ClipToImageBuffer:
+        return "clip-to-image-buffer";
+    case ItemType::BeginTransparencyLayer:
+        return "begin-transparency-layer";
+    case ItemType::EndTransparencyLayer:
+        return "end-transparency-layer";
+    case ItemType::DrawGlyphs:
+        return "draw-glyphs";
+    case ItemType::DrawImage:
+        return "draw-image";
+    case ItemType::DrawTiledImage:
+        return "draw-tiled-image";
+    case ItemType::DrawTiledScaledImage:
+        return "draw-tiled-scaled-image";
+    case ItemType::DrawRect:
+        return "draw-rect";
+    case ItemType::DrawLine:
+        return "draw-line";
+    case ItemType::DrawLinesForText:
+        return "draw-lines-for-text";
+    case ItemType::DrawLineForDocumentMarker:
+        return "draw-line-for-document-marker";
+    case ItemType::DrawEllipse:
+        return "draw-ellipse";
+    case ItemType::DrawConvexPolygon:
+        return "draw-convex-polygon";
+    case ItemType::DrawFocusRingPath:
+        return "draw-focus-ring-path";
+    case ItemType::DrawFocusRingRects:
+        return "draw-focus-ring-rects";
+    case ItemType::FillRect:
+        return "fill-rect";
+    case ItemType::FillRectWithColor:
+        return "fill-rect-with-color";
+    case ItemType::FillRectWithGradient:
+        return "fill-rect-with-gradient";
+    case ItemType::FillRoundedRect:
+        return "fill-rounded-rect";
+    case ItemType::FillRectWithRoundedHole:
+        return "fill-rect-with-rounded-hole";
+    case ItemType::FillPath:
+        return "fill-path";
+    case ItemType::StrokeRect:
+        return "stroke-rect";
+    case ItemType::StrokePath:
+        return "stroke-path";
+    case ItemType::ClearRect:
+        return "clear-rect";
+    }
+
+    ASSERT_NOT_REACHED();
+    return "";
+}
+
+TextStream& operator<<(TextStream& ts, const Item& item)
+{
+    ts << itemName(item.type());
+
+    if (item.isDrawingItem()) {
+        const Optional<FloatRect>& extent = static_cast<const DrawingItem&>(item).extent();
+        if (extent) {
+            const FloatRect& rect = extent.value();
+            ts << " extent " << rect.location() << " " << rect.size();
+        } else
+            ts << " extent unknown";
+    }
+    return ts;
+}
+
+} // namespace DisplayList
+} // namespace WebCore
@@ -0,0 +1,931 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DisplayListItems_h
+#define DisplayListItems_h
+
+#include "FloatRoundedRect.h"
+#include "Font.h"
+#include "GlyphBuffer.h"
+#include "GraphicsContext.h"
+#include "ImageBuffer.h"
+#include <wtf/Optional.h>
+#include <wtf/RefCounted.h>
+
+namespace WebCore {
+
+class TextStream;
+
+namespace DisplayList {
+
+enum class ItemType {
+    Save,
+    Restore,
+    Translate,
+    Rotate,
+    Scale,
+    ConcatenateCTM,
+    SetCTM,
+    SetState,
+    SetLineCap,
+    SetLineDash,
+    SetLineJoin,
+    SetMiterLimit,
+    SetImageInterpolationQuality,
+    Clip,
+    ClipOut,
+    ClipOutToPath,
+    ClipPath,
+    ClipConvexPolygon,
+    ClipToImageBuffer,
+    BeginTransparencyLayer,
+    EndTransparencyLayer,
+    DrawGlyphs,
+    DrawImage,
+    DrawTiledImage,
+    DrawTiledScaledImage,
+    DrawRect,
+    DrawLine,
+    DrawLinesForText,
+    DrawLineForDocumentMarker,
+    DrawEllipse,
+    DrawConvexPolygon,
+    DrawFocusRingPath,
+    DrawFocusRingRects,
+    FillRect,
+    FillRectWithColor,
+    FillRectWithGradient,
+    FillRoundedRect,
+    FillRectWithRoundedHole,
+    FillPath,
+    StrokeRect,
+    StrokePath,
+    ClearRect,
+};
+
+class Item : public RefCounted<Item> {
+public:
+    virtual ~Item() { }
+
+    ItemType type() const { return m_type; }
+    virtual bool isDrawingItem() const { return false; }
+
+    virtual void apply(GraphicsContext&) const = 0;
+
+protected:
+    explicit Item(ItemType type)
+        : m_type(type)
+    {
+    }
+
+private:
+    ItemType m_type;
+};
+
+class DrawingItem : public Item {
+public:
+    // The area this item may touch, in the coordinates of the context the list was recorded
+    // against. Items without an extent are never culled during partial replay.
+    const Optional<FloatRect>& extent() const { return m_extent; }
+    void setExtent(const FloatRect& extent) { m_extent = extent; }
+
+    // Bounds in the item's own user space, including stroke width but not shadows.
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const { return Nullopt; }
+
+protected:
+    explicit DrawingItem(ItemType type)
+        : Item(type)
+    {
+    }
+
+private:
+    virtual bool isDrawingItem() const override { return true; }
+
+    Optional<FloatRect> m_extent;
+};
+
+class Save : public Item {
+public:
+    static Ref<Save> create() { return adoptRef(*new Save); }
+
+private:
+    Save()
+        : Item(ItemType::Save)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+};
+
+class Restore : public Item {
+public:
+    static Ref<Restore> create() { return adoptRef(*new Restore); }
+
+private:
+    Restore()
+        : Item(ItemType::Restore)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+};
+
+class Translate : public Item {
+public:
+    static Ref<Translate> create(float x, float y) { return adoptRef(*new Translate(x, y)); }
+
+private:
+    Translate(float x, float y)
+        : Item(ItemType::Translate)
+        , m_x(x)
+        , m_y(y)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    float m_x;
+    float m_y;
+};
+
+class Rotate : public Item {
+public:
+    static Ref<Rotate> create(float angleInRadians) { return adoptRef(*new Rotate(angleInRadians)); }
+
+private:
+    explicit Rotate(float angle)
+        : Item(ItemType::Rotate)
+        , m_angle(angle)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    float m_angle;
+};
+
+class Scale : public Item {
+public:
+    static Ref<Scale> create(const FloatSize& size) { return adoptRef(*new Scale(size)); }
+
+private:
+    explicit Scale(const FloatSize& size)
+        : Item(ItemType::Scale)
+        , m_size(size)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    FloatSize m_size;
+};
+
+class ConcatenateCTM : public Item {
+public:
+    static Ref<ConcatenateCTM> create(const AffineTransform& transform) { return adoptRef(*new ConcatenateCTM(transform)); }
+
+private:
+    explicit ConcatenateCTM(const AffineTransform& transform)
+        : Item(ItemType::ConcatenateCTM)
+        , m_transform(transform)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    AffineTransform m_transform;
+};
+
+// The transform is relative to the context the list was recorded against, so that replaying
+// into a translated context (for instance after a scroll) stays correct.
+class SetCTM : public Item {
+public:
+    static Ref<SetCTM> create(const AffineTransform& transform) { return adoptRef(*new SetCTM(transform)); }
+
+    const AffineTransform& transform() const { return m_transform; }
+
+private:
+    explicit SetCTM(const AffineTransform& transform)
+        : Item(ItemType::SetCTM)
+        , m_transform(transform)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    AffineTransform m_transform;
+};
+
+// A snapshot of the whole GraphicsContextState, recorded lazily before a drawing item whenever
+// the state differs from the last one recorded.
+class SetState : public Item {
+public:
+    static Ref<SetState> create(const GraphicsContextState& state) { return adoptRef(*new SetState(state)); }
+
+    const GraphicsContextState& state() const { return m_state; }
+
+private:
+    explicit SetState(const GraphicsContextState& state)
+        : Item(ItemType::SetState)
+        , m_state(state)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    GraphicsContextState m_state;
+};
+
+class SetLineCap : public Item {
+public:
+    static Ref<SetLineCap> create(LineCap lineCap) { return adoptRef(*new SetLineCap(lineCap)); }
+
+private:
+    explicit SetLineCap(LineCap lineCap)
+        : Item(ItemType::SetLineCap)
+        , m_lineCap(lineCap)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    LineCap m_lineCap;
+};
+
+class SetLineDash : public Item {
+public:
+    static Ref<SetLineDash> create(const DashArray& dashArray, float dashOffset) { return adoptRef(*new SetLineDash(dashArray, dashOffset)); }
+
+private:
+    SetLineDash(const DashArray& dashArray, float dashOffset)
+        : Item(ItemType::SetLineDash)
+        , m_dashArray(dashArray)
+        , m_dashOffset(dashOffset)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    DashArray m_dashArray;
+    float m_dashOffset;
+};
+
+class SetLineJoin : public Item {
+public:
+    static Ref<SetLineJoin> create(LineJoin lineJoin) { return adoptRef(*new SetLineJoin(lineJoin)); }
+
+private:
+    explicit SetLineJoin(LineJoin lineJoin)
+        : Item(ItemType::SetLineJoin)
+        , m_lineJoin(lineJoin)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    LineJoin m_lineJoin;
+};
+
+class SetMiterLimit : public Item {
+public:
+    static Ref<SetMiterLimit> create(float miterLimit) { return adoptRef(*new SetMiterLimit(miterLimit)); }
+
+private:
+    explicit SetMiterLimit(float miterLimit)
+        : Item(ItemType::SetMiterLimit)
+        , m_miterLimit(miterLimit)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    float m_miterLimit;
+};
+
+class SetImageInterpolationQuality : public Item {
+public:
+    static Ref<SetImageInterpolationQuality> create(InterpolationQuality quality) { return adoptRef(*new SetImageInterpolationQuality(quality)); }
+
+private:
+    explicit SetImageInterpolationQuality(InterpolationQuality quality)
+        : Item(ItemType::SetImageInterpolationQuality)
+        , m_quality(quality)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    InterpolationQuality m_quality;
+};
+
+class Clip : public Item {
+public:
+    static Ref<Clip> create(const FloatRect& rect) { return adoptRef(*new Clip(rect)); }
+
+private:
+    explicit Clip(const FloatRect& rect)
+        : Item(ItemType::Clip)
+        , m_rect(rect)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    FloatRect m_rect;
+};
+
+class ClipOut : public Item {
+public:
+    static Ref<ClipOut> create(const FloatRect& rect) { return adoptRef(*new ClipOut(rect)); }
+
+private:
+    explicit ClipOut(const FloatRect& rect)
+        : Item(ItemType::ClipOut)
+        , m_rect(rect)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    FloatRect m_rect;
+};
+
+class ClipOutToPath : public Item {
+public:
+    static Ref<ClipOutToPath> create(const Path& path) { return adoptRef(*new ClipOutToPath(path)); }
+
+private:
+    explicit ClipOutToPath(const Path& path)
+        : Item(ItemType::ClipOutToPath)
+        , m_path(path)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    Path m_path;
+};
+
+class ClipPath : public Item {
+public:
+    static Ref<ClipPath> create(const Path& path, WindRule windRule) { return adoptRef(*new ClipPath(path, windRule)); }
+
+private:
+    ClipPath(const Path& path, WindRule windRule)
+        : Item(ItemType::ClipPath)
+        , m_path(path)
+        , m_windRule(windRule)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    Path m_path;
+    WindRule m_windRule;
+};
+
+class ClipConvexPolygon : public Item {
+public:
+    static Ref<ClipConvexPolygon> create(size_t numPoints, const FloatPoint* points, bool antialias) { return adoptRef(*new ClipConvexPolygon(numPoints, points, antialias)); }
+
+private:
+    ClipConvexPolygon(size_t numPoints, const FloatPoint*, bool antialias);
+
+    virtual void apply(GraphicsContext&) const override;
+
+    Vector<FloatPoint> m_points;
+    bool m_antialias;
+};
+
+// Holds a private copy of the mask, since the buffer it was recorded from may be redrawn
+// before the list is replayed.
+class ClipToImageBuffer : public Item {
+public:
+    static Ref<ClipToImageBuffer> create(std::unique_ptr<ImageBuffer> buffer, const FloatRect& destination) { return adoptRef(*new ClipToImageBuffer(WTF::move(buffer), destination)); }
+
+private:
+    ClipToImageBuffer(std::unique_ptr<ImageBuffer> buffer, const FloatRect& destination)
+        : Item(ItemType::ClipToImageBuffer)
+        , m_buffer(WTF::move(buffer))
+        , m_destination(destination)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    std::unique_ptr<ImageBuffer> m_buffer;
+    FloatRect m_destination;
+};
+
+class BeginTransparencyLayer : public Item {
+public:
+    static Ref<BeginTransparencyLayer> create(float opacity) { return adoptRef(*new BeginTransparencyLayer(opacity)); }
+
+private:
+    explicit BeginTransparencyLayer(float opacity)
+        : Item(ItemType::BeginTransparencyLayer)
+        , m_opacity(opacity)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+
+    float m_opacity;
+};
+
+class EndTransparencyLayer : public Item {
+public:
+    static Ref<EndTransparencyLayer> create() { return adoptRef(*new EndTransparencyLayer); }
+
+private:
+    EndTransparencyLayer()
+        : Item(ItemType::EndTransparencyLayer)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+};
+
+// Keeps its own copy of the glyph range, since glyph buffers only live as long as the text run.
+class DrawGlyphs : public DrawingItem {
+public:
+    static Ref<DrawGlyphs> create(const FontCascade& fontCascade, const Font& font, const GlyphBuffer& glyphBuffer, int from, int numGlyphs, const FloatPoint& point)
+    {
+        return adoptRef(*new DrawGlyphs(fontCascade, font, glyphBuffer, from, numGlyphs, point));
+    }
+
+private:
+    DrawGlyphs(const FontCascade&, const Font&, const GlyphBuffer&, int from, int numGlyphs, const FloatPoint&);
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    FontCascade m_fontCascade;
+    Ref<Font> m_font;
+    GlyphBuffer m_glyphBuffer;
+    FloatPoint m_point;
+};
+
+class DrawImage : public DrawingItem {
+public:
+    static Ref<DrawImage> create(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatRect& source, const ImagePaintingOptions& options)
+    {
+        return adoptRef(*new DrawImage(image, colorSpace, destination, source, options));
+    }
+
+private:
+    DrawImage(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatRect& source, const ImagePaintingOptions& options)
+        : DrawingItem(ItemType::DrawImage)
+        , m_image(image)
+        , m_colorSpace(colorSpace)
+        , m_destination(destination)
+        , m_source(source)
+        , m_options(options)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_destination; }
+
+    Ref<Image> m_image;
+    ColorSpace m_colorSpace;
+    FloatRect m_destination;
+    FloatRect m_source;
+    ImagePaintingOptions m_options;
+};
+
+class DrawTiledImage : public DrawingItem {
+public:
+    static Ref<DrawTiledImage> create(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatPoint& source, const FloatSize& tileSize, const ImagePaintingOptions& options)
+    {
+        return adoptRef(*new DrawTiledImage(image, colorSpace, destination, source, tileSize, options));
+    }
+
+private:
+    DrawTiledImage(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatPoint& source, const FloatSize& tileSize, const ImagePaintingOptions& options)
+        : DrawingItem(ItemType::DrawTiledImage)
+        , m_image(image)
+        , m_colorSpace(colorSpace)
+        , m_destination(destination)
+        , m_source(source)
+        , m_tileSize(tileSize)
+        , m_options(options)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_destination; }
+
+    Ref<Image> m_image;
+    ColorSpace m_colorSpace;
+    FloatRect m_destination;
+    FloatPoint m_source;
+    FloatSize m_tileSize;
+    ImagePaintingOptions m_options;
+};
+
+class DrawTiledScaledImage : public DrawingItem {
+public:
+    static Ref<DrawTiledScaledImage> create(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatRect& source, const FloatSize& tileScaleFactor, Image::TileRule hRule, Image::TileRule vRule, const ImagePaintingOptions& options)
+    {
+        return adoptRef(*new DrawTiledScaledImage(image, colorSpace, destination, source, tileScaleFactor, hRule, vRule, options));
+    }
+
+private:
+    DrawTiledScaledImage(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatRect& source, const FloatSize& tileScaleFactor, Image::TileRule hRule, Image::TileRule vRule, const ImagePaintingOptions& options)
+        : DrawingItem(ItemType::DrawTiledScaledImage)
+        , m_image(image)
+        , m_colorSpace(colorSpace)
+        , m_destination(destination)
+        , m_source(source)
+        , m_tileScaleFactor(tileScaleFactor)
+        , m_hRule(hRule)
+        , m_vRule(vRule)
+        , m_options(options)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_destination; }
+
+    Ref<Image> m_image;
+    ColorSpace m_colorSpace;
+    FloatRect m_destination;
+    FloatRect m_source;
+    FloatSize m_tileScaleFactor;
+    Image::TileRule m_hRule;
+    Image::TileRule m_vRule;
+    ImagePaintingOptions m_options;
+};
+
+class DrawRect : public DrawingItem {
+public:
+    static Ref<DrawRect> create(const FloatRect& rect, float borderThickness) { return adoptRef(*new DrawRect(rect, borderThickness)); }
+
+private:
+    DrawRect(const FloatRect& rect, float borderThickness)
+        : DrawingItem(ItemType::DrawRect)
+        , m_rect(rect)
+        , m_borderThickness(borderThickness)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_rect; }
+
+    FloatRect m_rect;
+    float m_borderThickness;
+};
+
+class DrawLine : public DrawingItem {
+public:
+    static Ref<DrawLine> create(const FloatPoint& point1, const FloatPoint& point2) { return adoptRef(*new DrawLine(point1, point2)); }
+
+private:
+    DrawLine(const FloatPoint& point1, const FloatPoint& point2)
+        : DrawingItem(ItemType::DrawLine)
+        , m_point1(point1)
+        , m_point2(point2)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    FloatPoint m_point1;
+    FloatPoint m_point2;
+};
+
+class DrawLinesForText : public DrawingItem {
+public:
+    static Ref<DrawLinesForText> create(const FloatPoint& point, const DashArray& widths, bool printing, bool doubleLines)
+    {
+        return adoptRef(*new DrawLinesForText(point, widths, printing, doubleLines));
+    }
+
+private:
+    DrawLinesForText(const FloatPoint& point, const DashArray& widths, bool printing, bool doubleLines)
+        : DrawingItem(ItemType::DrawLinesForText)
+        , m_point(point)
+        , m_widths(widths)
+        , m_printing(printing)
+        , m_doubleLines(doubleLines)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    FloatPoint m_point;
+    DashArray m_widths;
+    bool m_printing;
+    bool m_doubleLines;
+};
+
+class DrawLineForDocumentMarker : public DrawingItem {
+public:
+    static Ref<DrawLineForDocumentMarker> create(const FloatPoint& point, float width, GraphicsContext::DocumentMarkerLineStyle style)
+    {
+        return adoptRef(*new DrawLineForDocumentMarker(point, width, style));
+    }
+
+private:
+    DrawLineForDocumentMarker(const FloatPoint& point, float width, GraphicsContext::DocumentMarkerLineStyle style)
+        : DrawingItem(ItemType::DrawLineForDocumentMarker)
+        , m_point(point)
+        , m_width(width)
+        , m_style(style)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    FloatPoint m_point;
+    float m_width;
+    GraphicsContext::DocumentMarkerLineStyle m_style;
+};
+
+class DrawEllipse : public DrawingItem {
+public:
+    static Ref<DrawEllipse> create(const FloatRect& rect) { return adoptRef(*new DrawEllipse(rect)); }
+
+private:
+    explicit DrawEllipse(const FloatRect& rect)
+        : DrawingItem(ItemType::DrawEllipse)
+        , m_rect(rect)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    FloatRect m_rect;
+};
+
+class DrawConvexPolygon : public DrawingItem {
+public:
+    static Ref<DrawConvexPolygon> create(size_t numPoints, const FloatPoint* points, bool antialias) { return adoptRef(*new DrawConvexPolygon(numPoints, points, antialias)); }
+
+private:
+    DrawConvexPolygon(size_t numPoints, const FloatPoint*, bool antialias);
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    Vector<FloatPoint> m_points;
+    bool m_antialias;
+};
+
+class DrawFocusRingPath : public DrawingItem {
+public:
+    static Ref<DrawFocusRingPath> create(const Path& path, int width, int offset, const Color& color) { return adoptRef(*new DrawFocusRingPath(path, width, offset, color)); }
+
+private:
+    DrawFocusRingPath(const Path& path, int width, int offset, const Color& color)
+        : DrawingItem(ItemType::DrawFocusRingPath)
+        , m_path(path)
+        , m_width(width)
+        , m_offset(offset)
+        , m_color(color)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    Path m_path;
+    int m_width;
+    int m_offset;
+    Color m_color;
+};
+
+class DrawFocusRingRects : public DrawingItem {
+public:
+    static Ref<DrawFocusRingRects> create(const Vector<IntRect>& rects, int width, int offset, const Color& color) { return adoptRef(*new DrawFocusRingRects(rects, width, offset, color)); }
+
+private:
+    DrawFocusRingRects(const Vector<IntRect>& rects, int width, int offset, const Color& color)
+        : DrawingItem(ItemType::DrawFocusRingRects)
+        , m_rects(rects)
+        , m_width(width)
+        , m_offset(offset)
+        , m_color(color)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    Vector<IntRect> m_rects;
+    int m_width;
+    int m_offset;
+    Color m_color;
+};
+
+class FillRect : public DrawingItem {
+public:
+    static Ref<FillRect> create(const FloatRect& rect) { return adoptRef(*new FillRect(rect)); }
+
+private:
+    explicit FillRect(const FloatRect& rect)
+        : DrawingItem(ItemType::FillRect)
+        , m_rect(rect)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_rect; }
+
+    FloatRect m_rect;
+};
+
+class FillRectWithColor : public DrawingItem {
+public:
+    static Ref<FillRectWithColor> create(const FloatRect& rect, const Color& color, ColorSpace colorSpace) { return adoptRef(*new FillRectWithColor(rect, color, colorSpace)); }
+
+private:
+    FillRectWithColor(const FloatRect& rect, const Color& color, ColorSpace colorSpace)
+        : DrawingItem(ItemType::FillRectWithColor)
+        , m_rect(rect)
+        , m_color(color)
+        , m_colorSpace(colorSpace)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_rect; }
+
+    FloatRect m_rect;
+    Color m_color;
+    ColorSpace m_colorSpace;
+};
+
+class FillRectWithGradient : public DrawingItem {
+public:
+    static Ref<FillRectWithGradient> create(const FloatRect& rect, Gradient& gradient) { return adoptRef(*new FillRectWithGradient(rect, gradient)); }
+
+private:
+    FillRectWithGradient(const FloatRect& rect, Gradient& gradient)
+        : DrawingItem(ItemType::FillRectWithGradient)
+        , m_rect(rect)
+        , m_gradient(gradient)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_rect; }
+
+    FloatRect m_rect;
+    Ref<Gradient> m_gradient;
+};
+
+class FillRoundedRect : public DrawingItem {
+public:
+    static Ref<FillRoundedRect> create(const FloatRoundedRect& rect, const Color& color, ColorSpace colorSpace, BlendMode blendMode)
+    {
+        return adoptRef(*new FillRoundedRect(rect, color, colorSpace, blendMode));
+    }
+
+private:
+    FillRoundedRect(const FloatRoundedRect& rect, const Color& color, ColorSpace colorSpace, BlendMode blendMode)
+        : DrawingItem(ItemType::FillRoundedRect)
+        , m_rect(rect)
+        , m_color(color)
+        , m_colorSpace(colorSpace)
+        , m_blendMode(blendMode)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_rect.rect(); }
+
+    FloatRoundedRect m_rect;
+    Color m_color;
+    ColorSpace m_colorSpace;
+    BlendMode m_blendMode;
+};
+
+class FillRectWithRoundedHole : public DrawingItem {
+public:
+    static Ref<FillRectWithRoundedHole> create(const FloatRect& rect, const FloatRoundedRect& roundedHoleRect, const Color& color, ColorSpace colorSpace)
+    {
+        return adoptRef(*new FillRectWithRoundedHole(rect, roundedHoleRect, color, colorSpace));
+    }
+
+private:
+    FillRectWithRoundedHole(const FloatRect& rect, const FloatRoundedRect& roundedHoleRect, const Color& color, ColorSpace colorSpace)
+        : DrawingItem(ItemType::FillRectWithRoundedHole)
+        , m_rect(rect)
+        , m_roundedHoleRect(roundedHoleRect)
+        , m_color(color)
+        , m_colorSpace(colorSpace)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_rect; }
+
+    FloatRect m_rect;
+    FloatRoundedRect m_roundedHoleRect;
+    Color m_color;
+    ColorSpace m_colorSpace;
+};
+
+class FillPath : public DrawingItem {
+public:
+    static Ref<FillPath> create(const Path& path) { return adoptRef(*new FillPath(path)); }
+
+private:
+    explicit FillPath(const Path& path)
+        : DrawingItem(ItemType::FillPath)
+        , m_path(path)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_path.fastBoundingRect(); }
+
+    Path m_path;
+};
+
+class StrokeRect : public DrawingItem {
+public:
+    static Ref<StrokeRect> create(const FloatRect& rect, float lineWidth) { return adoptRef(*new StrokeRect(rect, lineWidth)); }
+
+private:
+    StrokeRect(const FloatRect& rect, float lineWidth)
+        : DrawingItem(ItemType::StrokeRect)
+        , m_rect(rect)
+        , m_lineWidth(lineWidth)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    FloatRect m_rect;
+    float m_lineWidth;
+};
+
+class StrokePath : public DrawingItem {
+public:
+    static Ref<StrokePath> create(const Path& path) { return adoptRef(*new StrokePath(path)); }
+
+private:
+    explicit StrokePath(const Path& path)
+        : DrawingItem(ItemType::StrokePath)
+        , m_path(path)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override;
+
+    Path m_path;
+};
+
+class ClearRect : public DrawingItem {
+public:
+    static Ref<ClearRect> create(const FloatRect& rect) { return adoptRef(*new ClearRect(rect)); }
+
+private:
+    explicit ClearRect(const FloatRect& rect)
+        : DrawingItem(ItemType::ClearRect)
+        , m_rect(rect)
+    {
+    }
+
+    virtual void apply(GraphicsContext&) const override;
+    virtual Optional<FloatRect> localBounds(const GraphicsContext&) const override { return m_rect; }
+
+    FloatRect m_rect;
+};
+
+const char* itemName(ItemType);
+TextStream& operator<<(TextStream&, const Item&);
+
+} // namespace DisplayList
+} // namespace WebCore
+
+#endif // DisplayListItems_h
@@ -0,0 +1,371 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DisplayListRecorder.h"
+
+#include "ImageBuffer.h"
+#include <wtf/MathExtras.h>
+
+namespace WebCore {
+namespace DisplayList {
+
+static bool statesAreEqual(const GraphicsContextState& a, const GraphicsContextState& b)
+{
+    return a.strokeGradient == b.strokeGradient
+        && a.strokePattern == b.strokePattern
+        && a.fillGradient == b.fillGradient
+        && a.fillPattern == b.fillPattern
+        && a.shadowOffset == b.shadowOffset
+        && a.strokeThickness == b.strokeThickness
+        && a.shadowBlur == b.shadowBlur
+        && a.textDrawingMode == b.textDrawingMode
+        && a.strokeColor == b.strokeColor
+        && a.fillColor == b.fillColor
+        && a.shadowColor == b.shadowColor
+        && a.strokeStyle == b.strokeStyle
+        && a.fillRule == b.fillRule
+        && a.strokeColorSpace == b.strokeColorSpace
+        && a.fillColorSpace == b.fillColorSpace
+        && a.shadowColorSpace == b.shadowColorSpace
+        && a.alpha == b.alpha
+        && a.compositeOperator == b.compositeOperator
+        && a.blendMode == b.blendMode
+        && a.shouldAntialias == b.shouldAntialias
+        && a.shouldSmoothFonts == b.shouldSmoothFonts
+        && a.antialiasedFontDilationEnabled == b.antialiasedFontDilationEnabled
+        && a.shouldSubpixelQuantizeFonts == b.shouldSubpixelQuantizeFonts
+        && a.shadowsIgnoreTransforms == b.shadowsIgnoreTransforms
+        && a.drawLuminanceMask == b.drawLuminanceMask;
+}
+
+Recorder::Recorder(DisplayList& displayList, const FloatRect& initialClip)
+    : m_displayList(displayList)
+    , m_context(*this)
+{
+    m_stateStack.append(ContextState(initialClip));
+}
+
+Recorder::~Recorder()
+{
+    ASSERT(m_stateStack.size() == 1);
+}
+
+void Recorder::appendItem(Ref<Item>&& item)
+{
+    m_displayList.append(WTF::move(item));
+}
+
+void Recorder::appendStateChangeIfNeeded()
+{
+    ContextState& state = currentState();
+    if (state.hasRecordedState && statesAreEqual(state.lastRecordedState, m_context.state()))
+        return;
+
+    appendItem(SetState::create(m_context.state()));
+    state.lastRecordedState = m_context.state();
+    state.hasRecordedState = true;
+}
+
+void Recorder::appendDrawingItem(Ref<DrawingItem>&& item)
+{
+    appendStateChangeIfNeeded();
+
+    if (Optional<FloatRect> bounds = item->localBounds(m_context))
+        item->setExtent(extentFromLocalBounds(bounds.value()));
+
+    appendItem(WTF::move(item));
+}
+
+FloatRect Recorder::extentFromLocalBounds(const FloatRect& localBounds) const
+{
+    const GraphicsContextState& state = m_context.state();
+    bool hasVisibleShadow = m_context.hasVisibleShadow();
+
+    FloatRect bounds = localBounds;
+    if (hasVisibleShadow && !state.shadowsIgnoreTransforms) {
+        FloatRect shadowBounds = bounds;
+        shadowBounds.move(state.shadowOffset);
+        shadowBounds.inflate(state.shadowBlur);
+        bounds.unite(shadowBounds);
+    }
+
+    FloatRect extent = currentState().ctm.mapRect(bounds);
+
+    // Shadows that ignore transforms are offset in device space, in a direction that depends
+    // on the platform; just grow the extent in every direction.
+    if (hasVisibleShadow && state.shadowsIgnoreTransforms)
+        extent.inflate(state.shadowBlur + std::max(std::abs(state.shadowOffset.width()), std::abs(state.shadowOffset.height())));
+
+    // Antialiasing may touch one more pixel on each side.
+    extent.inflate(1);
+    extent.intersect(currentState().clipBounds);
+    return extent;
+}
+
+void Recorder::save()
+{
+    appendItem(Save::create());
+    m_stateStack.append(currentState());
+}
+
+void Recorder::restore()
+{
+    if (m_stateStack.size() <= 1)
+        return;
+
+    appendItem(Restore::create());
+    m_stateStack.removeLast();
+}
+
+void Recorder::translate(float x, float y)
+{
+    appendItem(Translate::create(x, y));
+    currentState().ctm.translate(x, y);
+}
+
+void Recorder::rotate(float angleInRadians)
+{
+    appendItem(Rotate::create(angleInRadians));
+    currentState().ctm.rotate(rad2deg(angleInRadians));
+}
+
+void Recorder::scale(const FloatSize& size)
+{
+    appendItem(Scale::create(size));
+    currentState().ctm.scale(size);
+}
+
+void Recorder::concatCTM(const AffineTransform& transform)
+{
+    appendItem(ConcatenateCTM::create(transform));
+    currentState().ctm.multiply(transform);
+}
+
+void Recorder::setCTM(const AffineTransform& transform)
+{
+    appendItem(SetCTM::create(transform));
+    currentState().ctm = transform;
+}
+
+void Recorder::setLineCap(LineCap lineCap)
+{
+    appendItem(SetLineCap::create(lineCap));
+}
+
+void Recorder::setLineDash(const DashArray& dashArray, float dashOffset)
+{
+    appendItem(SetLineDash::create(dashArray, dashOffset));
+}
+
+void Recorder::setLineJoin(LineJoin lineJoin)
+{
+    appendItem(SetLineJoin::create(lineJoin));
+}
+
+void Recorder::setMiterLimit(float miterLimit)
+{
+    appendItem(SetMiterLimit::create(miterLimit));
+}
+
+void Recorder::setImageInterpolationQuality(InterpolationQuality quality)
+{
+    appendItem(SetImageInterpolationQuality::create(quality));
+    currentState().imageInterpolationQuality = quality;
+}
+
+void Recorder::clip(const FloatRect& rect)
+{
+    appendItem(Clip::create(rect));
+    currentState().clipBounds.intersect(currentState().ctm.mapRect(rect));
+}
+
+void Recorder::clipOut(const FloatRect& rect)
+{
+    appendItem(ClipOut::create(rect));
+}
+
+void Recorder::clipOut(const Path& path)
+{
+    appendItem(ClipOutToPath::create(path));
+}
+
+void Recorder::clipPath(const Path& path, WindRule windRule)
+{
+    appendItem(ClipPath::create(path, windRule));
+    if (!path.isNull())
+        currentState().clipBounds.intersect(currentState().ctm.mapRect(path.fastBoundingRect()));
+}
+
+void Recorder::clipConvexPolygon(size_t numPoints, const FloatPoint* points, bool antialias)
+{
+    if (numPoints <= 1)
+        return;
+
+    appendItem(ClipConvexPolygon::create(numPoints, points, antialias));
+
+    FloatRect bounds(points[0], FloatSize());
+    for (size_t i = 1; i < numPoints; ++i)
+        bounds.extend(points[i]);
+    currentState().clipBounds.intersect(currentState().ctm.mapRect(bounds));
+}
+
+void Recorder::clipToImageBuffer(ImageBuffer& buffer, const FloatRect& destination)
+{
+    // Copy the mask at its backing resolution, the source buffer is often reused for the next mask.
+    float resolutionScale = buffer.logicalSize().width() ? static_cast<float>(buffer.internalSize().width()) / buffer.logicalSize().width() : 1;
+    std::unique_ptr<ImageBuffer> copy = ImageBuffer::create(buffer.logicalSize(), resolutionScale);
+    if (!copy)
+        return;
+    copy->context()->drawImageBuffer(&buffer, ColorSpaceDeviceRGB, FloatPoint());
+
+    appendItem(ClipToImageBuffer::create(WTF::move(copy), destination));
+    currentState().clipBounds.intersect(currentState().ctm.mapRect(destination));
+}
+
+IntRect Recorder::clipBounds() const
+{
+    const ContextState& state = currentState();
+    if (!state.ctm.isInvertible())
+        return IntRect();
+    return enclosingIntRect(state.ctm.inverse().mapRect(state.clipBounds));
+}
+
+void Recorder::beginTransparencyLayer(float opacity)
+{
+    appendStateChangeIfNeeded();
+    appendItem(BeginTransparencyLayer::create(opacity));
+}
+
+void Recorder::endTransparencyLayer()
+{
+    appendItem(EndTransparencyLayer::create());
+}
+
+void Recorder::drawGlyphs(const FontCascade& fontCascade, const Font& font, const GlyphBuffer& glyphBuffer, int from, int numGlyphs, const FloatPoint& point)
+{
+    appendDrawingItem(DrawGlyphs::create(fontCascade, font, glyphBuffer, from, numGlyphs, point));
+}
+
+void Recorder::drawImage(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatRect& source, const ImagePaintingOptions& options)
+{
+    appendDrawingItem(DrawImage::create(image, colorSpace, destination, source, options));
+}
+
+void Recorder::drawTiledImage(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatPoint& source, const FloatSize& tileSize, const ImagePaintingOptions& options)
+{
+    appendDrawingItem(DrawTiledImage::create(image, colorSpace, destination, source, tileSize, options));
+}
+
+void Recorder::drawTiledImage(Image& image, ColorSpace colorSpace, const FloatRect& destination, const FloatRect& source, const FloatSize& tileScaleFactor, Image::TileRule hRule, Image::TileRule vRule, const ImagePaintingOptions& options)
+{
+    appendDrawingItem(DrawTiledScaledImage::create(image, colorSpace, destination, source, tileScaleFactor, hRule, vRule, options));
+}
+
+void Recorder::drawRect(const FloatRect& rect, float borderThickness)
+{
+    appendDrawingItem(DrawRect::create(rect, borderThickness));
+}
+
+void Recorder::drawLine(const FloatPoint& point1, const FloatPoint& point2)
+{
+    appendDrawingItem(DrawLine::create(point1, point2));
+}
+
+void Recorder::drawLinesForText(const FloatPoint& point, const DashArray& widths, bool printing, bool doubleLines)
+{
+    appendDrawingItem(DrawLinesForText::create(point, widths, printing, doubleLines));
+}
+
+void Recorder::drawLineForDocumentMarker(const FloatPoint& point, float width, GraphicsContext::DocumentMarkerLineStyle style)
+{
+    appendDrawingItem(DrawLineForDocumentMarker::create(point, width, style));
+}
+
+void Recorder::drawEllipse(const FloatRect& rect)
+{
+    appendDrawingItem(DrawEllipse::create(rect));
+}
+
+void Recorder::drawConvexPolygon(size_t numPoints, const FloatPoint* points, bool antialias)
+{
+    appendDrawingItem(DrawConvexPolygon::create(numPoints, points, antialias));
+}
+
+void Recorder::drawFocusRing(const Path& path, int width, int offset, const Color& color)
+{
+    appendDrawingItem(DrawFocusRingPath::create(path, width, offset, color));
+}
+
+void Recorder::drawFocusRing(const Vector<IntRect>& rects, int width, int offset, const Color& color)
+{
+    appendDrawingItem(DrawFocusRingRects::create(rects, width, offset, color));
+}
+
+void Recorder::fillRect(const FloatRect& rect)
+{
+    appendDrawingItem(FillRect::create(rect));
+}
+
+void Recorder::fillRect(const FloatRect& rect, const Color& color, ColorSpace colorSpace)
+{
+    appendDrawingItem(FillRectWithColor::create(rect, color, colorSpace));
+}
+
+void Recorder::fillRect(const FloatRect& rect, Gradient& gradient)
+{
+    appendDrawingItem(FillRectWithGradient::create(rect, gradient));
+}
+
+void Recorder::fillRoundedRect(const FloatRoundedRect& rect, const Color& color, ColorSpace colorSpace, BlendMode blendMode)
+{
+    appendDrawingItem(FillRoundedRect::create(rect, color, colorSpace, blendMode));
+}
+
+void Recorder::fillRectWithRoundedHole(const FloatRect& rect, const FloatRoundedRect& roundedHoleRect, const Color& color, ColorSpace colorSpace)
+{
+    appendDrawingItem(FillRectWithRoundedHole::create(rect, roundedHoleRect, color, colorSpace));
+}
+
+void Recorder::fillPath(const Path& path)
+{
+    appendDrawingItem(FillPath::create(path));
+}
+
+void Recorder::strokeRect(const FloatRect& rect, float lineWidth)
+{
+    appendDrawingItem(StrokeRect::create(rect, lineWidth));
+}
+
+void Recorder::strokePath(const Path& path)
+{
+    appendDrawingItem(StrokePath::create(path));
+}
+
+void Recorder::clearRect(const FloatRect& rect)
+{
+    appendDrawingItem(ClearRect::create(rect));
+}
+
+} // namespace DisplayList
+} // namespace WebCore
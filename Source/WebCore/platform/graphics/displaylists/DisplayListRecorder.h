@@ -0,0 +1,133 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DisplayListRecorder_h
+#define DisplayListRecorder_h
+
+#include "AffineTransform.h"
+#include "DisplayList.h"
+#include "GraphicsContext.h"
+
+namespace WebCore {
+namespace DisplayList {
+
+// Owns a GraphicsContext that paints nothing and instead appends every operation made on it to
+// a DisplayList. The recording context keeps track of its transform and an approximation of its
+// clip so that painting code querying getCTM() or clipBounds() behaves as it would on a real
+// context, and so that each drawing item can be given its extent.
+class Recorder {
+    WTF_MAKE_NONCOPYABLE(Recorder); WTF_MAKE_FAST_ALLOCATED;
+public:
+    // initialClip is the area that is going to be painted, in the coordinates of context().
+    WEBCORE_EXPORT Recorder(DisplayList&, const FloatRect& initialClip);
+    WEBCORE_EXPORT ~Recorder();
+
+    GraphicsContext& context() { return m_context; }
+
+private:
+    friend class WebCore::GraphicsContext;
+
+    void save();
+    void restore();
+
+    void translate(float x, float y);
+    void rotate(float angleInRadians);
+    void scale(const FloatSize&);
+    void concatCTM(const AffineTransform&);
+    void setCTM(const AffineTransform&);
+    AffineTransform ctm() const { return currentState().ctm; }
+
+    void setLineCap(LineCap);
+    void setLineDash(const DashArray&, float dashOffset);
+    void setLineJoin(LineJoin);
+    void setMiterLimit(float);
+    void setImageInterpolationQuality(InterpolationQuality);
+    InterpolationQuality imageInterpolationQuality() const { return currentState().imageInterpolationQuality; }
+
+    void clip(const FloatRect&);
+    void clipOut(const FloatRect&);
+    void clipOut(const Path&);
+    void clipPath(const Path&, WindRule);
+    void clipConvexPolygon(size_t numPoints, const FloatPoint*, bool antialias);
+    void clipToImageBuffer(ImageBuffer&, const FloatRect&);
+    IntRect clipBounds() const;
+
+    void beginTransparencyLayer(float opacity);
+    void endTransparencyLayer();
+
+    void drawGlyphs(const FontCascade&, const Font&, const GlyphBuffer&, int from, int numGlyphs, const FloatPoint&);
+    void drawImage(Image&, ColorSpace, const FloatRect& destination, const FloatRect& source, const ImagePaintingOptions&);
+    void drawTiledImage(Image&, ColorSpace, const FloatRect& destination, const FloatPoint& source, const FloatSize& tileSize, const ImagePaintingOptions&);
+    void drawTiledImage(Image&, ColorSpace, const FloatRect& destination, const FloatRect& source, const FloatSize& tileScaleFactor, Image::TileRule hRule, Image::TileRule vRule, const ImagePaintingOptions&);
+    void drawRect(const FloatRect&, float borderThickness);
+    void drawLine(const FloatPoint&, const FloatPoint&);
+    void drawLinesForText(const FloatPoint&, const DashArray& widths, bool printing, bool doubleLines);
+    void drawLineForDocumentMarker(const FloatPoint&, float width, GraphicsContext::DocumentMarkerLineStyle);
+    void drawEllipse(const FloatRect&);
+    void drawConvexPolygon(size_t numPoints, const FloatPoint*, bool antialias);
+    void drawFocusRing(const Path&, int width, int offset, const Color&);
+    void drawFocusRing(const Vector<IntRect>&, int width, int offset, const Color&);
+
+    void fillRect(const FloatRect&);
+    void fillRect(const FloatRect&, const Color&, ColorSpace);
+    void fillRect(const FloatRect&, Gradient&);
+    void fillRoundedRect(const FloatRoundedRect&, const Color&, ColorSpace, BlendMode);
+    void fillRectWithRoundedHole(const FloatRect&, const FloatRoundedRect& roundedHoleRect, const Color&, ColorSpace);
+    void fillPath(const Path&);
+    void strokeRect(const FloatRect&, float lineWidth);
+    void strokePath(const Path&);
+    void clearRect(const FloatRect&);
+
+    void appendItem(Ref<Item>&&);
+    void appendDrawingItem(Ref<DrawingItem>&&);
+    void appendStateChangeIfNeeded();
+
+    FloatRect extentFromLocalBounds(const FloatRect&) const;
+
+    struct ContextState {
+        ContextState(const FloatRect& clip)
+            : clipBounds(clip)
+        {
+        }
+
+        AffineTransform ctm;
+        // In the coordinates of the recording, like the extents of the items.
+        FloatRect clipBounds;
+        InterpolationQuality imageInterpolationQuality { InterpolationDefault };
+        // The state the replay context will have at this point, as far as we recorded it.
+        GraphicsContextState lastRecordedState;
+        bool hasRecordedState { false };
+    };
+
+    const ContextState& currentState() const { return m_stateStack.last(); }
+    ContextState& currentState() { return m_stateStack.last(); }
+
+    DisplayList& m_displayList;
+    Vector<ContextState, 32> m_stateStack;
+    GraphicsContext m_context;
+};
+
+} // namespace DisplayList
+} // namespace WebCore
+
+#endif // DisplayListRecorder_h
@@ -0,0 +1,58 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DisplayListReplayer_h
+#define DisplayListReplayer_h
+
+#include "AffineTransform.h"
+#include "DisplayList.h"
+
+namespace WebCore {
+
+class GraphicsContext;
+
+namespace DisplayList {
+
+// Plays a DisplayList back into a context. The list is replayed relative to the transform the
+// context has when the Replayer is created, so a list recorded before a scroll can be reused by
+// translating the context by the scroll delta first.
+class Replayer {
+    WTF_MAKE_NONCOPYABLE(Replayer);
+public:
+    WEBCORE_EXPORT Replayer(GraphicsContext&, const DisplayList&);
+    WEBCORE_EXPORT ~Replayer();
+
+    // Skips the drawing items that can't touch initialClip, given in the coordinates the list was
+    // recorded in. An empty rect replays everything. Callers still clip the context themselves.
+    WEBCORE_EXPORT void replay(const FloatRect& initialClip = FloatRect());
+
+private:
+    GraphicsContext& m_context;
+    const DisplayList& m_displayList;
+    AffineTransform m_baseCTM;
+};
+
+} // namespace DisplayList
+} // namespace WebCore
+
+#endif // DisplayListReplayer_h
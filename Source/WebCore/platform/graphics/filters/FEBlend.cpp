@@ -26,6 +26,7 @@
 #include "FEBlend.h"
 
 #include "FEBlendNEON.h"
+#include "FEBlendSSE2.h"
 #include "Filter.h"
 #include "FloatPoint.h"
 #include "GraphicsContext.h"
@@ -60,8 +61,61 @@ bool FEBlend::setBlendMode(BlendMode mode)
 }
 
 #if !HAVE(ARM_NEON_INTRINSICS)
+#if HAVE(X86_SSE2_INTRINSICS)
+bool FEBlend::platformApplySSE2()
+{
+    void (*blend)(const unsigned char*, const unsigned char*, unsigned char*, unsigned);
+    switch (m_mode) {
+    case BlendModeNormal:
+        blend = blendSSE2<FEBlendUtilitiesSSE2::normal>;
+        break;
+    case BlendModeMultiply:
+        blend = blendSSE2<FEBlendUtilitiesSSE2::multiply>;
+        break;
+    case BlendModeScreen:
+        blend = blendSSE2<FEBlendUtilitiesSSE2::screen>;
+        break;
+    case BlendModeDarken:
+        blend = blendSSE2<FEBlendUtilitiesSSE2::darken>;
+        break;
+    case BlendModeLighten:
+        blend = blendSSE2<FEBlendUtilitiesSSE2::lighten>;
+        break;
+    default:
+        // Only the SVG 1.1 feBlend modes have kernels; the graphics context does the others.
+        return false;
+    }
+
+    if (!cpuSupportsSSE2())
+        return false;
+
+    FilterEffect* in = inputEffect(0);
+    FilterEffect* in2 = inputEffect(1);
+
+    Uint8ClampedArray* dstPixelArray = createPremultipliedImageResult();
+    if (!dstPixelArray)
+        return true;
+
+    IntRect effectADrawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
+    RefPtr<Uint8ClampedArray> srcPixelArrayA = in->asPremultipliedImage(effectADrawingRect);
+
+    IntRect effectBDrawingRect = requestedRegionOfInputImageData(in2->absolutePaintRect());
+    RefPtr<Uint8ClampedArray> srcPixelArrayB = in2->asPremultipliedImage(effectBDrawingRect);
+
+    unsigned pixelArrayLength = srcPixelArrayA->length();
+    ASSERT(pixelArrayLength == srcPixelArrayB->length());
+    blend(srcPixelArrayA->data(), srcPixelArrayB->data(), dstPixelArray->data(), pixelArrayLength);
+    return true;
+}
+#endif
+
 void FEBlend::platformApplySoftware()
 {
+#if HAVE(X86_SSE2_INTRINSICS)
+    if (platformApplySSE2())
+        return;
+#endif
+
     FilterEffect* in = inputEffect(0);
     FilterEffect* in2 = inputEffect(1);
 
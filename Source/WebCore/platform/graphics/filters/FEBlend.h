@@ -48,6 +48,10 @@ public:
 private:
     FEBlend(Filter&, BlendMode);
 
+#if HAVE(X86_SSE2_INTRINSICS)
+    bool platformApplySSE2();
+#endif
+
     BlendMode m_mode;
 };
 
@@ -23,6 +23,7 @@
 #include "config.h"
 #include "FEColorMatrix.h"
 
+#include "FEColorMatrixSSE2.h"
 #include "Filter.h"
 #include "GraphicsContext.h"
 #include "TextStream.h"
@@ -139,6 +140,38 @@ void effectType(Uint8ClampedArray* pixelArray, const Vector<float>& values)
     }
 }
 
+#if HAVE(X86_SSE2_INTRINSICS)
+// Expresses every type as the 5x4 matrix of type 'matrix', so one kernel handles them all.
+static void colorMatrixValues(ColorMatrixType type, const Vector<float>& values, float matrix[20])
+{
+    std::fill(matrix, matrix + 20, 0);
+    switch (type) {
+    case FECOLORMATRIX_TYPE_UNKNOWN:
+        break;
+    case FECOLORMATRIX_TYPE_MATRIX:
+        std::copy(values.begin(), values.begin() + 20, matrix);
+        break;
+    case FECOLORMATRIX_TYPE_SATURATE:
+    case FECOLORMATRIX_TYPE_HUEROTATE: {
+        float components[9];
+        if (type == FECOLORMATRIX_TYPE_SATURATE)
+            FEColorMatrix::calculateSaturateComponents(components, values[0]);
+        else
+            FEColorMatrix::calculateHueRotateComponents(components, values[0]);
+        for (unsigned row = 0; row < 3; ++row)
+            std::copy(components + row * 3, components + row * 3 + 3, matrix + row * 5);
+        matrix[18] = 1;
+        break;
+    }
+    case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
+        matrix[15] = 0.2125;
+        matrix[16] = 0.7154;
+        matrix[17] = 0.0721;
+        break;
+    }
+}
+#endif
+
 void FEColorMatrix::platformApplySoftware()
 {
     FilterEffect* in = inputEffect(0);
@@ -152,6 +185,18 @@ void FEColorMatrix::platformApplySoftware()
     IntRect imageRect(IntPoint(), resultImage->logicalSize());
     RefPtr<Uint8ClampedArray> pixelArray = resultImage->getUnmultipliedImageData(imageRect);
 
+#if HAVE(X86_SSE2_INTRINSICS)
+    if (m_type != FECOLORMATRIX_TYPE_UNKNOWN && cpuSupportsSSE2()) {
+        float matrix[20];
+        colorMatrixValues(m_type, m_values, matrix);
+        colorMatrixSSE2(pixelArray->data(), pixelArray->length(), matrix);
+        if (m_type == FECOLORMATRIX_TYPE_LUMINANCETOALPHA)
+            setIsAlphaImage(true);
+        resultImage->putByteArray(Unmultiplied, pixelArray.get(), imageRect.size(), imageRect, IntPoint());
+        return;
+    }
+#endif
+
     switch (m_type) {
     case FECOLORMATRIX_TYPE_UNKNOWN:
         break;
@@ -25,6 +25,7 @@
 #include "FEComposite.h"
 
 #include "FECompositeArithmeticNEON.h"
+#include "FECompositeArithmeticSSE2.h"
 #include "Filter.h"
 #include "GraphicsContext.h"
 #include "TextStream.h"
@@ -223,6 +224,12 @@ inline void FEComposite::platformArithmeticSoftware(Uint8ClampedArray* source, U
     ASSERT(!(length & 0x3));
     platformArithmeticNeon(source->data(), destination->data(), length, k1, k2, k3, k4);
 #else
+#if HAVE(X86_SSE2_INTRINSICS)
+    if (cpuSupportsSSE2()) {
+        platformArithmeticSSE2(source->data(), destination->data(), length, k1, k2, k3, k4);
+        return;
+    }
+#endif
     arithmeticSoftware(source->data(), destination->data(), length, k1, k2, k3, k4);
 #endif
 }
@@ -24,6 +24,7 @@
 #include "config.h"
 #include "FEMorphology.h"
 
+#include "FEMorphologySSE2.h"
 #include "Filter.h"
 #include "TextStream.h"
 
@@ -128,6 +129,17 @@ void FEMorphology::platformApplyGeneric(PaintingData* paintingData, int yStart,
     ASSERT(radiusX <= width || radiusY <= height);
     ASSERT(yStart >= 0 && yEnd <= height && yStart < yEnd);
 
+#if HAVE(X86_SSE2_INTRINSICS)
+    if (m_type != FEMORPHOLOGY_OPERATOR_UNKNOWN && cpuSupportsSSE2()) {
+        Vector<uint32_t> columnExtrema(width + 2 * radiusX);
+        if (m_type == FEMORPHOLOGY_OPERATOR_ERODE)
+            morphologySSE2<true>(srcPixelArray->data(), dstPixelArray->data(), width, height, radiusX, radiusY, yStart, yEnd, columnExtrema.data());
+        else
+            morphologySSE2<false>(srcPixelArray->data(), dstPixelArray->data(), width, height, radiusX, radiusY, yStart, yEnd, columnExtrema.data());
+        return;
+    }
+#endif
+
     Vector<unsigned char> extrema;
     for (int y = yStart; y < yEnd; ++y) {
         int yStartExtrema = std::max(0, y - radiusY);
@@ -23,12 +23,14 @@
 #include "FontCache.h"
 
 #include "Font.h"
+#include "FontConfigCache.h"
 #include "RefPtrCairo.h"
 #include "UTF16UChar32Iterator.h"
 #include <cairo-ft.h>
 #include <cairo.h>
 #include <fontconfig/fcfreetype.h>
 #include <wtf/Assertions.h>
+#include <unicode/utf16.h>
 #include <wtf/text/CString.h>
 
 namespace WebCore {
@@ -66,32 +68,48 @@ FcPattern* findBestFontGivenFallbacks(const FontPlatformData& fontData, FcPatter
     if (!fontData.m_pattern)
         return 0;
 
-    if (!fontData.m_fallbacks) {
-        FcResult fontConfigResult;
-        fontData.m_fallbacks = FcFontSort(0, fontData.m_pattern.get(), FcTrue, 0, &fontConfigResult);
-    }
-
-    if (!fontData.m_fallbacks)
+    // The sorted list is shared by every FontPlatformData made from the same pattern and
+    // is usually sorted off the main thread already, see FontConfigCache::prefetchFallbacks().
+    FcFontSet* fallbacks = FontConfigCache::singleton().fallbacks(fontData.m_pattern.get());
+    if (!fallbacks)
         return 0;
 
-    FcFontSet* sets[] = { fontData.m_fallbacks };
+    FcFontSet* sets[] = { fallbacks };
     FcResult fontConfigResult;
     return FcFontSetMatch(0, sets, 1, pattern, &fontConfigResult);
 }
 
-RefPtr<Font> FontCache::systemFallbackForCharacters(const FontDescription& description, const Font* originalFontData, bool, const UChar* characters, unsigned length)
+static RefPtr<FcPattern> findFallbackPattern(const FontPlatformData& fontData, const UChar* characters, unsigned length)
 {
     RefPtr<FcPattern> pattern = adoptRef(createFontConfigPatternForCharacters(characters, length));
-    const FontPlatformData& fontData = originalFontData->platformData();
 
     RefPtr<FcPattern> fallbackPattern = adoptRef(findBestFontGivenFallbacks(fontData, pattern.get()));
-    if (fallbackPattern) {
-        FontPlatformData alternateFontData(fallbackPattern.get(), description);
-        return fontForPlatformData(alternateFontData);
-    }
+    if (fallbackPattern)
+        return fallbackPattern;
 
     FcResult fontConfigResult;
-    RefPtr<FcPattern> resultPattern = adoptRef(FcFontMatch(0, pattern.get(), &fontConfigResult));
+    return adoptRef(FcFontMatch(0, pattern.get(), &fontConfigResult));
+}
+
+RefPtr<Font> FontCache::systemFallbackForCharacters(const FontDescription& description, const Font* originalFontData, bool, const UChar* characters, unsigned length)
+{
+    const FontPlatformData& fontData = originalFontData->platformData();
+    FontConfigCache& fontConfigCache = FontConfigCache::singleton();
+
+    // Only lookups for a single character are cached, which covers nearly all of them.
+    UChar32 character = 0;
+    unsigned offset = 0;
+    if (length)
+        U16_NEXT(characters, offset, length, character);
+    bool cacheable = length && offset == length;
+
+    RefPtr<FcPattern> resultPattern;
+    if (!cacheable || !fontConfigCache.findCharacterFallback(fontData.m_pattern.get(), character, resultPattern)) {
+        resultPattern = findFallbackPattern(fontData, characters, length);
+        if (cacheable)
+            fontConfigCache.addCharacterFallback(fontData.m_pattern.get(), character, resultPattern.get());
+    }
+
     if (!resultPattern)
         return 0;
     FontPlatformData alternateFontData(resultPattern.get(), description);
@@ -157,25 +175,20 @@ int fontWeightToFontconfigWeight(FontWeight weight)
     }
 }
 
-std::unique_ptr<FontPlatformData> FontCache::createFontPlatformData(const FontDescription& fontDescription, const AtomicString& family)
+static bool matchFontConfigPattern(const String& familyNameString, bool italic, int weight, float pixelSize, FontConfigCache::Match& match)
 {
-    // The CSS font matching algorithm (http://www.w3.org/TR/css3-fonts/#font-matching-algorithm)
-    // says that we must find an exact match for font family, slant (italic or oblique can be used)
-    // and font weight (we only match bold/non-bold here).
     RefPtr<FcPattern> pattern = adoptRef(FcPatternCreate());
     // Never choose unscalable fonts, as they pixelate when displayed at different sizes.
     FcPatternAddBool(pattern.get(), FC_SCALABLE, FcTrue);
-    String familyNameString(getFamilyNameStringFromFamily(family));
     if (!FcPatternAddString(pattern.get(), FC_FAMILY, reinterpret_cast<const FcChar8*>(familyNameString.utf8().data())))
-        return nullptr;
+        return false;
 
-    bool italic = fontDescription.italic();
     if (!FcPatternAddInteger(pattern.get(), FC_SLANT, italic ? FC_SLANT_ITALIC : FC_SLANT_ROMAN))
-        return nullptr;
-    if (!FcPatternAddInteger(pattern.get(), FC_WEIGHT, fontWeightToFontconfigWeight(fontDescription.weight())))
-        return nullptr;
-    if (!FcPatternAddDouble(pattern.get(), FC_PIXEL_SIZE, fontDescription.computedPixelSize()))
-        return nullptr;
+        return false;
+    if (!FcPatternAddInteger(pattern.get(), FC_WEIGHT, weight))
+        return false;
+    if (!FcPatternAddDouble(pattern.get(), FC_PIXEL_SIZE, pixelSize))
+        return false;
 
     // The strategy is originally from Skia (src/ports/SkFontHost_fontconfig.cpp):
 
@@ -187,10 +200,38 @@ std::unique_ptr<FontPlatformData> FontCache::createFontPlatformData(const FontDe
 
     FcChar8* fontConfigFamilyNameAfterConfiguration;
     FcPatternGetString(pattern.get(), FC_FAMILY, 0, &fontConfigFamilyNameAfterConfiguration);
-    String familyNameAfterConfiguration = String::fromUTF8(reinterpret_cast<char*>(fontConfigFamilyNameAfterConfiguration));
+    match.familyNameAfterConfiguration = String::fromUTF8(reinterpret_cast<char*>(fontConfigFamilyNameAfterConfiguration));
 
     FcResult fontConfigResult;
-    RefPtr<FcPattern> resultPattern = adoptRef(FcFontMatch(0, pattern.get(), &fontConfigResult));
+    match.pattern = adoptRef(FcFontMatch(0, pattern.get(), &fontConfigResult));
+    return true;
+}
+
+std::unique_ptr<FontPlatformData> FontCache::createFontPlatformData(const FontDescription& fontDescription, const AtomicString& family)
+{
+    // The CSS font matching algorithm (http://www.w3.org/TR/css3-fonts/#font-matching-algorithm)
+    // says that we must find an exact match for font family, slant (italic or oblique can be used)
+    // and font weight (we only match bold/non-bold here).
+    String familyNameString(getFamilyNameStringFromFamily(family));
+    bool italic = fontDescription.italic();
+    int weight = fontWeightToFontconfigWeight(fontDescription.weight());
+    float pixelSize = fontDescription.computedPixelSize();
+
+    // Substitution and matching only depend on the request, so ask fontconfig once per
+    // family, style and size rather than every time the platform data cache misses.
+    FontConfigCache& fontConfigCache = FontConfigCache::singleton();
+    FontConfigMatchKey key(familyNameString, weight, italic, pixelSize);
+    FontConfigCache::Match match;
+    if (const FontConfigCache::Match* cachedMatch = fontConfigCache.findMatch(key))
+        match = *cachedMatch;
+    else {
+        if (!matchFontConfigPattern(familyNameString, italic, weight, pixelSize, match))
+            return nullptr;
+        fontConfigCache.addMatch(WTF::move(key), FontConfigCache::Match(match));
+    }
+
+    const String& familyNameAfterConfiguration = match.familyNameAfterConfiguration;
+    RefPtr<FcPattern> resultPattern = match.pattern;
     if (!resultPattern) // No match.
         return nullptr;
 
@@ -214,6 +255,9 @@ std::unique_ptr<FontPlatformData> FontCache::createFontPlatformData(const FontDe
     if (!platformData->hasCompatibleCharmap())
         return nullptr;
 
+    // Have the fallback list ready by the time text in this font needs a character it lacks.
+    fontConfigCache.prefetchFallbacks(resultPattern.get());
+
     return platformData;
 }
 
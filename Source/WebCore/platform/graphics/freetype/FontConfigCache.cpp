@@ -0,0 +1,308 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "FontConfigCache.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <wtf/HashFunctions.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/Threading.h>
+
+namespace WebCore {
+
+static const unsigned maximumMatches = 512;
+static const unsigned maximumFallbackEntries = 64;
+static const unsigned maximumCharacterFallbacksPerFont = 4096;
+// Most fonts never miss a glyph, so their prefetched sorts are wasted work. Bound how
+// much of it can pile up on the fontconfig thread while a page loads many fonts.
+static const unsigned maximumQueuedFallbackSorts = 4;
+
+static std::atomic<unsigned> queuedFallbackSorts;
+
+FontConfigMatchKey::FontConfigMatchKey(const String& family, int weight, bool italic, float pixelSize)
+    : family(family)
+    , weight(weight)
+    , italic(italic)
+    , pixelSize(pixelSize)
+{
+    unsigned familyHash = family.isNull() ? 0 : family.impl()->hash();
+    hash = WTF::pairIntHash(familyHash, WTF::pairIntHash(weight << 1 | italic, DefaultHash<float>::Hash::hash(pixelSize)));
+}
+
+// FcFontSort walks every font on the system, which takes tens of milliseconds on a
+// desktop with many fonts installed. The sort runs on the fontconfig thread unless
+// someone needs the result before the thread got to it, in which case the caller
+// sorts right away rather than waiting behind other queued sorts.
+class FontConfigCache::FallbackSort : public ThreadSafeRefCounted<FallbackSort> {
+public:
+    static PassRefPtr<FallbackSort> create(FcConfig* configuration, FcPattern* pattern) { return adoptRef(new FallbackSort(configuration, pattern)); }
+    ~FallbackSort();
+
+    void run();
+    FcFontSet* waitForResult();
+    void cancel();
+
+private:
+    FallbackSort(FcConfig*, FcPattern*);
+
+    bool tryToStart();
+    FcFontSet* sort();
+    void finish(FcFontSet*);
+
+    Mutex m_mutex;
+    ThreadCondition m_condition;
+    FcConfig* m_configuration;
+    FcPattern* m_pattern;
+    FcFontSet* m_result { nullptr };
+    bool m_started { false };
+    bool m_finished { false };
+    bool m_cancelled { false };
+};
+
+FontConfigCache::FallbackSort::FallbackSort(FcConfig* configuration, FcPattern* pattern)
+    : m_configuration(FcConfigReference(configuration))
+    // fontconfig patterns are not meant to be shared across threads, so sort a copy.
+    , m_pattern(FcPatternDuplicate(pattern))
+{
+}
+
+FontConfigCache::FallbackSort::~FallbackSort()
+{
+    if (m_result)
+        FcFontSetDestroy(m_result);
+    FcPatternDestroy(m_pattern);
+    FcConfigDestroy(m_configuration);
+}
+
+FcFontSet* FontConfigCache::FallbackSort::sort()
+{
+    FcResult fontConfigResult;
+    return FcFontSort(m_configuration, m_pattern, FcTrue, 0, &fontConfigResult);
+}
+
+bool FontConfigCache::FallbackSort::tryToStart()
+{
+    MutexLocker locker(m_mutex);
+    if (m_started || m_cancelled)
+        return false;
+    m_started = true;
+    return true;
+}
+
+void FontConfigCache::FallbackSort::finish(FcFontSet* result)
+{
+    MutexLocker locker(m_mutex);
+    m_result = result;
+    m_finished = true;
+    m_condition.broadcast();
+}
+
+void FontConfigCache::FallbackSort::run()
+{
+    if (tryToStart())
+        finish(sort());
+}
+
+FcFontSet* FontConfigCache::FallbackSort::waitForResult()
+{
+    if (tryToStart())
+        finish(sort());
+
+    MutexLocker locker(m_mutex);
+    while (!m_finished)
+        m_condition.wait(m_mutex);
+
+    FcFontSet* result = m_result;
+    m_result = nullptr;
+    return result;
+}
+
+void FontConfigCache::FallbackSort::cancel()
+{
+    MutexLocker locker(m_mutex);
+    m_cancelled = true;
+}
+
+static void runOnFontConfigThread(std::function<void ()> function)
+{
+    static NeverDestroyed<MessageQueue<std::function<void ()>>> queue;
+
+    static std::once_flag createFontConfigThreadOnce;
+    std::call_once(createFontConfigThreadOnce, [] {
+        createThread("WebCore: FontConfig", [] {
+            for (;;) {
+                auto function = queue.get().waitForMessage();
+
+                // This can never be null because we never kill the MessageQueue.
+                ASSERT(function);
+                (*function)();
+            }
+        });
+    });
+
+    queue.get().append(std::make_unique<std::function<void ()>>(WTF::move(function)));
+}
+
+FontConfigCache::FallbackEntry::~FallbackEntry()
+{
+    if (pendingSort)
+        pendingSort->cancel();
+    if (fallbacks)
+        FcFontSetDestroy(fallbacks);
+}
+
+FontConfigCache& FontConfigCache::singleton()
+{
+    static NeverDestroyed<FontConfigCache> cache;
+    return cache;
+}
+
+void FontConfigCache::invalidateIfConfigurationChanged()
+{
+    // FcConfigGetCurrent() hands out a new FcConfig whenever the application rebuilds
+    // the configuration, which is how font installation and removal are picked up.
+    FcConfig* configuration = FcConfigGetCurrent();
+    if (configuration == m_configuration)
+        return;
+
+    clear();
+    m_configuration = configuration;
+}
+
+const FontConfigCache::Match* FontConfigCache::findMatch(const FontConfigMatchKey& key)
+{
+    invalidateIfConfigurationChanged();
+
+    auto it = m_matches.find(key);
+    if (it == m_matches.end())
+        return nullptr;
+    return &it->value;
+}
+
+void FontConfigCache::addMatch(FontConfigMatchKey&& key, Match&& match)
+{
+    invalidateIfConfigurationChanged();
+
+    if (m_matches.size() >= maximumMatches)
+        m_matches.clear();
+    m_matches.set(WTF::move(key), WTF::move(match));
+}
+
+FontConfigCache::FallbackEntry& FontConfigCache::fallbackEntry(FcPattern* pattern)
+{
+    ASSERT(pattern);
+
+    auto it = m_fallbackEntries.find(pattern);
+    if (it != m_fallbackEntries.end()) {
+        m_fallbackEntryUsage.appendOrMoveToLast(pattern);
+        return *it->value;
+    }
+
+    if (m_fallbackEntries.size() >= maximumFallbackEntries)
+        m_fallbackEntries.remove(m_fallbackEntryUsage.takeFirst());
+    m_fallbackEntryUsage.add(pattern);
+
+    auto entry = std::make_unique<FallbackEntry>();
+    // Keep the pattern alive so its address cannot be reused by another font while it is a key.
+    entry->pattern = pattern;
+    return *m_fallbackEntries.add(pattern, WTF::move(entry)).iterator->value;
+}
+
+void FontConfigCache::prefetchFallbacks(FcPattern* pattern)
+{
+    invalidateIfConfigurationChanged();
+
+    FallbackEntry& entry = fallbackEntry(pattern);
+    if (entry.fallbacks || entry.pendingSort)
+        return;
+
+    // Past the limit the sort is simply done on demand by fallbacks().
+    if (queuedFallbackSorts.load() >= maximumQueuedFallbackSorts)
+        return;
+    ++queuedFallbackSorts;
+
+    RefPtr<FallbackSort> sort = FallbackSort::create(m_configuration, pattern);
+    entry.pendingSort = sort;
+    runOnFontConfigThread([sort] {
+        sort->run();
+        --queuedFallbackSorts;
+    });
+}
+
+FcFontSet* FontConfigCache::fallbacks(FcPattern* pattern)
+{
+    invalidateIfConfigurationChanged();
+
+    FallbackEntry& entry = fallbackEntry(pattern);
+    if (entry.fallbacks)
+        return entry.fallbacks;
+
+    RefPtr<FallbackSort> sort = entry.pendingSort.release();
+    if (!sort)
+        sort = FallbackSort::create(m_configuration, pattern);
+    entry.fallbacks = sort->waitForResult();
+    return entry.fallbacks;
+}
+
+bool FontConfigCache::findCharacterFallback(FcPattern* fontPattern, UChar32 character, RefPtr<FcPattern>& result)
+{
+    invalidateIfConfigurationChanged();
+
+    const CharacterFallbackMap* characterFallbacks = &m_characterFallbacksWithoutFont;
+    if (fontPattern) {
+        auto it = m_fallbackEntries.find(fontPattern);
+        if (it == m_fallbackEntries.end())
+            return false;
+        m_fallbackEntryUsage.appendOrMoveToLast(fontPattern);
+        characterFallbacks = &it->value->characterFallbacks;
+    }
+
+    auto it = characterFallbacks->find(character);
+    if (it == characterFallbacks->end())
+        return false;
+    result = it->value;
+    return true;
+}
+
+void FontConfigCache::addCharacterFallback(FcPattern* fontPattern, UChar32 character, FcPattern* result)
+{
+    invalidateIfConfigurationChanged();
+
+    CharacterFallbackMap& characterFallbacks = fontPattern ? fallbackEntry(fontPattern).characterFallbacks : m_characterFallbacksWithoutFont;
+    if (characterFallbacks.size() >= maximumCharacterFallbacksPerFont)
+        characterFallbacks.clear();
+    characterFallbacks.set(character, result);
+}
+
+void FontConfigCache::clear()
+{
+    m_matches.clear();
+    m_fallbackEntries.clear();
+    m_fallbackEntryUsage.clear();
+    m_characterFallbacksWithoutFont.clear();
+}
+
+} // namespace WebCore
@@ -0,0 +1,129 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FontConfigCache_h
+#define FontConfigCache_h
+
+#include "RefPtrCairo.h"
+#include <fontconfig/fontconfig.h>
+#include <memory>
+#include <wtf/HashMap.h>
+#include <wtf/HashTraits.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/ThreadingPrimitives.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+struct FontConfigMatchKey {
+    FontConfigMatchKey() { }
+    FontConfigMatchKey(WTF::HashTableDeletedValueType) : weight(-1) { }
+    FontConfigMatchKey(const String& family, int weight, bool italic, float pixelSize);
+
+    bool isHashTableDeletedValue() const { return weight == -1; }
+    bool operator==(const FontConfigMatchKey& other) const
+    {
+        return weight == other.weight && italic == other.italic && pixelSize == other.pixelSize && family == other.family;
+    }
+
+    String family;
+    int weight { 0 };
+    bool italic { false };
+    float pixelSize { 0 };
+    unsigned hash { 0 };
+};
+
+struct FontConfigMatchKeyHash {
+    static unsigned hash(const FontConfigMatchKey& key) { return key.hash; }
+    static bool equal(const FontConfigMatchKey& a, const FontConfigMatchKey& b) { return a == b; }
+    static const bool safeToCompareToEmptyOrDeleted = true;
+};
+
+struct FontConfigMatchKeyTraits : WTF::SimpleClassHashTraits<FontConfigMatchKey> { };
+
+// Remembers what fontconfig answered for family matches and character fallbacks so
+// that each question is asked once per process rather than once per FontPlatformData.
+// Everything is dropped when the current FcConfig is replaced, e.g. after fonts are
+// installed.
+class FontConfigCache {
+    WTF_MAKE_NONCOPYABLE(FontConfigCache); WTF_MAKE_FAST_ALLOCATED;
+    friend NeverDestroyed<FontConfigCache>;
+public:
+    static FontConfigCache& singleton();
+
+    struct Match {
+        String familyNameAfterConfiguration;
+        RefPtr<FcPattern> pattern; // Null when fontconfig had no match.
+    };
+    const Match* findMatch(const FontConfigMatchKey&);
+    void addMatch(FontConfigMatchKey&&, Match&&);
+
+    // Starts sorting the fonts that can stand in for the given font on the fontconfig
+    // thread, so the list is usually ready before the first fallback lookup needs it.
+    // Does nothing while too many sorts are already queued.
+    void prefetchFallbacks(FcPattern*);
+    // The sorted fallback list of the given font. Waits for the fontconfig thread if
+    // the sort is still in flight. The set is owned by the cache.
+    FcFontSet* fallbacks(FcPattern*);
+
+    // The font pattern may be null for fonts that fontconfig does not know about,
+    // like web fonts. A cached null result means no font covers the character.
+    bool findCharacterFallback(FcPattern* fontPattern, UChar32, RefPtr<FcPattern>& result);
+    void addCharacterFallback(FcPattern* fontPattern, UChar32, FcPattern* result);
+
+    void clear();
+
+private:
+    FontConfigCache() { }
+
+    class FallbackSort;
+    typedef HashMap<UChar32, RefPtr<FcPattern>, IntHash<UChar32>, WTF::UnsignedWithZeroKeyHashTraits<UChar32>> CharacterFallbackMap;
+
+    struct FallbackEntry {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        ~FallbackEntry();
+
+        RefPtr<FcPattern> pattern;
+        RefPtr<FallbackSort> pendingSort;
+        FcFontSet* fallbacks { nullptr };
+        CharacterFallbackMap characterFallbacks;
+    };
+
+    void invalidateIfConfigurationChanged();
+    FallbackEntry& fallbackEntry(FcPattern*);
+
+    FcConfig* m_configuration { nullptr };
+    HashMap<FontConfigMatchKey, Match, FontConfigMatchKeyHash, FontConfigMatchKeyTraits> m_matches;
+    HashMap<FcPattern*, std::unique_ptr<FallbackEntry>> m_fallbackEntries;
+    ListHashSet<FcPattern*> m_fallbackEntryUsage; // Least recently used first.
+    CharacterFallbackMap m_characterFallbacksWithoutFont;
+};
+
+} // namespace WebCore
+
+#endif // FontConfigCache_h
@@ -37,7 +37,6 @@
 #include <wtf/Forward.h>
 #include <wtf/HashFunctions.h>
 
-typedef struct _FcFontSet FcFontSet;
 class HarfBuzzFace;
 
 namespace WebCore {
@@ -45,8 +44,7 @@ namespace WebCore {
 class FontPlatformData {
 public:
     FontPlatformData(WTF::HashTableDeletedValueType)
-        : m_fallbacks(0)
-        , m_size(0)
+        : m_size(0)
         , m_syntheticBold(false)
         , m_syntheticOblique(false)
         , m_scaledFont(hashTableDeletedFontValue())
@@ -54,8 +52,7 @@ public:
         { }
 
     FontPlatformData()
-        : m_fallbacks(0)
-        , m_size(0)
+        : m_size(0)
         , m_syntheticBold(false)
         , m_syntheticOblique(false)
         , m_scaledFont(0)
@@ -104,7 +101,6 @@ public:
 #endif
 
     RefPtr<FcPattern> m_pattern;
-    mutable FcFontSet* m_fallbacks; // Initialized lazily.
     float m_size;
     bool m_syntheticBold;
     bool m_syntheticOblique;
@@ -136,7 +136,6 @@ static FcPattern* getDefaultFontconfigOptions()
 
 FontPlatformData::FontPlatformData(FcPattern* pattern, const FontDescription& fontDescription)
     : m_pattern(pattern)
-    , m_fallbacks(nullptr)
     , m_size(fontDescription.computedPixelSize())
     , m_syntheticBold(false)
     , m_syntheticOblique(false)
@@ -176,8 +175,7 @@ FontPlatformData::FontPlatformData(FcPattern* pattern, const FontDescription& fo
 }
 
 FontPlatformData::FontPlatformData(float size, bool bold, bool italic)
-    : m_fallbacks(nullptr)
-    , m_size(size)
+    : m_size(size)
     , m_syntheticBold(bold)
     , m_syntheticOblique(italic)
     , m_fixedWidth(false)
@@ -188,8 +186,7 @@ FontPlatformData::FontPlatformData(float size, bool bold, bool italic)
 }
 
 FontPlatformData::FontPlatformData(cairo_font_face_t* fontFace, float size, bool bold, bool italic, FontOrientation orientation)
-    : m_fallbacks(nullptr)
-    , m_size(size)
+    : m_size(size)
     , m_syntheticBold(bold)
     , m_syntheticOblique(italic)
     , m_fixedWidth(false)
@@ -218,12 +215,6 @@ FontPlatformData& FontPlatformData::operator=(const FontPlatformData& other)
     m_pattern = other.m_pattern;
     m_orientation = other.m_orientation;
 
-    if (m_fallbacks) {
-        FcFontSetDestroy(m_fallbacks);
-        // This will be re-created on demand.
-        m_fallbacks = nullptr;
-    }
-
     if (m_scaledFont && m_scaledFont != hashTableDeletedFontValue())
         cairo_scaled_font_destroy(m_scaledFont);
     m_scaledFont = cairo_scaled_font_reference(other.m_scaledFont);
@@ -234,16 +225,14 @@ FontPlatformData& FontPlatformData::operator=(const FontPlatformData& other)
 }
 
 FontPlatformData::FontPlatformData(const FontPlatformData& other)
-    : m_fallbacks(nullptr)
-    , m_scaledFont(nullptr)
+    : m_scaledFont(nullptr)
     , m_harfBuzzFace(other.m_harfBuzzFace)
 {
     *this = other;
 }
 
 FontPlatformData::FontPlatformData(const FontPlatformData& other, float size)
-    : m_fallbacks(nullptr)
-    , m_scaledFont(nullptr)
+    : m_scaledFont(nullptr)
     , m_harfBuzzFace(other.m_harfBuzzFace)
 {
     *this = other;
@@ -256,11 +245,6 @@ FontPlatformData::FontPlatformData(const FontPlatformData& other, float size)
 
 FontPlatformData::~FontPlatformData()
 {
-    if (m_fallbacks) {
-        FcFontSetDestroy(m_fallbacks);
-        m_fallbacks = nullptr;
-    }
-
     if (m_scaledFont && m_scaledFont != hashTableDeletedFontValue())
         cairo_scaled_font_destroy(m_scaledFont);
 }
@@ -32,6 +32,7 @@
 #include "HarfBuzzFace.h"
 
 #include "FontPlatformData.h"
+#include "HarfBuzzShapeCache.h"
 #include <hb-ot.h>
 #include <hb.h>
 
@@ -93,6 +94,8 @@ HarfBuzzFace::HarfBuzzFace(FontPlatformData* platformData, uint64_t uniqueID)
 
 HarfBuzzFace::~HarfBuzzFace()
 {
+    HarfBuzzShapeCache::singleton().removeEntriesForFace(this);
+
     HarfBuzzFaceCache::iterator result = harfBuzzFaceCache()->find(m_uniqueID);
     ASSERT(result != harfBuzzFaceCache()->end());
     ASSERT(result.get()->value->refCount() > 1);
@@ -0,0 +1,155 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HarfBuzzShapeCache.h"
+
+#include <algorithm>
+#include <wtf/HashFunctions.h>
+#include <wtf/StringHasher.h>
+
+namespace WebCore {
+
+// Roughly 2.5MB of glyph data.
+static const unsigned maximumCachedGlyphs = 64 * 1024;
+// A run larger than this would push most of the cache out for a single entry.
+static const unsigned maximumGlyphsPerEntry = maximumCachedGlyphs / 16;
+
+HarfBuzzShapeResult::HarfBuzzShapeResult(hb_buffer_t* buffer)
+{
+    unsigned numGlyphs = hb_buffer_get_length(buffer);
+    m_glyphInfos.append(hb_buffer_get_glyph_infos(buffer, 0), numGlyphs);
+    m_glyphPositions.append(hb_buffer_get_glyph_positions(buffer, 0), numGlyphs);
+}
+
+HarfBuzzShapeCacheKey::HarfBuzzShapeCacheKey(HarfBuzzFace* face, hb_script_t script, hb_direction_t direction, const Vector<hb_feature_t, 4>& features, const String& text)
+    : face(face)
+    , script(script)
+    , direction(direction)
+    , text(text)
+{
+    this->features.appendVector(features);
+
+    StringHasher hasher;
+    hasher.addCharacters(static_cast<UChar>(script >> 16), static_cast<UChar>(script));
+    hasher.addCharacter(static_cast<UChar>(direction));
+    for (auto& feature : features) {
+        hasher.addCharacters(static_cast<UChar>(feature.tag >> 16), static_cast<UChar>(feature.tag));
+        hasher.addCharacter(static_cast<UChar>(feature.value));
+    }
+    hash = WTF::pairIntHash(WTF::pairIntHash(PtrHash<HarfBuzzFace*>::hash(face), hasher.hash()), text.isEmpty() ? 0 : text.impl()->hash());
+}
+
+bool HarfBuzzShapeCacheKey::operator==(const HarfBuzzShapeCacheKey& other) const
+{
+    if (face != other.face || script != other.script || direction != other.direction || hash != other.hash)
+        return false;
+    if (features.size() != other.features.size())
+        return false;
+    for (unsigned i = 0; i < features.size(); ++i) {
+        const hb_feature_t& a = features[i];
+        const hb_feature_t& b = other.features[i];
+        if (a.tag != b.tag || a.value != b.value || a.start != b.start || a.end != b.end)
+            return false;
+    }
+    return text == other.text;
+}
+
+HarfBuzzShapeCache& HarfBuzzShapeCache::singleton()
+{
+    static NeverDestroyed<HarfBuzzShapeCache> cache;
+    return cache;
+}
+
+HarfBuzzShapeResult* HarfBuzzShapeCache::find(const HarfBuzzShapeCacheKey& key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return nullptr;
+
+    it->value.lastUse = ++m_useCounter;
+    return it->value.result.get();
+}
+
+void HarfBuzzShapeCache::add(HarfBuzzShapeCacheKey&& key, HarfBuzzShapeResult& result)
+{
+    if (result.numGlyphs() > maximumGlyphsPerEntry)
+        return;
+
+    if (m_glyphCount + result.numGlyphs() > maximumCachedGlyphs)
+        prune();
+
+    HarfBuzzFace* face = key.face;
+    auto addResult = m_entries.add(WTF::move(key), Entry());
+    if (!addResult.isNewEntry)
+        return;
+
+    addResult.iterator->value.result = &result;
+    addResult.iterator->value.lastUse = ++m_useCounter;
+    m_glyphCount += result.numGlyphs();
+    m_entryCountForFace.add(face, 0).iterator->value++;
+}
+
+void HarfBuzzShapeCache::prune()
+{
+    // Drop the least recently used half in one go, so pruning is not repeated on every add.
+    Vector<unsigned> lastUses;
+    lastUses.reserveInitialCapacity(m_entries.size());
+    for (auto& entry : m_entries.values())
+        lastUses.uncheckedAppend(entry.lastUse);
+    auto median = lastUses.begin() + lastUses.size() / 2;
+    std::nth_element(lastUses.begin(), median, lastUses.end());
+    unsigned threshold = median == lastUses.end() ? 0 : *median;
+
+    m_entries.removeIf([this, threshold](WTF::KeyValuePair<HarfBuzzShapeCacheKey, Entry>& entry) {
+        if (entry.value.lastUse > threshold)
+            return false;
+        m_glyphCount -= entry.value.result->numGlyphs();
+        auto countIt = m_entryCountForFace.find(entry.key.face);
+        if (!--countIt->value)
+            m_entryCountForFace.remove(countIt);
+        return true;
+    });
+}
+
+void HarfBuzzShapeCache::removeEntriesForFace(HarfBuzzFace* face)
+{
+    if (!m_entryCountForFace.remove(face))
+        return;
+
+    m_entries.removeIf([this, face](WTF::KeyValuePair<HarfBuzzShapeCacheKey, Entry>& entry) {
+        if (entry.key.face != face)
+            return false;
+        m_glyphCount -= entry.value.result->numGlyphs();
+        return true;
+    });
+}
+
+void HarfBuzzShapeCache::clear()
+{
+    m_entries.clear();
+    m_entryCountForFace.clear();
+    m_glyphCount = 0;
+}
+
+} // namespace WebCore
@@ -0,0 +1,119 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HarfBuzzShapeCache_h
+#define HarfBuzzShapeCache_h
+
+#include "hb.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashTraits.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+class HarfBuzzFace;
+
+// The output of one hb_shape() call, before WebKit's letter-spacing, word-spacing
+// and justification are applied on top of it.
+class HarfBuzzShapeResult : public RefCounted<HarfBuzzShapeResult> {
+public:
+    static PassRefPtr<HarfBuzzShapeResult> create(hb_buffer_t* buffer) { return adoptRef(new HarfBuzzShapeResult(buffer)); }
+
+    unsigned numGlyphs() const { return m_glyphInfos.size(); }
+    const hb_glyph_info_t* glyphInfos() const { return m_glyphInfos.data(); }
+    const hb_glyph_position_t* glyphPositions() const { return m_glyphPositions.data(); }
+
+private:
+    explicit HarfBuzzShapeResult(hb_buffer_t*);
+
+    Vector<hb_glyph_info_t> m_glyphInfos;
+    Vector<hb_glyph_position_t> m_glyphPositions;
+};
+
+struct HarfBuzzShapeCacheKey {
+    HarfBuzzShapeCacheKey() { }
+    HarfBuzzShapeCacheKey(WTF::HashTableDeletedValueType) : face(reinterpret_cast<HarfBuzzFace*>(-1)) { }
+    HarfBuzzShapeCacheKey(HarfBuzzFace*, hb_script_t, hb_direction_t, const Vector<hb_feature_t, 4>&, const String& text);
+
+    bool isHashTableDeletedValue() const { return face == reinterpret_cast<HarfBuzzFace*>(-1); }
+    bool operator==(const HarfBuzzShapeCacheKey&) const;
+
+    HarfBuzzFace* face { nullptr };
+    hb_script_t script { HB_SCRIPT_INVALID };
+    // HB_DIRECTION_INVALID when HarfBuzz was left to guess the direction.
+    hb_direction_t direction { HB_DIRECTION_INVALID };
+    Vector<hb_feature_t> features;
+    String text;
+    unsigned hash { 0 };
+};
+
+struct HarfBuzzShapeCacheKeyHash {
+    static unsigned hash(const HarfBuzzShapeCacheKey& key) { return key.hash; }
+    static bool equal(const HarfBuzzShapeCacheKey& a, const HarfBuzzShapeCacheKey& b) { return a == b; }
+    static const bool safeToCompareToEmptyOrDeleted = true;
+};
+
+struct HarfBuzzShapeCacheKeyTraits : WTF::SimpleClassHashTraits<HarfBuzzShapeCacheKey> {
+    static const bool emptyValueIsZero = false;
+};
+
+// Shaping results shared by width measurement and painting, so a run of complex
+// text is shaped once rather than on every layout and paint. Entries belong to a
+// HarfBuzzFace, which removes them when it is destroyed.
+class HarfBuzzShapeCache {
+    WTF_MAKE_NONCOPYABLE(HarfBuzzShapeCache); WTF_MAKE_FAST_ALLOCATED;
+    friend NeverDestroyed<HarfBuzzShapeCache>;
+public:
+    static HarfBuzzShapeCache& singleton();
+
+    HarfBuzzShapeResult* find(const HarfBuzzShapeCacheKey&);
+    void add(HarfBuzzShapeCacheKey&&, HarfBuzzShapeResult&);
+
+    void removeEntriesForFace(HarfBuzzFace*);
+    void clear();
+
+private:
+    HarfBuzzShapeCache() { }
+
+    void prune();
+
+    struct Entry {
+        RefPtr<HarfBuzzShapeResult> result;
+        unsigned lastUse;
+    };
+
+    HashMap<HarfBuzzShapeCacheKey, Entry, HarfBuzzShapeCacheKeyHash, HarfBuzzShapeCacheKeyTraits> m_entries;
+    HashMap<HarfBuzzFace*, unsigned> m_entryCountForFace;
+    unsigned m_glyphCount { 0 };
+    unsigned m_useCounter { 0 };
+};
+
+} // namespace WebCore
+
+#endif // HarfBuzzShapeCache_h
@@ -33,6 +33,7 @@
 
 #include "FontCascade.h"
 #include "HarfBuzzFace.h"
+#include "HarfBuzzShapeCache.h"
 #include "SurrogatePairAwareTextIterator.h"
 #include <hb-icu.h>
 #include <unicode/normlzr.h>
@@ -81,9 +82,9 @@ HarfBuzzShaper::HarfBuzzRun::HarfBuzzRun(const Font* fontData, unsigned startInd
 {
 }
 
-void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(hb_buffer_t* harfBuzzBuffer)
+void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(const HarfBuzzShapeResult& shapeResult)
 {
-    m_numGlyphs = hb_buffer_get_length(harfBuzzBuffer);
+    m_numGlyphs = shapeResult.numGlyphs();
     m_glyphs.resize(m_numGlyphs);
     m_advances.resize(m_numGlyphs);
     m_glyphToCharacterIndexes.resize(m_numGlyphs);
@@ -464,6 +465,8 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns(bool shouldSetDirection)
 
     hb_buffer_set_unicode_funcs(harfBuzzBuffer.get(), hb_icu_get_unicode_funcs());
 
+    HarfBuzzShapeCache& shapeCache = HarfBuzzShapeCache::singleton();
+
     for (unsigned i = 0; i < m_harfBuzzRuns.size(); ++i) {
         unsigned runIndex = m_run.rtl() ? m_harfBuzzRuns.size() - i - 1 : i;
         HarfBuzzRun* currentRun = m_harfBuzzRuns[runIndex].get();
@@ -471,52 +474,66 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns(bool shouldSetDirection)
         if (currentFontData->isSVGFont())
             return false;
 
-        hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
-        if (shouldSetDirection)
-            hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->rtl() ? HB_DIRECTION_RTL : HB_DIRECTION_LTR);
-        else
-            // Leaving direction to HarfBuzz to guess is *really* bad, but will do for now.
-            hb_buffer_guess_segment_properties(harfBuzzBuffer.get());
-
-        // Add a space as pre-context to the buffer. This prevents showing dotted-circle
-        // for combining marks at the beginning of runs.
-        static const uint16_t preContext = ' ';
-        hb_buffer_add_utf16(harfBuzzBuffer.get(), &preContext, 1, 1, 0);
-
+        String text;
         if (m_font->isSmallCaps() && u_islower(m_normalizedBuffer[currentRun->startIndex()])) {
-            String upperText = String(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters()).upper();
-            currentFontData = m_font->glyphDataForCharacter(upperText[0], false, SmallCapsVariant).font;
-            const UChar* characters = StringView(upperText).upconvertedCharacters();
-            hb_buffer_add_utf16(harfBuzzBuffer.get(), reinterpret_cast<const uint16_t*>(characters), currentRun->numCharacters(), 0, currentRun->numCharacters());
+            text = String(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters()).upper().left(currentRun->numCharacters());
+            currentFontData = m_font->glyphDataForCharacter(text[0], false, SmallCapsVariant).font;
         } else
-            hb_buffer_add_utf16(harfBuzzBuffer.get(), reinterpret_cast<const uint16_t*>(m_normalizedBuffer.get() + currentRun->startIndex()), currentRun->numCharacters(), 0, currentRun->numCharacters());
+            text = String(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters());
 
         FontPlatformData* platformData = const_cast<FontPlatformData*>(&currentFontData->platformData());
         HarfBuzzFace* face = platformData->harfBuzzFace();
         if (!face)
             return false;
 
-        if (m_font->fontDescription().orientation() == Vertical)
-            face->setScriptForVerticalGlyphSubstitution(harfBuzzBuffer.get());
+        hb_direction_t direction = HB_DIRECTION_INVALID;
+        if (shouldSetDirection)
+            direction = currentRun->rtl() ? HB_DIRECTION_RTL : HB_DIRECTION_LTR;
+
+        // Measuring and painting the same run shape the same text, so look for an earlier result first.
+        HarfBuzzShapeCacheKey key(face, currentRun->script(), direction, m_features, text);
+        RefPtr<HarfBuzzShapeResult> shapeResult = shapeCache.find(key);
+        if (!shapeResult) {
+            hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
+            if (shouldSetDirection)
+                hb_buffer_set_direction(harfBuzzBuffer.get(), direction);
+            else
+                // Leaving direction to HarfBuzz to guess is *really* bad, but will do for now.
+                hb_buffer_guess_segment_properties(harfBuzzBuffer.get());
 
-        HarfBuzzScopedPtr<hb_font_t> harfBuzzFont(face->createFont(), hb_font_destroy);
+            // Add a space as pre-context to the buffer. This prevents showing dotted-circle
+            // for combining marks at the beginning of runs.
+            static const uint16_t preContext = ' ';
+            hb_buffer_add_utf16(harfBuzzBuffer.get(), &preContext, 1, 1, 0);
 
-        hb_shape(harfBuzzFont.get(), harfBuzzBuffer.get(), m_features.isEmpty() ? 0 : m_features.data(), m_features.size());
+            StringView::UpconvertedCharacters characters = StringView(text).upconvertedCharacters();
+            hb_buffer_add_utf16(harfBuzzBuffer.get(), reinterpret_cast<const uint16_t*>(characters.get()), text.length(), 0, text.length());
 
-        currentRun->applyShapeResult(harfBuzzBuffer.get());
-        setGlyphPositionsForHarfBuzzRun(currentRun, harfBuzzBuffer.get());
+            if (m_font->fontDescription().orientation() == Vertical)
+                face->setScriptForVerticalGlyphSubstitution(harfBuzzBuffer.get());
+
+            HarfBuzzScopedPtr<hb_font_t> harfBuzzFont(face->createFont(), hb_font_destroy);
+
+            hb_shape(harfBuzzFont.get(), harfBuzzBuffer.get(), m_features.isEmpty() ? 0 : m_features.data(), m_features.size());
+
+            shapeResult = HarfBuzzShapeResult::create(harfBuzzBuffer.get());
+            shapeCache.add(WTF::move(key), *shapeResult);
+
+            hb_buffer_reset(harfBuzzBuffer.get());
+        }
 
-        hb_buffer_reset(harfBuzzBuffer.get());
+        currentRun->applyShapeResult(*shapeResult);
+        setGlyphPositionsForHarfBuzzRun(currentRun, *shapeResult);
     }
 
     return true;
 }
 
-void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, hb_buffer_t* harfBuzzBuffer)
+void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, const HarfBuzzShapeResult& shapeResult)
 {
     const Font* currentFontData = currentRun->fontData();
-    hb_glyph_info_t* glyphInfos = hb_buffer_get_glyph_infos(harfBuzzBuffer, 0);
-    hb_glyph_position_t* glyphPositions = hb_buffer_get_glyph_positions(harfBuzzBuffer, 0);
+    const hb_glyph_info_t* glyphInfos = shapeResult.glyphInfos();
+    const hb_glyph_position_t* glyphPositions = shapeResult.glyphPositions();
 
     unsigned numGlyphs = currentRun->numGlyphs();
     uint16_t* glyphToCharacterIndexes = currentRun->glyphToCharacterIndexes();
@@ -44,6 +44,7 @@ namespace WebCore {
 
 class Font;
 class FontCascade;
+class HarfBuzzShapeResult;
 
 class HarfBuzzShaper {
 public:
@@ -66,7 +67,7 @@ private:
     public:
         HarfBuzzRun(const Font*, unsigned startIndex, unsigned numCharacters, TextDirection, hb_script_t);
 
-        void applyShapeResult(hb_buffer_t*);
+        void applyShapeResult(const HarfBuzzShapeResult&);
         void setGlyphAndPositions(unsigned index, uint16_t glyphId, float advance, float offsetX, float offsetY);
         void setWidth(float width) { m_width = width; }
 
@@ -116,7 +117,7 @@ private:
     bool shapeHarfBuzzRuns(bool shouldSetDirection);
     bool fillGlyphBuffer(GlyphBuffer*);
     void fillGlyphBufferFromHarfBuzzRun(GlyphBuffer*, HarfBuzzRun*, FloatPoint& firstOffsetOfNextRun);
-    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, hb_buffer_t*);
+    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, const HarfBuzzShapeResult&);
 
     GlyphBufferAdvance createGlyphBufferAdvance(float, float);
 
@@ -23,6 +23,7 @@
 #include "BitmapTexturePool.h"
 #include "FilterOperations.h"
 #include "GraphicsLayer.h"
+#include "TextureMapperImageBuffer.h"
 #include "Timer.h"
 #include <wtf/CurrentTime.h>
 
@@ -37,9 +38,15 @@ PassRefPtr<BitmapTexture> TextureMapper::acquireTextureFromPool(const IntSize& s
     return selectedTexture.release();
 }
 
-std::unique_ptr<TextureMapper> TextureMapper::create()
+std::unique_ptr<TextureMapper> TextureMapper::create(AccelerationMode mode)
 {
-    return platformCreateAccelerated();
+    if (mode == OpenGLMode) {
+        if (std::unique_ptr<TextureMapper> textureMapper = platformCreateAccelerated())
+            return textureMapper;
+    }
+
+    // Without GL, composite on the CPU rather than not at all.
+    return std::make_unique<TextureMapperImageBuffer>();
 }
 
 TextureMapper::TextureMapper()
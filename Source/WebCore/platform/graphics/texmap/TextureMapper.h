@@ -56,9 +56,11 @@ public:
         RepeatWrap
     };
 
+    enum AccelerationMode { SoftwareMode, OpenGLMode };
+
     typedef unsigned PaintFlags;
 
-    static std::unique_ptr<TextureMapper> create();
+    static std::unique_ptr<TextureMapper> create(AccelerationMode = OpenGLMode);
 
     explicit TextureMapper();
     virtual ~TextureMapper();
@@ -0,0 +1,68 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TextureMapperImageBuffer_h
+#define TextureMapperImageBuffer_h
+
+#include "BitmapTextureImageBuffer.h"
+#include "TextureMapper.h"
+
+#if USE(TEXTURE_MAPPER)
+
+namespace WebCore {
+
+// Composites layers on the CPU through GraphicsContext, for ports and
+// machines that have no OpenGL. Every layer backing is a BitmapTextureImageBuffer.
+class TextureMapperImageBuffer : public TextureMapper {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    TextureMapperImageBuffer();
+
+    // TextureMapper implementation
+    virtual void drawBorder(const Color&, float borderWidth, const FloatRect&, const TransformationMatrix&) override;
+    virtual void drawNumber(int number, const Color&, const FloatPoint&, const TransformationMatrix&) override;
+    virtual void drawTexture(const BitmapTexture&, const FloatRect& targetRect, const TransformationMatrix&, float opacity, unsigned exposedEdges) override;
+    virtual void drawSolidColor(const FloatRect&, const TransformationMatrix&, const Color&) override;
+    virtual void beginClip(const TransformationMatrix&, const FloatRect&) override;
+    virtual void bindSurface(BitmapTexture* surface) override { m_currentSurface = surface; }
+    virtual void endClip() override;
+    virtual IntRect clipBounds() override;
+    virtual IntSize maxTextureSize() const override;
+    virtual PassRefPtr<BitmapTexture> createTexture() override { return BitmapTextureImageBuffer::create(); }
+
+    inline GraphicsContext* currentContext()
+    {
+        return m_currentSurface ? static_cast<BitmapTextureImageBuffer*>(m_currentSurface.get())->graphicsContext() : graphicsContext();
+    }
+
+private:
+    void concatTransform(GraphicsContext&, const TransformationMatrix&);
+
+    RefPtr<BitmapTexture> m_currentSurface;
+};
+
+}
+
+#endif // USE(TEXTURE_MAPPER)
+
+#endif // TextureMapperImageBuffer_h
@@ -69,6 +69,7 @@ static CGContextRef CGContextWithHDC(HDC hdc, bool hasAlpha)
 
 GraphicsContext::GraphicsContext(HDC hdc, bool hasAlpha)
     : m_updatingControlTints(false),
+      m_decodesImagesAsynchronously(false),
       m_transparencyCount(0)
 {
     platformInit(hdc, hasAlpha);
@@ -68,6 +68,7 @@ static cairo_t* createCairoContextWithHDC(HDC hdc, bool hasAlpha)
 
 GraphicsContext::GraphicsContext(HDC dc, bool hasAlpha)
     : m_updatingControlTints(false),
+      m_decodesImagesAsynchronously(false),
       m_transparencyCount(0)
 {
     platformInit(dc, hasAlpha);
@@ -284,7 +284,7 @@ unsigned ImageDecoder::frameBytesAtIndex(size_t index) const
     if (m_frameBufferCache.size() <= index)
         return 0;
     // FIXME: Use the dimension of the requested frame.
-    return m_size.area() * sizeof(ImageFrame::PixelData);
+    return scaledSize().area() * sizeof(ImageFrame::PixelData);
 }
 
 void ImageDecoder::prepareScaleDataIfNecessary()
@@ -293,8 +293,10 @@ void ImageDecoder::prepareScaleDataIfNecessary()
     m_scaledColumns.clear();
     m_scaledRows.clear();
 
-    int width = size().width();
-    int height = size().height();
+    // Subsampling happens first, so down-sample whatever it leaves us with.
+    IntSize decodedSize = subsampledSize();
+    int width = decodedSize.width();
+    int height = decodedSize.height();
     int numPixels = height * width;
     if (m_maxNumPixels <= 0 || numPixels <= m_maxNumPixels)
         return;
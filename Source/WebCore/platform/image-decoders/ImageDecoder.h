@@ -247,6 +247,7 @@ namespace WebCore {
             : m_scaled(false)
             , m_premultiplyAlpha(alphaOption == ImageSource::AlphaPremultiplied)
             , m_ignoreGammaAndColorProfile(gammaAndColorProfileOption == ImageSource::GammaAndColorProfileIgnored)
+            , m_subsamplingLevel(0)
             , m_sizeAvailable(false)
             , m_maxNumPixels(-1)
             , m_isAllDataReceived(false)
@@ -262,6 +263,7 @@ namespace WebCore {
         virtual String filenameExtension() const = 0;
 
         bool isAllDataReceived() const { return m_isAllDataReceived; }
+        SharedBuffer* data() const { return m_data.get(); }
 
         virtual void setData(SharedBuffer* data, bool allDataReceived)
         {
@@ -283,9 +285,23 @@ namespace WebCore {
 
         IntSize scaledSize() const
         {
-            return m_scaled ? IntSize(m_scaledColumns.size(), m_scaledRows.size()) : size();
+            return m_scaled ? IntSize(m_scaledColumns.size(), m_scaledRows.size()) : subsampledSize();
         }
 
+        // Decoders that support subsampling can produce frames at 1/2, 1/4 or 1/8 of the image size
+        // for less than the cost of a full decode. The level has to be set before decoding starts;
+        // decoders that don't support subsampling ignore it.
+        virtual bool supportsSubsampling() const { return false; }
+        SubsamplingLevel subsamplingLevel() const { return m_subsamplingLevel; }
+        void setSubsamplingLevel(SubsamplingLevel level) { m_subsamplingLevel = supportsSubsampling() ? level : 0; }
+
+        static IntSize subsampledSize(const IntSize& size, SubsamplingLevel level)
+        {
+            int divisor = 1 << level;
+            return IntSize((size.width() + divisor - 1) / divisor, (size.height() + divisor - 1) / divisor);
+        }
+        IntSize subsampledSize() const { return subsampledSize(size(), m_subsamplingLevel); }
+
         // This will only differ from size() for ICO (where each frame is a
         // different icon) or other formats where different frames are different
         // sizes.  This does NOT differ from size() for GIF, since decoding GIFs
@@ -421,6 +437,7 @@ namespace WebCore {
         bool m_premultiplyAlpha;
         bool m_ignoreGammaAndColorProfile;
         ImageOrientation m_orientation;
+        SubsamplingLevel m_subsamplingLevel;
 
     private:
         // Some code paths compute the size of the image as "width * height * 4"
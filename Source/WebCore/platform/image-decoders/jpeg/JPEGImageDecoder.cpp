@@ -393,8 +393,16 @@ public:
             // image is a sequential JPEG.
             m_info.buffered_image = jpeg_has_multiple_scans(&m_info);
 
+            // Let libjpeg scale the image down while it is still in the DCT
+            // domain, which skips most of the work of a full-size decode.
+            if (SubsamplingLevel subsamplingLevel = m_decoder->subsamplingLevel()) {
+                m_info.scale_num = 1;
+                m_info.scale_denom = 1 << subsamplingLevel;
+            }
+
             // Used to set up image size so arrays can be allocated.
             jpeg_calc_output_dimensions(&m_info);
+            ASSERT(static_cast<int>(m_info.output_width) == m_decoder->subsampledSize().width());
 
             // Make a one-row-high sample array that will go away when done with
             // image. Always make it big enough to hold an RGB row. Since this
@@ -131,6 +131,7 @@ class RenderStyle: public RefCounted<RenderStyle> {
     friend class StyleBuilderConverter; // Sets members directly.
     friend class StyleBuilderCustom; // Sets members directly.
     friend class StyleBuilderFunctions; // Sets members directly.
+    friend class StyleDataInterner; // Replaces sub-structures with equal shared instances.
     friend class StyleResolver; // Sets members directly.
 
 public:
@@ -39,6 +39,7 @@
 #include "StyleBoxData.cpp"
 #include "StyleCachedImage.cpp"
 #include "StyleCachedImageSet.cpp"
+#include "StyleDataInterner.cpp"
 #include "StyleDeprecatedFlexibleBoxData.cpp"
 #include "StyleFilterData.cpp"
 #include "StyleFlexibleBoxData.cpp"
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StyleDataInterner.h"
+
+#include "Document.h"
+#include "RenderElement.h"
+#include "RenderView.h"
+#include "StyleResolver.h"
+#include <wtf/DataLog.h>
+#include <wtf/StringHasher.h>
+#include <wtf/text/CString.h>
+
+namespace WebCore {
+
+// Prune after this many interned styles so blocks of destroyed styles don't linger.
+static const unsigned internsBetweenPrunes = 1024;
+
+// The hashes below only need to cover enough of each structure to spread the table;
+// candidates with equal hashes are compared with the structure's own operator==.
+class StyleDataHasher {
+public:
+    void add(unsigned value) { m_values.append(value); }
+    void add(int value) { add(static_cast<unsigned>(value)); }
+    void add(float value) { add(bitwise_cast<unsigned>(value)); }
+    void add(const Color& color) { add(color.isValid() ? color.rgb() : 0); }
+
+    void add(const Length& length)
+    {
+        add(static_cast<unsigned>(length.type()));
+        if (!length.isUndefined() && !length.isCalculated())
+            add(length.value());
+    }
+
+    void add(const LengthBox& box)
+    {
+        add(box.top());
+        add(box.right());
+        add(box.bottom());
+        add(box.left());
+    }
+
+    unsigned hash() const { return StringHasher::hashMemory(m_values.data(), m_values.size() * sizeof(unsigned)); }
+
+private:
+    Vector<unsigned, 32> m_values;
+};
+
+static unsigned computeHash(const StyleBoxData& data)
+{
+    StyleDataHasher hasher;
+    hasher.add(data.width());
+    hasher.add(data.height());
+    hasher.add(data.minWidth());
+    hasher.add(data.maxWidth());
+    hasher.add(data.minHeight());
+    hasher.add(data.maxHeight());
+    hasher.add(data.verticalAlign());
+    hasher.add(data.zIndex());
+    return hasher.hash();
+}
+
+static unsigned computeHash(const StyleVisualData& data)
+{
+    StyleDataHasher hasher;
+    hasher.add(data.clip);
+    hasher.add(data.textDecoration);
+    hasher.add(data.m_zoom);
+    return hasher.hash();
+}
+
+static unsigned computeHash(const StyleBackgroundData& data)
+{
+    StyleDataHasher hasher;
+    hasher.add(data.color());
+    hasher.add(data.outline().width());
+    hasher.add(data.outline().color());
+    hasher.add(static_cast<unsigned>(data.background().hasImage()));
+    return hasher.hash();
+}
+
+static unsigned computeHash(const StyleSurroundData& data)
+{
+    StyleDataHasher hasher;
+    hasher.add(data.offset);
+    hasher.add(data.margin);
+    hasher.add(data.padding);
+    hasher.add(data.border.left().width());
+    hasher.add(data.border.right().width());
+    hasher.add(data.border.top().width());
+    hasher.add(data.border.bottom().width());
+    hasher.add(data.border.top().color());
+    return hasher.hash();
+}
+
+static unsigned computeHash(const StyleRareNonInheritedData& data)
+{
+    StyleDataHasher hasher;
+    hasher.add(data.opacity);
+    hasher.add(data.m_perspective);
+    hasher.add(data.m_order);
+    hasher.add(data.m_appearance);
+    hasher.add(data.m_altText.impl() ? data.m_altText.impl()->hash() : 0);
+    return hasher.hash();
+}
+
+static unsigned computeHash(const StyleRareInheritedData& data)
+{
+    StyleDataHasher hasher;
+    hasher.add(data.textStrokeColor);
+    hasher.add(data.textStrokeWidth);
+    hasher.add(data.indent);
+    hasher.add(data.widows);
+    return hasher.hash();
+}
+
+static unsigned computeHash(const StyleInheritedData& data)
+{
+    StyleDataHasher hasher;
+    hasher.add(data.line_height);
+    hasher.add(data.fontCascade.fontDescription().computedSize());
+    hasher.add(data.color);
+    hasher.add(data.visitedLinkColor);
+    hasher.add(data.horizontal_border_spacing);
+    hasher.add(data.vertical_border_spacing);
+    return hasher.hash();
+}
+
+template<typename T>
+bool StyleDataInterner::Table<T>::intern(DataRef<T>& data)
+{
+    unsigned hash = computeHash(*data);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) {
+        // The first block with a hash isn't kept; holding a reference to it would make the
+        // style copy it on its next change even if nothing ever shares it.
+        if (m_seenHashes.add(hash).isNewEntry)
+            return false;
+        it = m_entries.add(hash, Vector<Ref<T>, 1>()).iterator;
+    }
+
+    auto& candidates = it->value;
+    for (auto& candidate : candidates) {
+        if (candidate.ptr() == data.get())
+            return false;
+        if (candidate.get() == *data) {
+            data = DataRef<T>(candidate.copyRef());
+            return true;
+        }
+    }
+    candidates.append(const_cast<T&>(*data));
+    ++m_size;
+    return false;
+}
+
+template<typename T>
+void StyleDataInterner::Table<T>::prune()
+{
+    Vector<unsigned> emptyBuckets;
+    for (auto& bucket : m_entries) {
+        auto& candidates = bucket.value;
+        for (size_t i = candidates.size(); i--;) {
+            if (!candidates[i]->hasOneRef())
+                continue;
+            candidates.remove(i);
+            --m_size;
+        }
+        if (candidates.isEmpty())
+            emptyBuckets.append(bucket.key);
+    }
+    for (auto key : emptyBuckets)
+        m_entries.remove(key);
+    m_seenHashes.clear();
+}
+
+StyleDataInterner::StyleDataInterner()
+{
+}
+
+template<typename T>
+void StyleDataInterner::intern(Table<T>& table, DataRef<T>& data)
+{
+    ++m_lookups;
+    if (!table.intern(data))
+        return;
+    ++m_hits;
+    m_bytesSaved += sizeof(T);
+}
+
+void StyleDataInterner::intern(RenderStyle& style)
+{
+    intern(m_boxTable, style.m_box);
+    intern(m_visualTable, style.visual);
+    intern(m_backgroundTable, style.m_background);
+    intern(m_surroundTable, style.surround);
+    intern(m_rareNonInheritedTable, style.rareNonInheritedData);
+    intern(m_rareInheritedTable, style.rareInheritedData);
+    intern(m_inheritedTable, style.inherited);
+
+    if (++m_internsSinceLastPrune >= internsBetweenPrunes)
+        prune();
+}
+
+void StyleDataInterner::prune()
+{
+    m_internsSinceLastPrune = 0;
+    m_boxTable.prune();
+    m_visualTable.prune();
+    m_backgroundTable.prune();
+    m_surroundTable.prune();
+    m_rareNonInheritedTable.prune();
+    m_rareInheritedTable.prune();
+    m_inheritedTable.prune();
+}
+
+void StyleDataInterner::clear()
+{
+    m_internsSinceLastPrune = 0;
+    m_boxTable.clear();
+    m_visualTable.clear();
+    m_backgroundTable.clear();
+    m_surroundTable.clear();
+    m_rareNonInheritedTable.clear();
+    m_rareInheritedTable.clear();
+    m_inheritedTable.clear();
+}
+
+unsigned StyleDataInterner::size() const
+{
+    return m_boxTable.size() + m_visualTable.size() + m_backgroundTable.size() + m_surroundTable.size()
+        + m_rareNonInheritedTable.size() + m_rareInheritedTable.size() + m_inheritedTable.size();
+}
+
+struct StyleDataUsage {
+    HashSet<const void*> blocks;
+    unsigned references { 0 };
+};
+
+template<typename T>
+static void addUsage(StyleDataUsage& usage, const DataRef<T>& data)
+{
+    usage.blocks.add(data.get());
+    ++usage.references;
+}
+
+static void printUsage(const char* name, const StyleDataUsage& usage, size_t blockSize, size_t& totalBytes, size_t& totalUnsharedBytes)
+{
+    size_t bytes = usage.blocks.size() * blockSize;
+    size_t unsharedBytes = usage.references * blockSize;
+    dataLogF("%-24s %10u %10u %12zu %12zu\n", name, usage.blocks.size(), usage.references, bytes, unsharedBytes);
+    totalBytes += bytes;
+    totalUnsharedBytes += unsharedBytes;
+}
+
+void StyleDataInterner::dumpMemoryReport(Document& document)
+{
+    RenderView* renderView = document.renderView();
+    if (!renderView)
+        return;
+
+    HashSet<const RenderStyle*> styles;
+    StyleDataUsage box, visual, background, surround, rareNonInherited, rareInherited, inherited, svg;
+    auto addStyle = [&](const RenderStyle& style) {
+        if (!styles.add(&style).isNewEntry)
+            return;
+        addUsage(box, style.m_box);
+        addUsage(visual, style.visual);
+        addUsage(background, style.m_background);
+        addUsage(surround, style.surround);
+        addUsage(rareNonInherited, style.rareNonInheritedData);
+        addUsage(rareInherited, style.rareInheritedData);
+        addUsage(inherited, style.inherited);
+        addUsage(svg, style.m_svgStyle);
+    };
+
+    unsigned renderers = 0;
+    for (RenderObject* renderer = renderView; renderer; renderer = renderer->nextInPreOrder()) {
+        if (!is<RenderElement>(*renderer))
+            continue;
+        ++renderers;
+        const RenderStyle& style = downcast<RenderElement>(*renderer).style();
+        addStyle(style);
+        if (auto* pseudoStyles = style.cachedPseudoStyles()) {
+            for (auto& pseudoStyle : *pseudoStyles)
+                addStyle(*pseudoStyle);
+        }
+    }
+
+    size_t totalBytes = styles.size() * sizeof(RenderStyle);
+    size_t totalUnsharedBytes = renderers * sizeof(RenderStyle);
+
+    dataLogF("Style memory for %s\n", document.url().string().utf8().data());
+    dataLogF("%-24s %10s %10s %12s %12s\n", "Structure", "Blocks", "Refs", "Bytes", "Unshared");
+    dataLogF("%-24s %10u %10u %12zu %12zu\n", "RenderStyle", styles.size(), renderers, totalBytes, totalUnsharedBytes);
+    printUsage("StyleBoxData", box, sizeof(StyleBoxData), totalBytes, totalUnsharedBytes);
+    printUsage("StyleVisualData", visual, sizeof(StyleVisualData), totalBytes, totalUnsharedBytes);
+    printUsage("StyleBackgroundData", background, sizeof(StyleBackgroundData), totalBytes, totalUnsharedBytes);
+    printUsage("StyleSurroundData", surround, sizeof(StyleSurroundData), totalBytes, totalUnsharedBytes);
+    printUsage("StyleRareNonInheritedData", rareNonInherited, sizeof(StyleRareNonInheritedData), totalBytes, totalUnsharedBytes);
+    printUsage("StyleRareInheritedData", rareInherited, sizeof(StyleRareInheritedData), totalBytes, totalUnsharedBytes);
+    printUsage("StyleInheritedData", inherited, sizeof(StyleInheritedData), totalBytes, totalUnsharedBytes);
+    printUsage("SVGRenderStyle", svg, sizeof(SVGRenderStyle), totalBytes, totalUnsharedBytes);
+    dataLogF("%-24s %10s %10s %12zu %12zu\n", "Total", "", "", totalBytes, totalUnsharedBytes);
+
+    if (StyleResolver* resolver = document.styleResolverIfExists()) {
+        const StyleDataInterner& interner = resolver->styleDataInterner();
+        dataLogF("Interned blocks %u, lookups %llu, hits %llu, bytes saved %llu\n", interner.size(),
+            static_cast<unsigned long long>(interner.lookups()), static_cast<unsigned long long>(interner.hits()),
+            static_cast<unsigned long long>(interner.bytesSaved()));
+    }
+    dataLogF("\n");
+}
+
+} // namespace WebCore
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef StyleDataInterner_h
+#define StyleDataInterner_h
+
+#include "RenderStyle.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class Document;
+
+// Deduplicates the DataRef sub-structures of freshly resolved styles. Equal blocks
+// produced for unrelated elements are otherwise only shared when copied from a parent
+// or a shared sibling. Interned blocks are shared copy-on-write like any other DataRef.
+// A block is only kept in the table once a second block with the same hash comes along,
+// so blocks no other style could share stay uniquely owned and are modified in place.
+class StyleDataInterner {
+    WTF_MAKE_NONCOPYABLE(StyleDataInterner); WTF_MAKE_FAST_ALLOCATED;
+public:
+    StyleDataInterner();
+
+    void intern(RenderStyle&);
+
+    // Drops table entries that are no longer referenced by any style.
+    void prune();
+    void clear();
+
+    unsigned size() const;
+
+    uint64_t lookups() const { return m_lookups; }
+    uint64_t hits() const { return m_hits; }
+    uint64_t bytesSaved() const { return m_bytesSaved; }
+
+    static void dumpMemoryReport(Document&);
+
+private:
+    template<typename T> class Table {
+    public:
+        bool intern(DataRef<T>&);
+        void prune();
+        void clear() { m_entries.clear(); m_seenHashes.clear(); m_size = 0; }
+        unsigned size() const { return m_size; }
+
+    private:
+        HashMap<unsigned, Vector<Ref<T>, 1>> m_entries;
+        HashSet<unsigned> m_seenHashes;
+        unsigned m_size { 0 };
+    };
+
+    template<typename T> void intern(Table<T>&, DataRef<T>&);
+
+    Table<StyleBoxData> m_boxTable;
+    Table<StyleVisualData> m_visualTable;
+    Table<StyleBackgroundData> m_backgroundTable;
+    Table<StyleSurroundData> m_surroundTable;
+    Table<StyleRareNonInheritedData> m_rareNonInheritedTable;
+    Table<StyleRareInheritedData> m_rareInheritedTable;
+    Table<StyleInheritedData> m_inheritedTable;
+
+    unsigned m_internsSinceLastPrune { 0 };
+    uint64_t m_lookups { 0 };
+    uint64_t m_hits { 0 };
+    uint64_t m_bytesSaved { 0 };
+};
+
+} // namespace WebCore
+
+#endif // StyleDataInterner_h
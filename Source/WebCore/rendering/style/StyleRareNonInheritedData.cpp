@@ -232,6 +232,7 @@ bool StyleRareNonInheritedData::operator==(const StyleRareNonInheritedData& o) c
         && m_scrollSnapPoints == o.m_scrollSnapPoints
 #endif
         && contentDataEquivalent(o)
+        && m_altText == o.m_altText
         && counterDataEquivalent(o)
         && shadowDataEquivalent(o)
         && reflectionDataEquivalent(o)
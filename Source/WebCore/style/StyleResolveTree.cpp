@@ -862,7 +862,10 @@ void resolveTree(Document& document, Change change)
     if (change < Inherit && !documentElement->childNeedsStyleRecalc() && !documentElement->needsStyleRecalc())
         return;
     RenderTreePosition renderTreePosition(*document.renderView());
+    document.ensureStyleResolver().setMatchedRulesCacheEnabled(true);
     resolveTree(*documentElement, *document.renderStyle(), renderTreePosition, change);
+    if (StyleResolver* styleResolver = document.styleResolverIfExists())
+        styleResolver->setMatchedRulesCacheEnabled(false);
 }
 
 void detachRenderTree(Element& element)
@@ -279,6 +279,13 @@ IntRect FlChromeClient::windowResizerRect() const {
 
 void FlChromeClient::invalidateRootView(const IntRect &rect) {
 
+	if (view->priv->compositor->enabled()) {
+		if (rect.width() < 2)
+			view->priv->compositor->setNonCompositedContentsNeedDisplay(IntRect());
+		else
+			view->priv->compositor->setNonCompositedContentsNeedDisplay(rect);
+	}
+
 	if (rect.width() < 2)
 		view->redraw();
 	else
@@ -288,10 +295,13 @@ void FlChromeClient::invalidateRootView(const IntRect &rect) {
 }
 
 void FlChromeClient::invalidateContentsAndRootView(const IntRect &rect) {
+	view->priv->displaylistvalid = false;
 	invalidateRootView(rect);
 }
 
 void FlChromeClient::invalidateContentsForSlowScroll(const IntRect &rect) {
+	// Slow scrolls move fixed content, so the recording can't be reused.
+	view->priv->displaylistvalid = false;
 	invalidateRootView(rect);
 }
 
@@ -422,8 +432,8 @@ void FlChromeClient::loadIconForFiles(const Vector<String>&, FileIconLoader*) {
 	notImplemented();
 }
 
-void FlChromeClient::attachRootGraphicsLayer(Frame*, GraphicsLayer*) {
-	notImplemented();
+void FlChromeClient::attachRootGraphicsLayer(Frame*, GraphicsLayer *layer) {
+	view->priv->compositor->setRootCompositingLayer(layer);
 }
 
 void FlChromeClient::setNeedsOneShotDrawingSynchronization() {
@@ -431,7 +441,7 @@ void FlChromeClient::setNeedsOneShotDrawingSynchronization() {
 }
 
 void FlChromeClient::scheduleCompositingLayerFlush() {
-	notImplemented();
+	view->priv->compositor->scheduleLayerFlush();
 }
 
 bool FlChromeClient::selectItemWritingDirectionIsNatural() {
@@ -0,0 +1,163 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "compositor.h"
+#include "webviewpriv.h"
+
+#include <FL/Fl.H>
+
+#include <FrameView.h>
+#include <GraphicsLayerTextureMapper.h>
+#include <MainFrame.h>
+#include <TextureMapperLayer.h>
+
+using namespace WebCore;
+
+FlCompositor::FlCompositor(webview *inview) {
+	view = inview;
+	rootGraphicsLayer = NULL;
+	flushScheduled = false;
+}
+
+FlCompositor::~FlCompositor() {
+	if (flushScheduled)
+		Fl::remove_timeout(flushTimeout, this);
+}
+
+void FlCompositor::setRootCompositingLayer(GraphicsLayer *layer) {
+
+	rootGraphicsLayer = layer;
+
+	if (!layer) {
+		nonCompositedContentLayer = nullptr;
+		rootLayer = nullptr;
+		textureMapper = nullptr;
+		view->redraw();
+		return;
+	}
+
+	// The page itself goes into one layer below everything WebCore
+	// composites, so the layers can be drawn over it without repainting it.
+	rootLayer = GraphicsLayer::create(nullptr, *this);
+	rootLayer->setDrawsContent(false);
+	rootLayer->setMasksToBounds(false);
+
+	nonCompositedContentLayer = GraphicsLayer::create(nullptr, *this);
+	nonCompositedContentLayer->setDrawsContent(true);
+	nonCompositedContentLayer->setContentsOpaque(true);
+	nonCompositedContentLayer->setMasksToBounds(true);
+
+	rootLayer->addChild(nonCompositedContentLayer.get());
+	nonCompositedContentLayer->addChild(layer);
+
+	resizeRootLayer(IntSize(view->priv->w, view->priv->h));
+
+	textureMapper = TextureMapper::create(TextureMapper::SoftwareMode);
+	downcast<GraphicsLayerTextureMapper>(*rootLayer).layer().setTextureMapper(textureMapper.get());
+
+	scheduleLayerFlush();
+}
+
+void FlCompositor::setNonCompositedContentsNeedDisplay(const IntRect &rect) {
+	if (!nonCompositedContentLayer)
+		return;
+
+	if (rect.isEmpty())
+		nonCompositedContentLayer->setNeedsDisplay();
+	else
+		nonCompositedContentLayer->setNeedsDisplayInRect(rect);
+}
+
+void FlCompositor::resizeRootLayer(const IntSize &size) {
+	if (!rootLayer)
+		return;
+
+	rootLayer->setSize(size);
+	nonCompositedContentLayer->setSize(size);
+	nonCompositedContentLayer->setNeedsDisplay();
+	scheduleLayerFlush();
+}
+
+void FlCompositor::scheduleLayerFlush() {
+	if (flushScheduled)
+		return;
+
+	// Wait for the event loop: this may be called from inside a draw,
+	// where a redraw request would be dropped.
+	flushScheduled = true;
+	Fl::add_timeout(0, flushTimeout, this);
+}
+
+void FlCompositor::flushTimeout(void *data) {
+	FlCompositor *c = (FlCompositor *) data;
+	c->flushScheduled = false;
+	c->view->redraw();
+}
+
+void FlCompositor::flushPendingLayerChanges() {
+	FrameView *fv = view->priv->page->mainFrame().view();
+
+	rootLayer->flushCompositingStateForThisLayerOnly();
+	nonCompositedContentLayer->flushCompositingStateForThisLayerOnly();
+	fv->flushCompositingStateIncludingSubframes();
+
+	downcast<GraphicsLayerTextureMapper>(*rootLayer).updateBackingStoreIncludingSubLayers();
+}
+
+void FlCompositor::composite(GraphicsContext *gc, const IntRect &clip) {
+	if (!rootLayer)
+		return;
+
+	flushPendingLayerChanges();
+
+	TextureMapperLayer &layer = downcast<GraphicsLayerTextureMapper>(*rootLayer).layer();
+	layer.applyAnimationsRecursively();
+
+	gc->save();
+	gc->clip(clip);
+
+	textureMapper->setGraphicsContext(gc);
+	textureMapper->beginPainting();
+	layer.paint();
+	textureMapper->endPainting();
+	textureMapper->setGraphicsContext(NULL);
+
+	gc->restore();
+
+	if (layer.descendantsOrSelfHaveRunningAnimations())
+		scheduleLayerFlush();
+}
+
+void FlCompositor::notifyFlushRequired(const GraphicsLayer *) {
+	scheduleLayerFlush();
+}
+
+void FlCompositor::paintContents(const GraphicsLayer *, GraphicsContext &gc,
+			GraphicsLayerPaintingPhase, const FloatRect &clip) {
+
+	FrameView *fv = view->priv->page->mainFrame().view();
+	const IntRect rect = enclosingIntRect(clip);
+
+	// Layer tiles are painted like the window is.
+	gc.setDecodesImagesAsynchronously(view->priv->gc->decodesImagesAsynchronously());
+
+	gc.save();
+	gc.clip(rect);
+	fv->paint(&gc, rect);
+	gc.restore();
+}
@@ -0,0 +1,65 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef compositor_h
+#define compositor_h
+
+#include <GraphicsLayer.h>
+#include <GraphicsLayerClient.h>
+#include <IntRect.h>
+#include <TextureMapper.h>
+#include "webview.h"
+
+#include <memory>
+
+// Composites WebCore's accelerated layers on the CPU. Layer contents are
+// cached in TextureMapperImageBuffer textures, so a moving or fading layer
+// only costs a re-composite, not a repaint of the page under it.
+class FlCompositor: public WebCore::GraphicsLayerClient {
+public:
+	FlCompositor(webview *);
+	~FlCompositor();
+
+	bool enabled() const { return rootGraphicsLayer != nullptr; }
+
+	void setRootCompositingLayer(WebCore::GraphicsLayer *);
+	void setNonCompositedContentsNeedDisplay(const WebCore::IntRect &);
+	void resizeRootLayer(const WebCore::IntSize &);
+	void scheduleLayerFlush();
+
+	void composite(WebCore::GraphicsContext *, const WebCore::IntRect &clip);
+
+	// GraphicsLayerClient
+	void notifyFlushRequired(const WebCore::GraphicsLayer *) override;
+	void paintContents(const WebCore::GraphicsLayer *, WebCore::GraphicsContext &,
+			WebCore::GraphicsLayerPaintingPhase,
+			const WebCore::FloatRect &) override;
+
+private:
+	static void flushTimeout(void *);
+	void flushPendingLayerChanges();
+
+	webview *view;
+
+	WebCore::GraphicsLayer *rootGraphicsLayer;
+	std::unique_ptr<WebCore::GraphicsLayer> rootLayer;
+	std::unique_ptr<WebCore::GraphicsLayer> nonCompositedContentLayer;
+	std::unique_ptr<WebCore::TextureMapper> textureMapper;
+
+	bool flushScheduled;
+};
+
+#endif
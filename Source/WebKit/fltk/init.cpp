@@ -20,7 +20,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <runtime/JSExportMacros.h>
 
 #include <ApplicationCacheStorage.h>
+#include <CairoGlyphCache.h>
 #include <CrossOriginPreflightResultCache.h>
+#include <Document.h>
 #include <FontCache.h>
 #include <GCController.h>
 #include <IconDatabase.h>
@@ -28,16 +30,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <ImageSource.h>
 #include <Logging.h>
 #include <MemoryCache.h>
+#include <MemoryPressureHandler.h>
 #include <Page.h>
 #include <PageCache.h>
 #include <PageGroup.h>
 #include <ResourceHandle.h>
+#include <StyleDataInterner.h>
+#include <StyleResolver.h>
+#include <StyleSheetContentsCache.h>
 #include <TextEncodingRegistry.h>
 #include "webkit.h"
 
 #include "platformstrategy.h"
 
 #include <runtime/InitializeThreading.h>
+#include <wtf/FastMalloc.h>
 #include <wtf/MainThread.h>
 #include <wtf/spoofing.h>
 
@@ -93,6 +100,8 @@ void webkitInit() {
 			runtime, required);
 		exit(1);
 	}
+
+	WebCore::MemoryPressureHandler::singleton().install();
 }
 
 void wk_set_useragent_func(const char * (*func)(const char *)) {
@@ -123,6 +132,12 @@ void wk_set_download_func(void (*func)(const char *url, const char *file)) {
 	downloadfunc = func;
 }
 
+void wk_set_memory_pressure_thresholds(const unsigned noncritical_percent,
+					const unsigned critical_percent) {
+	WebCore::MemoryPressureHandler::singleton().setThresholds(noncritical_percent,
+								critical_percent);
+}
+
 #ifdef None
 #undef None
 // We don't want the X11 definition in this file.
@@ -144,6 +159,15 @@ void wk_drop_caches() {
 
 	pageCache.pruneToSizeNow(0, PruningReason::None);
 
+	// Drop parsed style sheets kept for content-identical reloads.
+	WebCore::StyleSheetContentsCache::singleton().clear();
+
+	// Drop the interned style blocks of every document.
+	for (WebCore::Document *doc: WebCore::Document::allDocuments()) {
+		if (WebCore::StyleResolver *resolver = doc->styleResolverIfExists())
+			resolver->clearStyleDataInterner();
+	}
+
 	// Invalidating the font cache and freeing all inactive font data.
 	fontCache.invalidate();
 
@@ -155,6 +179,31 @@ void wk_drop_caches() {
 
 	// Run GC
 	WebCore::gcController().garbageCollectNow();
+
+	// Return free malloc pages to the OS now instead of when the scavenger gets to them.
+	WTF::releaseFastMallocFreeMemory();
+}
+
+void wk_print_malloc_stats() {
+	WTF::fastMallocDumpStatistics();
+}
+
+void wk_print_style_stats() {
+	WebCore::StyleResolver::statistics().dump();
+	WebCore::StyleSheetContentsCache::singleton().dumpStats();
+}
+
+void wk_set_glyph_cache_max(const unsigned bytes) {
+	WebCore::CairoGlyphCache::singleton().setMaximumSize(bytes);
+}
+
+void wk_print_glyph_cache_stats() {
+	WebCore::CairoGlyphCache::singleton().dumpStats();
+}
+
+void wk_print_style_memory() {
+	for (WebCore::Document *doc: WebCore::Document::allDocuments())
+		WebCore::StyleDataInterner::dumpMemoryReport(*doc);
 }
 
 char *wk_urlencode(const char *in) {
@@ -74,6 +74,29 @@ void wk_set_bgtab_func(void (*func)(const char*));
 // Drop RAM caches
 void wk_drop_caches();
 
+// Print malloc statistics: reserved, committed, live and free memory per chunk type and
+// size class. Call after wk_drop_caches to tell leaks from fragmentation.
+void wk_print_malloc_stats();
+
+// Release memory when the available memory falls below these percentages of the
+// cgroup limit or of total RAM, default 15 and 5
+void wk_set_memory_pressure_thresholds(const unsigned noncritical_percent,
+					const unsigned critical_percent);
+
+// Print style resolution statistics (style sharing, matched rules cache, selector matching,
+// parsed stylesheet cache)
+void wk_print_style_stats();
+
+// Print the style memory of each document (shared vs unshared style structure bytes)
+void wk_print_style_memory();
+
+// Cache rendered glyph masks for text drawn into image surfaces, up to this many
+// bytes. Default 0, off; X windows never use it.
+void wk_set_glyph_cache_max(const unsigned bytes);
+
+// Print the glyph mask cache size, limit, hits and misses
+void wk_print_glyph_cache_stats();
+
 // Set streaming program and args, default none
 void wk_set_streaming_prog(const char *);
 
@@ -36,6 +36,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <BackForwardController.h>
 #include <ContextMenuController.h>
+#include <DisplayListRecorder.h>
+#include <DisplayListReplayer.h>
 #include <Editor.h>
 #include <EventListener.h>
 #include <FocusController.h>
@@ -87,6 +89,8 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	priv->error = NULL;
 	priv->resourceStateChanged = NULL;
 	priv->quietdiags = false;
+	priv->displaylist = NULL;
+	priv->displaylistvalid = false;
 
 	Fl_Widget *wid = this;
 
@@ -119,6 +123,7 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	clients.loaderClientForMainFrame = new FlFrameLoaderClient(this, (Frame*) 1);
 	clients.progressTrackerClient = new FlProgressTrackerClient(this);
 
+	priv->compositor = new FlCompositor(this);
 	priv->page = new Page(clients);
 	priv->page->addLayoutMilestones(DidFirstVisuallyNonEmptyLayout);
 
@@ -145,6 +150,7 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	Settings &set = priv->page->mainFrame().settings();
 	set.setLoadsImagesAutomatically(true);
 	set.setShrinksStandaloneImagesToFit(true);
+	set.setImageSubsamplingEnabled(true);
 	set.setScriptEnabled(true);
 	set.setDNSPrefetchingEnabled(true);
 	set.setMinimumDOMTimerInterval(0.016);
@@ -153,6 +159,7 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	set.setDefaultFontSize(16);
 	set.setDefaultFixedFontSize(16);
 	set.setDownloadableBinaryFontsEnabled(false);
+	// The software compositor is opt-in, see WK_SETTING_ACCELERATED_COMPOSITING
 	set.setAcceleratedCompositingEnabled(false);
 
 	priv->page->focusController().setActive(true);
@@ -175,6 +182,8 @@ webview::~webview() {
 		delete priv->gc;
 
 	delete priv->page;
+	delete priv->compositor;
+	delete priv->displaylist;
 	delete priv;
 }
 
@@ -223,6 +232,45 @@ void webview::draw() {
 	priv->lastdraw = now;
 }
 
+// Paint the main frame by replaying a recording of its contents. The recording
+// reaches a screen above and below the view, so a scroll within that area or a
+// repaint of part of the view only replays the items that touch the damage.
+static void drawDisplayList(privatewebview *priv, FrameView *view, const IntRect &clip) {
+
+	const IntRect visible = view->visibleContentRect();
+	IntRect dirty = clip;
+	dirty.intersect(IntRect(IntPoint(), visible.size()));
+	dirty.moveBy(view->scrollPosition());
+
+	if (!priv->displaylistvalid || !priv->displaylistrect.contains(dirty)) {
+		IntRect area = visible;
+		area.inflateY(visible.height());
+		area.intersect(IntRect(IntPoint(), view->contentsSize()));
+		area.unite(dirty);
+
+		priv->displaylist->clear();
+		{
+			DisplayList::Recorder recorder(*priv->displaylist, area);
+			view->paintContents(&recorder.context(), area);
+		}
+		priv->displaylistrect = area;
+		priv->displaylistvalid = true;
+	}
+
+	if (!dirty.isEmpty()) {
+		GraphicsContextStateSaver saver(*priv->gc);
+		priv->gc->translate(-view->scrollX(), -view->scrollY());
+		priv->gc->clip(dirty);
+		DisplayList::Replayer replayer(*priv->gc, *priv->displaylist);
+		replayer.replay(dirty);
+	}
+
+	// The scrollbars are not part of the contents and are drawn by FLTK.
+	GraphicsContextStateSaver saver(*priv->gc);
+	priv->gc->clip(IntRect(IntPoint(), view->unobscuredContentRectIncludingScrollbars().size()));
+	view->paintScrollbars(priv->gc, clip);
+}
+
 void webview::drawWeb() {
 
 	Frame *f = &priv->page->mainFrame();
@@ -232,8 +280,14 @@ void webview::drawWeb() {
 	f->view()->updateLayoutAndStyleIfNeededRecursive();
 
 	priv->gc->applyDeviceScaleFactor(f->page()->deviceScaleFactor());
-	f->view()->paint(priv->gc, IntRect(priv->clipx, priv->clipy,
-						priv->clipw, priv->cliph));
+
+	const IntRect clip(priv->clipx, priv->clipy, priv->clipw, priv->cliph);
+	if (priv->compositor->enabled())
+		priv->compositor->composite(priv->gc, clip);
+	else if (priv->displaylist)
+		drawDisplayList(priv, f->view(), clip);
+	else
+		f->view()->paint(priv->gc, clip);
 	priv->page->inspectorController().drawHighlight(*priv->gc);
 }
 
@@ -305,8 +359,10 @@ void webview::resize() {
 			delete priv->gc;
 		priv->gc = new GraphicsContext(priv->cairo);
 
-		if (old)
+		if (old) {
 			priv->page->mainFrame().view()->resize(priv->w, priv->h);
+			priv->compositor->resizeRootLayer(IntSize(priv->w, priv->h));
+		}
 
 		return;
 	}
@@ -326,9 +382,13 @@ void webview::resize() {
 	if (priv->gc)
 		delete priv->gc;
 	priv->gc = new GraphicsContext(priv->cairo);
+	// We get repainted when an image finishes decoding.
+	priv->gc->setDecodesImagesAsynchronously(true);
 
-	if (old)
+	if (old) {
 		priv->page->mainFrame().view()->resize(priv->w, priv->h);
+		priv->compositor->resizeRootLayer(IntSize(priv->w, priv->h));
+	}
 }
 
 static bool keyscroll(Frame &f, const unsigned key, const bool shift) {
@@ -995,7 +1055,12 @@ void webview::snapshot(const char *where) {
 	GraphicsContext *gc = new GraphicsContext(cc);
 
 	f->view()->updateLayoutAndStyleIfNeededRecursive();
+
+	// Composited layers are not in the view's own paint, flatten them in
+	const PaintBehavior oldbehavior = f->view()->paintBehavior();
+	f->view()->setPaintBehavior(oldbehavior | PaintBehaviorFlattenCompositingLayers);
 	f->view()->paint(gc, IntRect(0, 0, cw, ch));
+	f->view()->setPaintBehavior(oldbehavior);
 
 	const cairo_status_t ret = cairo_surface_write_to_png(surf, where);
 	cairo_destroy(cc);
@@ -1020,6 +1085,29 @@ char *webview::focusedSource() const {
 	return strdup(src.utf8().data());
 }
 
+char *webview::paintOperations() const {
+
+	Frame * const f = &priv->page->mainFrame();
+	if (!f->contentRenderer() || !f->view())
+		return NULL;
+
+	f->view()->updateLayoutAndStyleIfNeededRecursive();
+
+	const IntRect rect(0, 0, w(), h());
+	const PaintBehavior oldbehavior = f->view()->paintBehavior();
+	f->view()->setPaintBehavior(oldbehavior | PaintBehaviorFlattenCompositingLayers);
+
+	DisplayList::DisplayList list;
+	{
+		DisplayList::Recorder recorder(list, rect);
+		f->view()->paint(&recorder.context(), rect);
+	}
+
+	f->view()->setPaintBehavior(oldbehavior);
+
+	return strdup(list.description().utf8().data());
+}
+
 void webview::executeJS(const char *str) {
 
 	if (!str)
@@ -1054,6 +1142,19 @@ void webview::setBool(const SettingBool item, const bool val) {
 		case WK_SETTING_QUIET_JS_DIALOGS:
 			priv->quietdiags = val;
 		break;
+		case WK_SETTING_ACCELERATED_COMPOSITING:
+			set.setAcceleratedCompositingEnabled(val);
+		break;
+		case WK_SETTING_DISPLAY_LISTS:
+			if (val && !priv->displaylist)
+				priv->displaylist = new DisplayList::DisplayList;
+			else if (!val) {
+				delete priv->displaylist;
+				priv->displaylist = NULL;
+			}
+			priv->displaylistvalid = false;
+			redraw();
+		break;
 	}
 }
 
@@ -1077,6 +1178,12 @@ bool webview::getBool(const SettingBool item) const {
 		case WK_SETTING_QUIET_JS_DIALOGS:
 			return priv->quietdiags;
 		break;
+		case WK_SETTING_ACCELERATED_COMPOSITING:
+			return set.acceleratedCompositingEnabled();
+		break;
+		case WK_SETTING_DISPLAY_LISTS:
+			return priv->displaylist != NULL;
+		break;
 	}
 
 	fprintf(stderr, "Error, tried to fetch unknown bool setting %u\n",
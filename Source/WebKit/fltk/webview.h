@@ -28,6 +28,8 @@ enum SettingBool {
 	WK_SETTING_IMG,
 	WK_SETTING_LOCALSTORAGE,
 	WK_SETTING_QUIET_JS_DIALOGS,
+	WK_SETTING_ACCELERATED_COMPOSITING,
+	WK_SETTING_DISPLAY_LISTS,
 };
 
 enum SettingDouble {
@@ -80,6 +82,9 @@ public:
 	// Return the malloced source code of the focused frame
 	char *focusedSource() const;
 
+	// Return a malloced listing of the paint operations for the visible area
+	char *paintOperations() const;
+
 	void executeJS(const char *);
 
 	// Download handling
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define webviewpriv_h
 
 #include "chromeclient.h"
+#include "compositor.h"
 #include "contextclient.h"
 #include "download.h"
 #include "dragclient.h"
@@ -27,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "frameclient.h"
 #include "progressclient.h"
 
+#include <DisplayList.h>
 #include <EventHandler.h>
 #include <GraphicsContext.h>
 #include <Page.h>
@@ -47,6 +49,15 @@ public:
 	WebCore::GraphicsContext *gc;
 	Pixmap cairopix;
 
+	FlCompositor *compositor;
+
+	// Recorded page contents, replayed on draw when display lists are on.
+	// It covers displaylistrect in contents coordinates and is dropped when
+	// the contents change.
+	WebCore::DisplayList::DisplayList *displaylist;
+	WebCore::IntRect displaylistrect;
+	bool displaylistvalid;
+
 	Fl_Window *window;
 	unsigned depth;
 	unsigned w, h;
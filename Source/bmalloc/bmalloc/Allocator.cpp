@@ -192,6 +192,17 @@ void Allocator::scavenge()
     }
 }
 
+void Allocator::addStatistics(ThreadStatistics& statistics)
+{
+    for (unsigned short i = alignment; i <= mediumMax; i += alignment) {
+        BumpAllocator& allocator = m_bumpAllocators[sizeClass(i)];
+        statistics.bumpRangeBytes += allocator.remaining() * i;
+
+        for (auto& bumpRange : m_bumpRangeCaches[sizeClass(i)])
+            statistics.bumpRangeBytes += bumpRange.objectCount * i;
+    }
+}
+
 NO_INLINE BumpRange Allocator::allocateBumpRangeSlowCase(size_t sizeClass)
 {
     BumpRangeCache& bumpRangeCache = m_bumpRangeCaches[sizeClass];
@@ -27,6 +27,7 @@
 #define Allocator_h
 
 #include "BumpAllocator.h"
+#include "Statistics.h"
 #include <array>
 
 namespace bmalloc {
@@ -48,6 +49,8 @@ public:
 
     void scavenge();
 
+    void addStatistics(ThreadStatistics&);
+
 private:
     bool allocateFastCase(size_t, void*&);
     void* allocateSlowCase(size_t);
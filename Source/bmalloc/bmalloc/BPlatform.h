@@ -43,4 +43,8 @@
 #define BOS_DARWIN 1
 #endif
 
+#ifdef __linux__
+#define BOS_LINUX 1
+#endif
+
 #endif // BPlatform_h
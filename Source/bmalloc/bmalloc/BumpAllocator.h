@@ -40,6 +40,7 @@ public:
     void init(size_t);
     
     size_t size() { return m_size; }
+    size_t remaining() { return m_remaining; }
     
     bool isNull() { return !m_ptr; }
     void clear();
@@ -50,6 +50,18 @@ void Cache::scavenge()
     cache->deallocator().scavenge();
 }
 
+ThreadStatistics Cache::statistics()
+{
+    ThreadStatistics statistics = { 0, 0 };
+    Cache* cache = PerThread<Cache>::getFastCase();
+    if (!cache)
+        return statistics;
+
+    cache->allocator().addStatistics(statistics);
+    cache->deallocator().addStatistics(statistics);
+    return statistics;
+}
+
 Cache::Cache()
     : m_deallocator(PerProcess<Heap>::get())
     , m_allocator(PerProcess<Heap>::get(), m_deallocator)
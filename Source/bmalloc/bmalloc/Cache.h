@@ -46,6 +46,7 @@ public:
     static void* reallocate(void*, size_t);
 
     static void scavenge();
+    static ThreadStatistics statistics();
 
     Cache();
 
@@ -27,6 +27,7 @@
 #define Chunk_h
 
 #include "ObjectType.h"
+#include "Range.h"
 #include "Sizes.h"
 #include "VMAllocate.h"
 
@@ -51,15 +52,25 @@ public:
     Line* lines() { return m_lines; }
     Page* pages() { return m_pages; }
 
+    // The VMHeap returns memory to the OS one huge page at a time when huge pages
+    // are enabled, once every page in the huge page is free.
+    size_t hugePageIndex(Page* page) { return (page - m_pages) * vmPageSize / vmHugePageSize; }
+    Range hugePage(size_t index);
+    size_t hugePagePageCount(size_t index) { return hugePage(index).size() / vmPageSize; }
+    unsigned short& freePageCount(size_t index) { return m_freePageCounts[index]; }
+
 private:
     static_assert(!(vmPageSize % lineSize), "vmPageSize must be an even multiple of line size");
     static_assert(!(chunkSize % lineSize), "chunk size must be an even multiple of line size");
+    static_assert(!(chunkSize % vmHugePageSize), "chunk size must be an even multiple of huge page size");
 
     static const size_t lineCount = chunkSize / lineSize;
     static const size_t pageCount = chunkSize / vmPageSize;
+    static const size_t hugePageCount = chunkSize / vmHugePageSize;
 
     Line m_lines[lineCount];
     Page m_pages[pageCount];
+    unsigned short m_freePageCounts[hugePageCount];
 
     // Align to vmPageSize to avoid sharing physical pages with metadata.
     // Otherwise, we'll confuse the scavenger into trying to scavenge metadata.
@@ -81,6 +92,15 @@ inline auto Chunk<Traits>::get(void* object) -> Chunk*
     return static_cast<Chunk*>(mask(object, chunkMask));
 }
 
+template<class Traits>
+inline Range Chunk<Traits>::hugePage(size_t index)
+{
+    // The first huge page also holds our metadata, which is never scavenged.
+    char* begin = std::max<char*>(reinterpret_cast<char*>(this) + index * vmHugePageSize, m_memory);
+    char* end = reinterpret_cast<char*>(this) + (index + 1) * vmHugePageSize;
+    return Range(begin, end - begin);
+}
+
 }; // namespace bmalloc
 
 #endif // Chunk
@@ -27,6 +27,7 @@
 #define Deallocator_h
 
 #include "FixedVector.h"
+#include "Statistics.h"
 
 namespace bmalloc {
 
@@ -41,6 +42,8 @@ public:
 
     void deallocate(void*);
     void scavenge();
+
+    void addStatistics(ThreadStatistics& statistics) { statistics.deallocatorLogCount += m_objectLog.size(); }
     
 private:
     bool deallocateFastCase(void*);
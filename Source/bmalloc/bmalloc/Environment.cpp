@@ -89,6 +89,7 @@ static bool isASanEnabled()
 
 Environment::Environment()
     : m_isBmallocEnabled(computeIsBmallocEnabled())
+    , m_isHugePagesEnabled(computeIsHugePagesEnabled())
 {
 }
 
@@ -103,4 +104,14 @@ bool Environment::computeIsBmallocEnabled()
     return true;
 }
 
+bool Environment::computeIsHugePagesEnabled()
+{
+#if BOS(LINUX)
+    const char* variable = getenv("BMALLOC_HUGE_PAGES");
+    return variable && !strcmp(variable, "1");
+#else
+    return false;
+#endif
+}
+
 } // namespace bmalloc
@@ -33,11 +33,14 @@ public:
     Environment();
     
     bool isBmallocEnabled() { return m_isBmallocEnabled; }
+    bool isHugePagesEnabled() { return m_isHugePagesEnabled; }
 
 private:
     bool computeIsBmallocEnabled();
+    bool computeIsHugePagesEnabled();
 
     bool m_isBmallocEnabled;
+    bool m_isHugePagesEnabled;
 };
 
 } // namespace bmalloc
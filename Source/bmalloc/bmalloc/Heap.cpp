@@ -31,6 +31,7 @@
 #include "Page.h"
 #include "PerProcess.h"
 #include "SmallChunk.h"
+#include "SuperChunk.h"
 #include <thread>
 
 namespace bmalloc {
@@ -38,6 +39,7 @@ namespace bmalloc {
 Heap::Heap(std::lock_guard<StaticMutex>&)
     : m_largeObjects(Owner::Heap)
     , m_isAllocatingPages(false)
+    , m_vmHeap(m_environment)
     , m_scavenger(*this, &Heap::concurrentScavenge)
 {
     initializeLineMetadata();
@@ -81,44 +83,136 @@ void Heap::initializeLineMetadata()
 void Heap::concurrentScavenge()
 {
     std::unique_lock<StaticMutex> lock(PerProcess<Heap>::mutex());
-    scavenge(lock, scavengeSleepDuration);
-}
 
-void Heap::scavenge(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
-{
-    waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
+    // Keep making passes while there is free memory left, so memory that stops
+    // being in demand is returned without waiting for another free.
+    for (;;) {
+        sleep(lock, scavengeSleepDuration);
+        waitUntilFalse(lock, scavengeSleepDuration, m_isAllocatingPages);
+        ++m_scavengePassCount;
+
+        scavengeSmallPages(lock, m_smallScavengeState.updateDemand() / vmPageSize, scavengeSleepDuration);
+        scavengeMediumPages(lock, m_mediumScavengeState.updateDemand() / vmPageSize, scavengeSleepDuration);
+
+        // Free large objects can't be partially kept without splitting them, so
+        // they all stay until their demand has decayed.
+        bool hasLargeObjects = m_largeScavengeState.updateDemand() >= largeMin
+            || !scavengeLargeObjects(lock, scavengeSleepDuration);
 
-    scavengeSmallPages(lock, sleepDuration);
-    scavengeMediumPages(lock, sleepDuration);
-    scavengeLargeObjects(lock, sleepDuration);
+        if (!m_smallPages.size() && !m_mediumPages.size() && !hasLargeObjects)
+            return;
+    }
+}
 
-    sleep(lock, sleepDuration);
+void Heap::scavenge(std::unique_lock<StaticMutex>& lock)
+{
+    scavengeSmallPages(lock, 0, std::chrono::milliseconds(0));
+    scavengeMediumPages(lock, 0, std::chrono::milliseconds(0));
+    scavengeLargeObjects(lock, std::chrono::milliseconds(0));
 }
 
-void Heap::scavengeSmallPages(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
+void Heap::scavengeSmallPages(std::unique_lock<StaticMutex>& lock, size_t keepCount, std::chrono::milliseconds sleepDuration)
 {
-    while (m_smallPages.size()) {
+    size_t bytes = 0;
+    while (m_smallPages.size() > keepCount) {
+        if (sleepDuration != std::chrono::milliseconds(0) && bytes >= scavengeBytesPerPass)
+            return;
         m_vmHeap.deallocateSmallPage(lock, m_smallPages.pop());
+        m_smallScavengeState.scavengedBytes += vmPageSize;
+        bytes += vmPageSize;
         waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
     }
 }
 
-void Heap::scavengeMediumPages(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
+void Heap::scavengeMediumPages(std::unique_lock<StaticMutex>& lock, size_t keepCount, std::chrono::milliseconds sleepDuration)
 {
-    while (m_mediumPages.size()) {
+    size_t bytes = 0;
+    while (m_mediumPages.size() > keepCount) {
+        if (sleepDuration != std::chrono::milliseconds(0) && bytes >= scavengeBytesPerPass)
+            return;
         m_vmHeap.deallocateMediumPage(lock, m_mediumPages.pop());
+        m_mediumScavengeState.scavengedBytes += vmPageSize;
+        bytes += vmPageSize;
         waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
     }
 }
 
-void Heap::scavengeLargeObjects(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
+bool Heap::scavengeLargeObjects(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
 {
-    while (LargeObject largeObject = m_largeObjects.takeGreedy()) {
+    size_t bytes = 0;
+    for (;;) {
+        if (sleepDuration != std::chrono::milliseconds(0) && bytes >= scavengeBytesPerPass)
+            return false;
+        LargeObject largeObject = m_largeObjects.takeGreedy();
+        if (!largeObject)
+            return true;
+        m_largeScavengeState.scavengedBytes += largeObject.size();
+        bytes += largeObject.size();
         m_vmHeap.deallocateLargeObject(lock, largeObject);
         waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
     }
 }
 
+template<typename Chunk>
+void Heap::addPageStatistics(std::lock_guard<StaticMutex>& lock, Chunk* chunk, ChunkStatistics& chunkStatistics, HeapStatistics& statistics)
+{
+    for (auto* page = chunk->begin(); page != chunk->end(); ++page) {
+        if (!page->refCount(lock))
+            continue;
+
+        SizeClassStatistics& sizeClassStatistics = statistics.sizeClasses[page->sizeClass()];
+        size_t size = objectSize(page->sizeClass());
+        ++sizeClassStatistics.pageCount;
+        for (auto* line = page->begin(); line != page->end(); ++line) {
+            size_t objectCount = line->refCount(lock);
+            if (!objectCount) {
+                chunkStatistics.freeBytes += Chunk::lineSize;
+                continue;
+            }
+            ++sizeClassStatistics.lineCount;
+            sizeClassStatistics.objectCount += objectCount;
+            chunkStatistics.objectBytes += objectCount * size;
+        }
+    }
+}
+
+void Heap::addScavengeStatistics(const ScavengeState& state, ChunkStatistics& statistics)
+{
+    statistics.reusedBytes = state.reusedBytes;
+    statistics.vmAllocatedBytes = state.vmAllocatedBytes;
+    statistics.scavengedBytes = state.scavengedBytes;
+    statistics.demandBytes = std::max(state.demand, state.intervalBytes);
+}
+
+HeapStatistics Heap::statistics(std::lock_guard<StaticMutex>& lock)
+{
+    HeapStatistics statistics;
+    m_vmHeap.addStatistics(statistics);
+
+    for (auto* superChunk : m_vmHeap.superChunks()) {
+        addPageStatistics(lock, superChunk->smallChunk(), statistics.small, statistics);
+        addPageStatistics(lock, superChunk->mediumChunk(), statistics.medium, statistics);
+    }
+
+    addScavengeStatistics(m_smallScavengeState, statistics.small);
+    addScavengeStatistics(m_mediumScavengeState, statistics.medium);
+    addScavengeStatistics(m_largeScavengeState, statistics.large);
+    statistics.scavengePassCount = m_scavengePassCount;
+
+    statistics.small.freeBytes += m_smallPages.size() * vmPageSize;
+    statistics.small.pendingDecommitBytes += m_smallPages.size() * vmPageSize;
+    statistics.medium.freeBytes += m_mediumPages.size() * vmPageSize;
+    statistics.medium.pendingDecommitBytes += m_mediumPages.size() * vmPageSize;
+
+    for (auto& range : m_xLargeObjects) {
+        statistics.xLarge.reservedBytes += range.size();
+        statistics.xLarge.committedBytes += range.size();
+        statistics.xLarge.objectBytes += range.size();
+    }
+
+    return statistics;
+}
+
 void Heap::refillSmallBumpRangeCache(std::lock_guard<StaticMutex>& lock, size_t sizeClass, BumpRangeCache& rangeCache)
 {
     BASSERT(!rangeCache.size());
@@ -203,10 +297,13 @@ SmallPage* Heap::allocateSmallPage(std::lock_guard<StaticMutex>& lock, size_t si
         return page;
     }
 
-    SmallPage* page = [this, sizeClass]() {
-        if (m_smallPages.size())
+    SmallPage* page = [this]() {
+        if (m_smallPages.size()) {
+            m_smallScavengeState.didReuse(vmPageSize);
             return m_smallPages.pop();
+        }
 
+        m_smallScavengeState.didAllocateFromVM(vmPageSize);
         m_isAllocatingPages = true;
         return m_vmHeap.allocateSmallPage();
     }();
@@ -225,10 +322,13 @@ MediumPage* Heap::allocateMediumPage(std::lock_guard<StaticMutex>& lock, size_t
         return page;
     }
 
-    MediumPage* page = [this, sizeClass]() {
-        if (m_mediumPages.size())
+    MediumPage* page = [this]() {
+        if (m_mediumPages.size()) {
+            m_mediumScavengeState.didReuse(vmPageSize);
             return m_mediumPages.pop();
+        }
 
+        m_mediumScavengeState.didAllocateFromVM(vmPageSize);
         m_isAllocatingPages = true;
         return m_vmHeap.allocateMediumPage();
     }();
@@ -349,9 +449,11 @@ void* Heap::allocateLarge(std::lock_guard<StaticMutex>& lock, size_t size)
     
     LargeObject largeObject = m_largeObjects.take(size);
     if (!largeObject) {
+        m_largeScavengeState.didAllocateFromVM(size);
         m_isAllocatingPages = true;
         largeObject = m_vmHeap.allocateLargeObject(size);
-    }
+    } else
+        m_largeScavengeState.didReuse(size);
 
     return allocateLarge(lock, largeObject, size);
 }
@@ -370,9 +472,11 @@ void* Heap::allocateLarge(std::lock_guard<StaticMutex>& lock, size_t alignment,
 
     LargeObject largeObject = m_largeObjects.take(alignment, size, unalignedSize);
     if (!largeObject) {
+        m_largeScavengeState.didAllocateFromVM(size);
         m_isAllocatingPages = true;
         largeObject = m_vmHeap.allocateLargeObject(alignment, size, unalignedSize);
-    }
+    } else
+        m_largeScavengeState.didReuse(size);
 
     size_t alignmentMask = alignment - 1;
     if (test(largeObject.begin(), alignmentMask)) {
@@ -37,6 +37,7 @@
 #include "SmallChunk.h"
 #include "SmallLine.h"
 #include "SmallPage.h"
+#include "Statistics.h"
 #include "VMHeap.h"
 #include "Vector.h"
 #include <array>
@@ -69,9 +70,29 @@ public:
     Range& findXLarge(std::unique_lock<StaticMutex>&, void*);
     void deallocateXLarge(std::unique_lock<StaticMutex>&, void*);
 
-    void scavenge(std::unique_lock<StaticMutex>&, std::chrono::milliseconds sleepDuration);
+    // Returns all free memory to the OS, regardless of recent demand.
+    void scavenge(std::unique_lock<StaticMutex>&);
+
+    HeapStatistics statistics(std::lock_guard<StaticMutex>&);
 
 private:
+    // How much free memory of one chunk type was recently handed out again. The
+    // concurrent scavenger keeps that much, so bursts of allocation don't fault
+    // in freshly scavenged pages, and returns the rest. Demand decays with every
+    // pass, faster when nothing was allocated, so an idle heap is returned within
+    // a few seconds.
+    struct ScavengeState {
+        void didReuse(size_t bytes) { reusedBytes += bytes; intervalBytes += bytes; }
+        void didAllocateFromVM(size_t bytes) { vmAllocatedBytes += bytes; intervalBytes += bytes; }
+        size_t updateDemand();
+
+        size_t intervalBytes { 0 };
+        size_t demand { 0 };
+        size_t reusedBytes { 0 };
+        size_t vmAllocatedBytes { 0 };
+        size_t scavengedBytes { 0 };
+    };
+
     ~Heap() = delete;
     
     void initializeLineMetadata();
@@ -91,9 +112,15 @@ private:
     void mergeLargeRight(EndTag*&, BeginTag*&, Range&, bool& inVMHeap);
     
     void concurrentScavenge();
-    void scavengeSmallPages(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
-    void scavengeMediumPages(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
-    void scavengeLargeObjects(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
+    // A non-zero sleep duration makes these back off while other threads allocate pages,
+    // and stop after scavengeBytesPerPass so the heap lock isn't held for long. Returns false
+    // if scavengeLargeObjects stopped with free large objects left.
+    void scavengeSmallPages(std::unique_lock<StaticMutex>&, size_t keepCount, std::chrono::milliseconds);
+    void scavengeMediumPages(std::unique_lock<StaticMutex>&, size_t keepCount, std::chrono::milliseconds);
+    bool scavengeLargeObjects(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
+
+    template<typename Chunk> void addPageStatistics(std::lock_guard<StaticMutex>&, Chunk*, ChunkStatistics&, HeapStatistics&);
+    static void addScavengeStatistics(const ScavengeState&, ChunkStatistics&);
 
     std::array<std::array<LineMetadata, SmallPage::lineCount>, smallMax / alignment> m_smallLineMetadata;
     std::array<std::array<LineMetadata, MediumPage::lineCount>, mediumMax / alignment> m_mediumLineMetadata;
@@ -109,12 +136,24 @@ private:
 
     bool m_isAllocatingPages;
 
+    ScavengeState m_smallScavengeState;
+    ScavengeState m_mediumScavengeState;
+    ScavengeState m_largeScavengeState;
+    size_t m_scavengePassCount { 0 };
+
     Environment m_environment;
 
     VMHeap m_vmHeap;
     AsyncTask<Heap, decltype(&Heap::concurrentScavenge)> m_scavenger;
 };
 
+inline size_t Heap::ScavengeState::updateDemand()
+{
+    demand = intervalBytes ? std::max(intervalBytes, demand / 2) : demand / 4;
+    intervalBytes = 0;
+    return demand;
+}
+
 inline void Heap::derefSmallLine(std::lock_guard<StaticMutex>& lock, SmallLine* line)
 {
     if (!line->deref(lock))
@@ -52,6 +52,8 @@ namespace Sizes {
     static const size_t vmPageSize = 4 * kB;
 #endif
     static const size_t vmPageMask = ~(vmPageSize - 1);
+
+    static const size_t vmHugePageSize = 2 * MB;
     
     static const size_t superChunkSize = 32 * MB;
 
@@ -95,6 +97,7 @@ namespace Sizes {
     static const size_t bumpRangeCacheCapacity = vmPageSize / smallLineSize / 2;
     
     static const std::chrono::milliseconds scavengeSleepDuration = std::chrono::milliseconds(512);
+    static const size_t scavengeBytesPerPass = 16 * MB;
 
     inline size_t sizeClass(size_t size)
     {
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 The WebKit-FLTK Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef Statistics_h
+#define Statistics_h
+
+#include "Sizes.h"
+#include <array>
+
+namespace bmalloc {
+
+// Snapshots of allocator state, computed on demand by walking heap metadata.
+// Nothing is counted on the allocation fast paths.
+
+struct SizeClassStatistics {
+    size_t pageCount;
+    size_t lineCount; // Lines holding at least one object.
+    size_t objectCount; // Live objects, plus objects sitting in a thread's bump ranges.
+};
+
+struct ChunkStatistics {
+    size_t reservedBytes;
+    size_t committedBytes;
+    size_t objectBytes; // Live, or cached by a thread's Allocator.
+    size_t freeBytes; // Committed, but owned by the Heap: free lines, pages and large objects.
+    size_t pendingDecommitBytes; // Free pages and large objects the scavenger will return to the OS.
+
+    // Cumulative scavenger counters.
+    size_t reusedBytes; // Handed out again from free pages and large objects.
+    size_t vmAllocatedBytes; // Handed out from the VM heap, faulting in memory.
+    size_t scavengedBytes; // Returned to the VM heap.
+    size_t demandBytes; // Recently reused; the scavenger keeps this much free memory.
+};
+
+struct HeapStatistics {
+    HeapStatistics()
+        : small()
+        , medium()
+        , large()
+        , xLarge()
+        , sizeClasses()
+        , scavengePassCount()
+    {
+    }
+
+    ChunkStatistics small;
+    ChunkStatistics medium;
+    ChunkStatistics large;
+    ChunkStatistics xLarge;
+    std::array<SizeClassStatistics, mediumMax / alignment> sizeClasses;
+    size_t scavengePassCount;
+
+    size_t reservedBytes() const { return small.reservedBytes + medium.reservedBytes + large.reservedBytes + xLarge.reservedBytes; }
+    size_t committedBytes() const { return small.committedBytes + medium.committedBytes + large.committedBytes + xLarge.committedBytes; }
+    size_t objectBytes() const { return small.objectBytes + medium.objectBytes + large.objectBytes + xLarge.objectBytes; }
+    size_t freeBytes() const { return small.freeBytes + medium.freeBytes + large.freeBytes; }
+    size_t pendingDecommitBytes() const { return small.pendingDecommitBytes + medium.pendingDecommitBytes + large.pendingDecommitBytes; }
+
+    // The share of committed memory that holds no object.
+    double fragmentation() const
+    {
+        size_t committed = committedBytes();
+        return committed ? static_cast<double>(committed - objectBytes()) / committed : 0;
+    }
+};
+
+struct ThreadStatistics {
+    size_t bumpRangeBytes; // Allocatable without taking the Heap lock.
+    size_t deallocatorLogCount; // Frees not yet returned to the Heap.
+};
+
+} // namespace bmalloc
+
+#endif // Statistics_h
@@ -31,6 +31,7 @@
 #include "Sizes.h"
 #include "Syscall.h"
 #include <algorithm>
+#include <atomic>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -138,6 +139,38 @@ inline void vmDeallocatePhysicalPages(void* p, size_t vmSize)
 #endif
 }
 
+// Like vmDeallocatePhysicalPages, but lets the kernel reclaim the pages only when
+// it needs them, which makes decommit and the next touch much cheaper.
+inline void vmDeallocatePhysicalPagesLazily(void* p, size_t vmSize)
+{
+#if BOS(LINUX) && defined(MADV_FREE)
+    // Kernels before 4.5 reject MADV_FREE with EINVAL.
+    static std::atomic<bool> isMadvFreeSupported(true);
+    if (isMadvFreeSupported.load(std::memory_order_relaxed)) {
+        vmValidate(p, vmSize);
+        int result;
+        while ((result = madvise(p, vmSize, MADV_FREE)) == -1 && errno == EAGAIN) { }
+        if (!result)
+            return;
+        isMadvFreeSupported.store(false, std::memory_order_relaxed);
+    }
+#endif
+    vmDeallocatePhysicalPages(p, vmSize);
+}
+
+// Asks the kernel to back a range with transparent huge pages. This is only a hint:
+// it fails silently when THP is disabled or unsupported.
+inline void vmAdviseHugePages(void* p, size_t vmSize)
+{
+    vmValidate(p, vmSize);
+#if BOS(LINUX) && defined(MADV_HUGEPAGE)
+    madvise(p, vmSize, MADV_HUGEPAGE);
+#else
+    UNUSED(p);
+    UNUSED(vmSize);
+#endif
+}
+
 inline void vmAllocatePhysicalPages(void* p, size_t vmSize)
 {
     vmValidate(p, vmSize);
@@ -160,6 +193,18 @@ inline void vmDeallocatePhysicalPagesSloppy(void* p, size_t size)
     vmDeallocatePhysicalPages(begin, end - begin);
 }
 
+// Trims requests that are un-page-aligned.
+inline void vmDeallocatePhysicalPagesLazilySloppy(void* p, size_t size)
+{
+    char* begin = roundUpToMultipleOf<vmPageSize>(static_cast<char*>(p));
+    char* end = roundDownToMultipleOf<vmPageSize>(static_cast<char*>(p) + size);
+
+    if (begin >= end)
+        return;
+
+    vmDeallocatePhysicalPagesLazily(begin, end - begin);
+}
+
 // Expands requests that are un-page-aligned. NOTE: Allocation must proceed left-to-right.
 inline void vmAllocatePhysicalPagesSloppy(void* p, size_t size)
 {
@@ -32,23 +32,40 @@
 
 namespace bmalloc {
 
-VMHeap::VMHeap()
-    : m_largeObjects(Owner::VMHeap)
+VMHeap::VMHeap(Environment& environment)
+    : m_isHugePagesEnabled(environment.isHugePagesEnabled())
+    , m_largeObjects(Owner::VMHeap)
 {
 }
 
+template<typename Chunk>
+void VMHeap::adviseHugePages(Chunk* chunk)
+{
+    if (!m_isHugePagesEnabled)
+        return;
+
+    vmAdviseHugePages(chunk, Chunk::chunkSize);
+
+    // All of a new chunk's pages start out in the VM heap.
+    for (size_t i = 0; i < Chunk::chunkSize / vmHugePageSize; ++i)
+        chunk->freePageCount(i) = chunk->hugePagePageCount(i);
+}
+
 void VMHeap::grow()
 {
     SuperChunk* superChunk = SuperChunk::create();
+    m_superChunks.push(superChunk);
 #if BOS(DARWIN)
     m_zone.addSuperChunk(superChunk);
 #endif
 
     SmallChunk* smallChunk = superChunk->smallChunk();
+    adviseHugePages(smallChunk);
     for (auto* it = smallChunk->begin(); it != smallChunk->end(); ++it)
         m_smallPages.push(it);
 
     MediumChunk* mediumChunk = superChunk->mediumChunk();
+    adviseHugePages(mediumChunk);
     for (auto* it = mediumChunk->begin(); it != mediumChunk->end(); ++it)
         m_mediumPages.push(it);
 
@@ -56,4 +73,58 @@ void VMHeap::grow()
     m_largeObjects.insert(LargeObject(LargeObject::init(largeChunk).begin()));
 }
 
+template<typename Chunk>
+size_t VMHeap::decommittedHugePageBytes(Chunk* chunk)
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < Chunk::chunkSize / vmHugePageSize; ++i) {
+        if (chunk->freePageCount(i) == chunk->hugePagePageCount(i))
+            bytes += chunk->hugePage(i).size();
+    }
+    return bytes;
+}
+
+void VMHeap::addStatistics(HeapStatistics& statistics)
+{
+    size_t superChunkCount = m_superChunks.size();
+    statistics.small.reservedBytes += superChunkCount * smallChunkSize;
+    statistics.medium.reservedBytes += superChunkCount * mediumChunkSize;
+    statistics.large.reservedBytes += superChunkCount * largeChunkSize;
+
+    // Without huge pages, every page in the VM heap has been returned to the OS.
+    size_t smallDecommittedBytes = m_smallPages.size() * vmPageSize;
+    size_t mediumDecommittedBytes = m_mediumPages.size() * vmPageSize;
+    if (m_isHugePagesEnabled) {
+        smallDecommittedBytes = 0;
+        mediumDecommittedBytes = 0;
+        for (auto* superChunk : m_superChunks) {
+            smallDecommittedBytes += decommittedHugePageBytes(superChunk->smallChunk());
+            mediumDecommittedBytes += decommittedHugePageBytes(superChunk->mediumChunk());
+        }
+    }
+
+    statistics.small.committedBytes += superChunkCount * smallChunkSize - smallDecommittedBytes;
+    statistics.small.freeBytes += m_smallPages.size() * vmPageSize - smallDecommittedBytes;
+    statistics.medium.committedBytes += superChunkCount * mediumChunkSize - mediumDecommittedBytes;
+    statistics.medium.freeBytes += m_mediumPages.size() * vmPageSize - mediumDecommittedBytes;
+
+    // Large objects tile their chunk, so we can walk them by size.
+    size_t largeDecommittedBytes = 0;
+    for (auto* superChunk : m_superChunks) {
+        LargeChunk* largeChunk = superChunk->largeChunk();
+        for (char* it = largeChunk->begin(); it != largeChunk->end(); ) {
+            LargeObject largeObject(LargeObject::DoNotValidate, it);
+            if (largeObject.owner() == Owner::VMHeap)
+                largeDecommittedBytes += largeObject.size();
+            else if (largeObject.isFree()) {
+                statistics.large.freeBytes += largeObject.size();
+                statistics.large.pendingDecommitBytes += largeObject.size();
+            } else
+                statistics.large.objectBytes += largeObject.size();
+            it = largeObject.end();
+        }
+    }
+    statistics.large.committedBytes += superChunkCount * largeChunkSize - largeDecommittedBytes;
+}
+
 } // namespace bmalloc
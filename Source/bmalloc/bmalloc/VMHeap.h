@@ -27,6 +27,7 @@
 #define VMHeap_h
 
 #include "AsyncTask.h"
+#include "Environment.h"
 #include "FixedVector.h"
 #include "LargeChunk.h"
 #include "LargeObject.h"
@@ -34,6 +35,7 @@
 #include "Range.h"
 #include "SegregatedFreeList.h"
 #include "SmallChunk.h"
+#include "Statistics.h"
 #include "Vector.h"
 #if BOS(DARWIN)
 #include "Zone.h"
@@ -48,7 +50,7 @@ class SuperChunk;
 
 class VMHeap {
 public:
-    VMHeap();
+    VMHeap(Environment&);
 
     SmallPage* allocateSmallPage();
     MediumPage* allocateMediumPage();
@@ -59,25 +61,75 @@ public:
     void deallocateMediumPage(std::unique_lock<StaticMutex>&, MediumPage*);
     void deallocateLargeObject(std::unique_lock<StaticMutex>&, LargeObject&);
 
+    Vector<SuperChunk*>& superChunks() { return m_superChunks; }
+
+    // Adds reserved and committed bytes of all chunk types, plus what the VM heap
+    // itself holds. Object and free line statistics are the Heap's business.
+    void addStatistics(HeapStatistics&);
+
 private:
     LargeObject allocateLargeObject(LargeObject&, size_t);
     void grow();
 
+    template<typename Page> void allocatePhysicalPages(Page*);
+    template<typename Page> void deallocatePhysicalPages(std::unique_lock<StaticMutex>&, Page*);
+    template<typename Chunk> void adviseHugePages(Chunk*);
+    template<typename Chunk> size_t decommittedHugePageBytes(Chunk*);
+
+    bool m_isHugePagesEnabled;
+
     Vector<SmallPage*> m_smallPages;
     Vector<MediumPage*> m_mediumPages;
     SegregatedFreeList m_largeObjects;
+    Vector<SuperChunk*> m_superChunks;
 #if BOS(DARWIN)
     Zone m_zone;
 #endif
 };
 
+template<typename Page>
+inline void VMHeap::allocatePhysicalPages(Page* page)
+{
+    if (!m_isHugePagesEnabled) {
+        vmAllocatePhysicalPages(page->begin()->begin(), vmPageSize);
+        return;
+    }
+
+    // Huge pages are only enabled on Linux, which recommits on first touch, so
+    // we just account for the page.
+    typename Page::Chunk* chunk = Page::Chunk::get(page);
+    --chunk->freePageCount(chunk->hugePageIndex(page));
+}
+
+template<typename Page>
+inline void VMHeap::deallocatePhysicalPages(std::unique_lock<StaticMutex>& lock, Page* page)
+{
+    if (!m_isHugePagesEnabled) {
+        lock.unlock();
+        vmDeallocatePhysicalPages(page->begin()->begin(), vmPageSize);
+        lock.lock();
+        return;
+    }
+
+    // Decommitting a single page would split the huge page backing it, so we wait
+    // until every page in the huge page is free. The lock stays held because the
+    // huge page's other pages are already available for allocation.
+    typename Page::Chunk* chunk = Page::Chunk::get(page);
+    size_t index = chunk->hugePageIndex(page);
+    if (++chunk->freePageCount(index) < chunk->hugePagePageCount(index))
+        return;
+
+    Range hugePage = chunk->hugePage(index);
+    vmDeallocatePhysicalPagesLazily(hugePage.begin(), hugePage.size());
+}
+
 inline SmallPage* VMHeap::allocateSmallPage()
 {
     if (!m_smallPages.size())
         grow();
 
     SmallPage* page = m_smallPages.pop();
-    vmAllocatePhysicalPages(page->begin()->begin(), vmPageSize);
+    allocatePhysicalPages(page);
     return page;
 }
 
@@ -87,7 +139,7 @@ inline MediumPage* VMHeap::allocateMediumPage()
         grow();
 
     MediumPage* page = m_mediumPages.pop();
-    vmAllocatePhysicalPages(page->begin()->begin(), vmPageSize);
+    allocatePhysicalPages(page);
     return page;
 }
 
@@ -135,19 +187,15 @@ inline LargeObject VMHeap::allocateLargeObject(size_t alignment, size_t size, si
 
 inline void VMHeap::deallocateSmallPage(std::unique_lock<StaticMutex>& lock, SmallPage* page)
 {
-    lock.unlock();
-    vmDeallocatePhysicalPages(page->begin()->begin(), vmPageSize);
-    lock.lock();
-    
+    deallocatePhysicalPages(lock, page);
+
     m_smallPages.push(page);
 }
 
 inline void VMHeap::deallocateMediumPage(std::unique_lock<StaticMutex>& lock, MediumPage* page)
 {
-    lock.unlock();
-    vmDeallocatePhysicalPages(page->begin()->begin(), vmPageSize);
-    lock.lock();
-    
+    deallocatePhysicalPages(lock, page);
+
     m_mediumPages.push(page);
 }
 
@@ -164,7 +212,10 @@ inline void VMHeap::deallocateLargeObject(std::unique_lock<StaticMutex>& lock, L
     merged.setFree(false);
 
     lock.unlock();
-    vmDeallocatePhysicalPagesSloppy(merged.begin(), merged.size());
+    if (m_isHugePagesEnabled)
+        vmDeallocatePhysicalPagesLazilySloppy(merged.begin(), merged.size());
+    else
+        vmDeallocatePhysicalPagesSloppy(merged.begin(), merged.size());
     lock.lock();
 
     merged.setFree(true);
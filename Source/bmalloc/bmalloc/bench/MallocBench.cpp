@@ -0,0 +1,424 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Allocation traces modeled on what the engine does, run through the mbmalloc
+// interface. Link with libbmalloc.a to measure bmalloc, or with SystemMalloc.cpp
+// to measure the system allocator. Each benchmark runs in its own process so
+// peak RSS is per benchmark.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+void* mbmalloc(size_t);
+void mbfree(void*, size_t);
+void* mbrealloc(void*, size_t, size_t);
+void mbscavenge();
+}
+
+namespace {
+
+// Deterministic, so both allocators see the same trace.
+class Random {
+public:
+    explicit Random(unsigned seed) : m_state(seed * 2654435761u + 1) { }
+
+    unsigned next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    size_t inRange(size_t min, size_t max) { return min + next() % (max - min + 1); }
+
+private:
+    unsigned m_state;
+};
+
+size_t residentKB(const char* key)
+{
+    FILE* file = fopen("/proc/self/status", "r");
+    if (!file)
+        return 0;
+
+    size_t keyLength = strlen(key);
+    char line[256];
+    size_t result = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (!strncmp(line, key, keyLength)) {
+            result = strtoul(line + keyLength, nullptr, 10);
+            break;
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+// Live bytes are tracked by the benchmarks themselves, so fragmentation can be
+// reported as resident memory per byte the program actually asked for.
+class Stats {
+public:
+    Stats()
+        : m_baselineKB(residentKB("VmRSS:"))
+    {
+    }
+
+    void allocated(size_t size)
+    {
+        size_t live = m_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t peak = m_peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !m_peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+        m_operations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void freed(size_t size)
+    {
+        m_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        m_operations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t operations() const { return m_operations; }
+    size_t peakLiveBytes() const { return m_peakLiveBytes; }
+    size_t baselineKB() const { return m_baselineKB; }
+
+private:
+    std::atomic<size_t> m_liveBytes { 0 };
+    std::atomic<size_t> m_peakLiveBytes { 0 };
+    std::atomic<size_t> m_operations { 0 };
+    size_t m_baselineKB;
+};
+
+void* allocate(Stats& stats, size_t size)
+{
+    void* result = mbmalloc(size);
+    memset(result, 0xa5, size < 64 ? size : 64); // Touch it, like a constructor would.
+    stats.allocated(size);
+    return result;
+}
+
+void deallocate(Stats& stats, void* p, size_t size)
+{
+    mbfree(p, size);
+    stats.freed(size);
+}
+
+// DOM churn: trees of variably sized nodes, with whole subtrees created and
+// destroyed as if by innerHTML and removeChild.
+
+struct Node {
+    Node* firstChild;
+    Node* nextSibling;
+    size_t size;
+};
+
+Node* createSubtree(Stats& stats, Random& random, unsigned depth)
+{
+    size_t size = random.inRange(sizeof(Node), 256);
+    Node* node = static_cast<Node*>(allocate(stats, size));
+    node->firstChild = nullptr;
+    node->nextSibling = nullptr;
+    node->size = size;
+
+    if (depth) {
+        unsigned childCount = random.inRange(0, 5);
+        for (unsigned i = 0; i < childCount; ++i) {
+            Node* child = createSubtree(stats, random, depth - 1);
+            child->nextSibling = node->firstChild;
+            node->firstChild = child;
+        }
+    }
+    return node;
+}
+
+void destroySubtree(Stats& stats, Node* node)
+{
+    while (node) {
+        destroySubtree(stats, node->firstChild);
+        Node* next = node->nextSibling;
+        deallocate(stats, node, node->size);
+        node = next;
+    }
+}
+
+void benchmarkDOMChurn(Stats& stats, unsigned scale)
+{
+    Random random(1);
+    std::vector<Node*> documents(64, nullptr);
+    for (unsigned i = 0; i < 20000 * scale; ++i) {
+        Node*& document = documents[random.inRange(0, documents.size() - 1)];
+        destroySubtree(stats, document);
+        document = createSubtree(stats, random, 5);
+    }
+    for (Node* document : documents)
+        destroySubtree(stats, document);
+}
+
+// String building: StringBuilder-style geometric growth through realloc, mixed
+// with many short-lived small strings and a few survivors.
+
+void benchmarkStringBuilding(Stats& stats, unsigned scale)
+{
+    Random random(2);
+    std::vector<std::pair<char*, size_t>> survivors;
+    for (unsigned i = 0; i < 100000 * scale; ++i) {
+        size_t capacity = 16;
+        char* buffer = static_cast<char*>(allocate(stats, capacity));
+        size_t length = 0;
+        size_t finalLength = random.inRange(8, random.next() % 16 ? 256 : 64 * 1024);
+        while (length < finalLength) {
+            size_t piece = random.inRange(1, 32);
+            if (length + piece > capacity) {
+                size_t newCapacity = capacity * 2;
+                buffer = static_cast<char*>(mbrealloc(buffer, capacity, newCapacity));
+                stats.freed(capacity);
+                stats.allocated(newCapacity);
+                capacity = newCapacity;
+            }
+            memset(buffer + length, 'x', std::min(piece, capacity - length));
+            length += piece;
+        }
+
+        if (!(random.next() % 32)) {
+            survivors.push_back(std::make_pair(buffer, capacity));
+            continue;
+        }
+        deallocate(stats, buffer, capacity);
+    }
+    for (auto& survivor : survivors)
+        deallocate(stats, survivor.first, survivor.second);
+}
+
+// JS objects: small cells, a quarter of them with out-of-line property storage,
+// where most die young and a few are promoted to a long-lived set.
+
+struct Object {
+    void* butterfly;
+    size_t butterflySize;
+    size_t size;
+};
+
+void destroyObject(Stats& stats, Object* object)
+{
+    if (object->butterfly)
+        deallocate(stats, object->butterfly, object->butterflySize);
+    deallocate(stats, object, object->size);
+}
+
+void benchmarkJSObjects(Stats& stats, unsigned scale)
+{
+    Random random(3);
+    std::vector<Object*> oldSpace;
+    std::vector<Object*> nursery;
+    for (unsigned i = 0; i < 3000000 * scale; ++i) {
+        size_t size = random.inRange(sizeof(Object), 64);
+        Object* object = static_cast<Object*>(allocate(stats, size));
+        object->size = size;
+        object->butterfly = nullptr;
+        object->butterflySize = 0;
+        if (!(random.next() % 4)) {
+            object->butterflySize = 8 << random.inRange(0, 6);
+            object->butterfly = allocate(stats, object->butterflySize);
+        }
+        nursery.push_back(object);
+
+        if (nursery.size() < 4096)
+            continue;
+
+        // A minor collection: about one in twenty survives.
+        for (Object* object : nursery) {
+            if (random.next() % 20)
+                destroyObject(stats, object);
+            else
+                oldSpace.push_back(object);
+        }
+        nursery.clear();
+
+        // An occasional full collection frees half of the old space.
+        if (oldSpace.size() > 100000) {
+            size_t kept = 0;
+            for (Object* object : oldSpace) {
+                if (random.next() % 2)
+                    destroyObject(stats, object);
+                else
+                    oldSpace[kept++] = object;
+            }
+            oldSpace.resize(kept);
+        }
+    }
+    for (Object* object : nursery)
+        destroyObject(stats, object);
+    for (Object* object : oldSpace)
+        destroyObject(stats, object);
+}
+
+// Producer/consumer: objects allocated on worker threads and freed on another,
+// like decoded data and messages handed to the main thread.
+
+void benchmarkProducerConsumer(Stats& stats, unsigned scale)
+{
+    static const unsigned producerCount = 4;
+    static const size_t maxQueueSize = 16384;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::pair<void*, size_t>> queue;
+    unsigned producersRunning = producerCount;
+
+    std::vector<std::thread> producers;
+    for (unsigned i = 0; i < producerCount; ++i) {
+        producers.push_back(std::thread([&, i] {
+            Random random(10 + i);
+            for (unsigned j = 0; j < 500000 * scale; ++j) {
+                size_t size = random.next() % 64 ? random.inRange(16, 512) : random.inRange(4096, 65536);
+                void* object = allocate(stats, size);
+
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&] { return queue.size() < maxQueueSize; });
+                queue.push_back(std::make_pair(object, size));
+                condition.notify_all();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            --producersRunning;
+            condition.notify_all();
+        }));
+    }
+
+    std::thread consumer([&] {
+        std::vector<std::pair<void*, size_t>> batch;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&] { return !queue.empty() || !producersRunning; });
+                if (queue.empty())
+                    return;
+                batch.assign(queue.begin(), queue.end());
+                queue.clear();
+                condition.notify_all();
+            }
+            for (auto& object : batch)
+                deallocate(stats, object.first, object.second);
+        }
+    });
+
+    for (auto& producer : producers)
+        producer.join();
+    consumer.join();
+}
+
+struct Benchmark {
+    const char* name;
+    void (*function)(Stats&, unsigned);
+};
+
+const Benchmark benchmarks[] = {
+    { "dom", benchmarkDOMChurn },
+    { "strings", benchmarkStringBuilding },
+    { "objects", benchmarkJSObjects },
+    { "producer-consumer", benchmarkProducerConsumer },
+};
+
+void run(const Benchmark& benchmark, unsigned scale)
+{
+    Stats stats;
+    auto start = std::chrono::steady_clock::now();
+    benchmark.function(stats, scale);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t peakKB = residentKB("VmHWM:");
+    size_t peakDeltaKB = peakKB > stats.baselineKB() ? peakKB - stats.baselineKB() : 0;
+    double fragmentation = stats.peakLiveBytes() ? peakDeltaKB * 1024.0 / stats.peakLiveBytes() : 0;
+
+    mbscavenge();
+    size_t afterKB = residentKB("VmRSS:");
+
+    printf("%-18s %9.3f %12.0f %10zu %10zu %10.2f %10zu\n", benchmark.name, seconds,
+        stats.operations() / seconds, peakKB, stats.peakLiveBytes() / 1024, fragmentation, afterKB);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned scale = 1;
+    std::vector<const Benchmark*> selected;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--scale") && i + 1 < argc) {
+            scale = std::max(1, atoi(argv[++i]));
+            continue;
+        }
+
+        const Benchmark* found = nullptr;
+        for (const Benchmark& benchmark : benchmarks) {
+            if (!strcmp(argv[i], benchmark.name))
+                found = &benchmark;
+        }
+        if (!found) {
+            fprintf(stderr, "Usage: %s [--scale N] [benchmark...]\nBenchmarks:", argv[0]);
+            for (const Benchmark& benchmark : benchmarks)
+                fprintf(stderr, " %s", benchmark.name);
+            fprintf(stderr, "\n");
+            return 1;
+        }
+        selected.push_back(found);
+    }
+    if (selected.empty()) {
+        for (const Benchmark& benchmark : benchmarks)
+            selected.push_back(&benchmark);
+    }
+
+    // Fragmentation is peak RSS growth over peak live bytes; 1.00 means no overhead.
+    printf("%-18s %9s %12s %10s %10s %10s %10s\n", "Benchmark", "Seconds", "Ops/s",
+        "Peak kB", "Live kB", "RSS/live", "After kB");
+    fflush(stdout);
+
+    int status = 0;
+    for (const Benchmark* benchmark : selected) {
+        pid_t pid = fork();
+        if (!pid) {
+            run(*benchmark, scale);
+            fflush(stdout);
+            _exit(0);
+        }
+
+        int childStatus;
+        if (pid < 0 || waitpid(pid, &childStatus, 0) < 0 || !WIFEXITED(childStatus) || WEXITSTATUS(childStatus)) {
+            fprintf(stderr, "%s failed\n", benchmark->name);
+            status = 1;
+        }
+    }
+    return status;
+}
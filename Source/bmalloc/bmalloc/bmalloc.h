@@ -70,7 +70,21 @@ inline void scavenge()
     scavengeThisThread();
 
     std::unique_lock<StaticMutex> lock(PerProcess<Heap>::mutex());
-    PerProcess<Heap>::get()->scavenge(lock, std::chrono::milliseconds(0));
+    PerProcess<Heap>::get()->scavenge(lock);
+}
+
+// Walks the heap metadata under the heap lock, so don't call this on hot paths.
+inline HeapStatistics heapStatistics()
+{
+    Heap* heap = PerProcess<Heap>::get(); // Creating the heap takes the heap lock.
+    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
+    return heap->statistics(lock);
+}
+
+// Memory cached by the calling thread, which heapStatistics() counts as objects.
+inline ThreadStatistics threadStatistics()
+{
+    return Cache::statistics();
 }
 
 } // namespace api